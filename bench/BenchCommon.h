@@ -0,0 +1,35 @@
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// returns the seconds elapsed since start
+inline double seconds(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// returns the meshes in assets/ the benchmarks run on when no files are given
+inline std::vector<std::string> defaultMeshPaths() {
+    return {"assets/bunny.obj",
+            "assets/gourd.obj",
+            "assets/mesh_obj/HatsuneMiku.obj.obj",
+            "assets/mesh_obj/elephant_asie_sketchfab.obj.obj"};
+}
+
+// reads the "[repetitions] [obj files...]" arguments, repetitions keeps its value unless the first
+// argument is a positive number, and paths falls back to the default meshes
+inline void parseMeshArguments(int argc, char** argv, int& repetitions, std::vector<std::string>& paths) {
+    for (int i = 1; i < argc; i++) {
+        if (i == 1 && atoi(argv[i]) > 0) repetitions = atoi(argv[i]);
+        else paths.push_back(argv[i]);
+    }
+
+    if (paths.empty()) paths = defaultMeshPaths();
+}
+
+#endif // BENCH_COMMON_H
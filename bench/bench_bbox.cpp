@@ -0,0 +1,116 @@
+#include <cstdio>
+#include <random>
+#include "BenchCommon.h"
+#include "BoundingBox.h"
+#include "Mesh.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+/**
+ * Measures the bounding box computations on the position buffer for each instruction set and
+ * compares them with the same computations done on the vertex array, then measures how the
+ * computations scale with the thread count.
+ * Usage: ./bench_bbox [repetitions] [points]
+ * The points are uniformly distributed in the unit cube, 4 million by default.
+ */
+
+// axis-aligned box computed on the vertex array
+void vertexAxisAlignedBox(const std::vector<Vertex>& vertices, BoundingBox& bbox) {
+    bbox = BoundingBox(vertices[0].position);
+    for (const Vertex& v : vertices) {
+        bbox.expandToInclude(v.position);
+    }
+}
+
+// principal axes and extents computed on the vertex array
+void vertexOrientedBox(const std::vector<Vertex>& vertices, BoundingBox& bbox) {
+    Eigen::Vector3d center = Eigen::Vector3d::Zero();
+    for (const Vertex& v : vertices) center += v.position;
+    center /= (double)vertices.size();
+
+    Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
+    for (const Vertex& v : vertices) {
+        Eigen::Vector3d p = v.position - center;
+        covariance += p * p.transpose();
+    }
+    covariance /= (double)vertices.size();
+
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigenSolver(covariance);
+    Eigen::Matrix3d axes = eigenSolver.eigenvectors();
+
+    Eigen::Vector3d minVals = Eigen::Vector3d::Constant(INFINITY);
+    Eigen::Vector3d maxVals = Eigen::Vector3d::Constant(-INFINITY);
+    for (const Vertex& v : vertices) {
+        Eigen::Vector3d p = axes.transpose() * (v.position - center);
+        minVals = minVals.cwiseMin(p);
+        maxVals = maxVals.cwiseMax(p);
+    }
+
+    bbox.orientedPoints = {center + axes.col(0) * minVals[0], center + axes.col(0) * maxVals[0]};
+}
+
+int main(int argc, char** argv) {
+    int repetitions = argc > 1 ? atoi(argv[1]) : 20;
+    size_t n = argc > 2 ? atol(argv[2]) : 4000000;
+    if (repetitions <= 0 || n == 0) {
+        fprintf(stderr, "Usage: ./bench_bbox [repetitions] [points]\n");
+        return 1;
+    }
+
+    std::mt19937_64 rng(1);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    Mesh mesh;
+    mesh.vertices.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        mesh.vertices[i].position = Eigen::Vector3d(uniform(rng), 0.5 * uniform(rng), 0.25 * uniform(rng));
+    }
+    mesh.updatePositionBuffer();
+
+    printf("%zu points, %d repetitions\n", n, repetitions);
+    printf("%-12s %14s %14s\n", "kernels", "AABB Mpts/s", "OBB Mpts/s");
+
+    BoundingBox bbox;
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < repetitions; r++) vertexAxisAlignedBox(mesh.vertices, bbox);
+    double aabbTime = seconds(start);
+
+    start = Clock::now();
+    for (int r = 0; r < repetitions; r++) vertexOrientedBox(mesh.vertices, bbox);
+    double obbTime = seconds(start);
+
+    double mpts = n * (double)repetitions / 1e6;
+    printf("%-12s %14.1f %14.1f\n", "vertices", mpts / aabbTime, mpts / obbTime);
+
+    for (const char* name : {"scalar", "sse2", "avx2"}) {
+        if (!SimdKernels::setInstructionSet(name)) continue;
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) bbox.computeAxisAlignedBox(mesh.positions, 1);
+        aabbTime = seconds(start);
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) bbox.computeOrientedBox(mesh.positions, 1);
+        obbTime = seconds(start);
+
+        printf("%-12s %14.1f %14.1f\n", name, mpts / aabbTime, mpts / obbTime);
+    }
+
+    printf("\n%-12s %14s %14s %10s\n", "threads", "AABB Mpts/s", "OBB Mpts/s", "speedup");
+    double baseTime = 0;
+    int maxThreads = ThreadPool::resolveThreadCount(0);
+    for (int threads = 1; ; threads = std::min(2 * threads, maxThreads)) {
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) bbox.computeAxisAlignedBox(mesh.positions, threads);
+        aabbTime = seconds(start);
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) bbox.computeOrientedBox(mesh.positions, threads);
+        obbTime = seconds(start);
+        if (threads == 1) baseTime = obbTime;
+
+        printf("%-12d %14.1f %14.1f %10.2f\n", threads, mpts / aabbTime, mpts / obbTime, baseTime / obbTime);
+        if (threads == maxThreads) break;
+    }
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <cstdio>
+#include <random>
+#include "BenchCommon.h"
+#include "BoxOverlap.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+/**
+ * Measures the batched oriented box overlap tests on random boxes: the all pairs test with each
+ * instruction set, and sweep and prune over one set.
+ * Usage: ./bench_box_overlap [repetitions] [boxes]
+ */
+
+// boxes with random orientation and size, centers in a cube of side 100
+OrientedBoxBuffer randomBoxes(size_t n, std::mt19937& rng) {
+    std::uniform_real_distribution<double> uniform(0, 1);
+    OrientedBoxBuffer boxes;
+    for (size_t i = 0; i < n; i++) {
+        Eigen::Quaterniond q(uniform(rng) - 0.5, uniform(rng) - 0.5, uniform(rng) - 0.5, uniform(rng) - 0.5);
+        Eigen::Vector3d center(100 * uniform(rng), 100 * uniform(rng), 100 * uniform(rng));
+        Eigen::Vector3d halfExtents(0.5 + 2 * uniform(rng), 0.5 + 2 * uniform(rng), 0.5 + 2 * uniform(rng));
+        boxes.push_back(OrientedBox(center, q.normalized().toRotationMatrix(), halfExtents));
+    }
+
+    return boxes;
+}
+
+int main(int argc, char** argv) {
+    int repetitions = argc > 1 && atoi(argv[1]) > 0 ? atoi(argv[1]) : 5;
+    size_t count = argc > 2 && atoi(argv[2]) > 0 ? atoi(argv[2]) : 2000;
+
+    std::mt19937 rng(1);
+    OrientedBoxBuffer a = randomBoxes(count, rng), b = randomBoxes(count, rng);
+    double pairs = (double)count * count * repetitions;
+
+    printf("%-24s %10s %14s %12s\n", "test", "threads", "Mpairs / s", "overlaps");
+    std::vector<std::pair<uint32_t, uint32_t>> found;
+    std::string active = SimdKernels::instructionSet();
+    for (const char* name : {"scalar", "sse2", "avx2"}) {
+        if (!SimdKernels::setInstructionSet(name)) continue;
+
+        for (int threads : {1, 0}) {
+            Clock::time_point start = Clock::now();
+            for (int r = 0; r < repetitions; r++) BoxOverlap::overlappingPairs(a, b, found, threads);
+            printf("%-24s %10d %14.2f %12zu\n", ("all pairs " + std::string(name)).c_str(),
+                   ThreadPool::resolveThreadCount(threads), pairs / seconds(start) / 1e6, found.size());
+        }
+    }
+    SimdKernels::setInstructionSet(active);
+
+    // sweep and prune over both sets together, compared with testing all pairs
+    OrientedBoxBuffer all = a;
+    for (size_t i = 0; i < b.size(); i++) all.push_back(b.get(i));
+    double allPairs = (double)all.size() * (all.size() - 1) / 2 * repetitions;
+
+    Clock::time_point start = Clock::now();
+    for (int r = 0; r < repetitions; r++) BoxOverlap::sweepAndPrune(all, found);
+    printf("%-24s %10d %14.2f %12zu\n", "sweep and prune", ThreadPool::resolveThreadCount(0),
+           allPairs / seconds(start) / 1e6, found.size());
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+#include <cstdio>
+#include <random>
+#include "BenchCommon.h"
+#include "BVH.h"
+#include "Mesh.h"
+
+/**
+ * Measures the BVH build and the batched queries. Camera rays come from a 512x512 pinhole camera
+ * looking at the mesh, random rays start on a sphere around the mesh and aim at random points
+ * inside it, and closest point queries start near the surface.
+ * Usage: ./bench_bvh [repetitions] [obj files...]
+ * Without files the meshes in assets/ are used.
+ */
+
+int main(int argc, char** argv) {
+    int repetitions = 5;
+    std::vector<std::string> paths;
+
+    parseMeshArguments(argc, argv, repetitions, paths);
+
+    const int resolution = 512;
+
+    printf("%-50s %10s %8s %10s %14s %14s %14s %14s\n", "file", "triangles", "nodes", "build ms", "camera Mray/s",
+           "1t Mray/s", "random Mray/s", "closest Mq/s");
+    for (const std::string& path : paths) {
+        Mesh mesh;
+        if (!mesh.read(path)) continue;
+
+        BVH bvh;
+        Clock::time_point start = Clock::now();
+        for (int r = 0; r < repetitions; r++) bvh.build(mesh);
+        double buildTime = seconds(start) / repetitions;
+
+        // the mesh is normalized to the unit sphere
+        PositionBuffer cameraOrigins, cameraDirections;
+        for (int y = 0; y < resolution; y++) {
+            for (int x = 0; x < resolution; x++) {
+                cameraOrigins.push_back(Eigen::Vector3d(0, 0, 3));
+                cameraDirections.push_back(Eigen::Vector3d((x + 0.5) / resolution * 2 - 1,
+                                                           (y + 0.5) / resolution * 2 - 1, -3));
+            }
+        }
+
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<double> uniform(-1, 1);
+        PositionBuffer randomOrigins, randomDirections, queries;
+        for (size_t i = 0; i < cameraOrigins.size(); i++) {
+            Eigen::Vector3d origin = Eigen::Vector3d(uniform(rng), uniform(rng), uniform(rng)).normalized() * 2;
+            Eigen::Vector3d target = Eigen::Vector3d(uniform(rng), uniform(rng), uniform(rng)) * 0.5;
+            randomOrigins.push_back(origin);
+            randomDirections.push_back(target - origin);
+
+            Eigen::Vector3d jitter = Eigen::Vector3d(uniform(rng), uniform(rng), uniform(rng)) * 0.05;
+            queries.push_back(mesh.positions.get(rng() % mesh.positions.size()) + jitter);
+        }
+
+        std::vector<RayHit> hits;
+        std::vector<ClosestPoint> closest;
+        double rays = (double)cameraOrigins.size() * repetitions;
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) bvh.raycast(cameraOrigins, cameraDirections, hits);
+        double cameraTime = seconds(start);
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) bvh.raycast(cameraOrigins, cameraDirections, hits, 1);
+        double serialTime = seconds(start);
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) bvh.raycast(randomOrigins, randomDirections, hits);
+        double randomTime = seconds(start);
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) bvh.closestPoints(queries, closest);
+        double closestTime = seconds(start);
+
+        printf("%-50s %10zu %8zu %10.2f %14.2f %14.2f %14.2f %14.2f\n", path.c_str(), bvh.triangleCount(),
+               bvh.nodeCount(), 1000 * buildTime, rays / cameraTime / 1e6, rays / serialTime / 1e6,
+               rays / randomTime / 1e6, rays / closestTime / 1e6);
+    }
+
+    return 0;
+}
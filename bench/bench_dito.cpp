@@ -0,0 +1,41 @@
+#include <cstdio>
+#include "BenchCommon.h"
+#include "BoundingBox.h"
+#include "Mesh.h"
+
+/**
+ * Compares the DiTO oriented box fitters with PCA on one thread, the setting of a runtime that fits
+ * many small meshes per frame, by time per box and by box volume relative to the PCA box.
+ * Usage: ./bench_dito [repetitions] [obj files...]
+ * Without files the meshes in assets/ are used.
+ */
+
+int main(int argc, char** argv) {
+    int repetitions = 200;
+    std::vector<std::string> paths;
+
+    parseMeshArguments(argc, argv, repetitions, paths);
+
+    const OrientedBoxMethod methods[] = {PrincipalComponents, DiTO14, DiTO26};
+    const char* names[] = {"pca", "dito-14", "dito-26"};
+
+    printf("%-50s %-10s %12s %14s %14s\n", "file", "method", "us / box", "volume / pca", "boxes / s");
+    for (const std::string& path : paths) {
+        Mesh mesh;
+        if (!mesh.read(path)) continue;
+
+        double pcaVolume = 0;
+        for (int m = 0; m < 3; m++) {
+            BoundingBox bbox;
+            Clock::time_point start = Clock::now();
+            for (int r = 0; r < repetitions; r++) bbox.computeOrientedBox(mesh.positions, methods[m], 1);
+            double time = seconds(start) / repetitions;
+
+            if (m == 0) pcaVolume = bbox.volume();
+            printf("%-50s %-10s %12.2f %14.3f %14.0f\n", path.c_str(), names[m], 1e6 * time,
+                   bbox.volume() / pcaVolume, 1 / time);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include <cstdio>
+#include "BenchCommon.h"
+#include "BoundingBox.h"
+#include "ConvexHull.h"
+#include "Mesh.h"
+
+/**
+ * Compares PCA boxes computed on all vertices with the pipeline that first reduces the vertices to
+ * their convex hull, and measures the serial and divide and conquer hull builds.
+ * Usage: ./bench_hull [repetitions] [obj files...]
+ * Without files the meshes in assets/ are used.
+ */
+
+int main(int argc, char** argv) {
+    int repetitions = 20;
+    std::vector<std::string> paths;
+
+    parseMeshArguments(argc, argv, repetitions, paths);
+
+    printf("%-50s %10s %10s %12s %12s %12s %14s\n", "file", "vertices", "hull %", "pca ms",
+           "hull ms", "d&c hull ms", "hull+pca ms");
+    for (const std::string& path : paths) {
+        Mesh mesh;
+        if (!mesh.read(path)) continue;
+
+        BoundingBox bbox;
+        Clock::time_point start = Clock::now();
+        for (int r = 0; r < repetitions; r++) bbox.computeOrientedBox(mesh.positions);
+        double pcaTime = seconds(start);
+
+        ConvexHull hull;
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) hull.compute(mesh.positions);
+        double hullTime = seconds(start);
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) hull.compute(mesh.positions, 0);
+        double parallelTime = seconds(start);
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) {
+            hull.compute(mesh.positions, 0);
+            bbox.computeOrientedBox(hull.vertices);
+        }
+        double pipelineTime = seconds(start);
+
+        printf("%-50s %10zu %10.2f %12.3f %12.3f %12.3f %14.3f\n", path.c_str(), mesh.positions.size(),
+               100.0 * hull.vertices.size() / mesh.positions.size(), 1000 * pcaTime / repetitions,
+               1000 * hullTime / repetitions, 1000 * parallelTime / repetitions, 1000 * pipelineTime / repetitions);
+    }
+
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <cstdio>
+#include "BenchCommon.h"
+#include "BoundingBox.h"
+#include "MappedFile.h"
+#include "Mesh.h"
+#include "MeshCache.h"
+
+/**
+ * Compares the time to load a mesh and its boxes from an obj file and from its binary cache.
+ * Usage: ./bench_mesh_cache [repetitions] [obj files...]
+ * Without files the meshes in assets/ are used. The caches are written to /tmp and removed afterwards.
+ */
+
+int main(int argc, char** argv) {
+    int repetitions = 10;
+    std::vector<std::string> paths;
+
+    parseMeshArguments(argc, argv, repetitions, paths);
+
+    printf("%-50s %10s %10s %12s %12s %12s %14s %10s\n", "file", "obj MB", "cache MB", "write ms", "obj ms",
+           "cache ms", "unverified ms", "speedup");
+    for (const std::string& path : paths) {
+        Mesh mesh;
+        if (!mesh.read(path, 0)) continue;
+
+        std::string cachePath = "/tmp/bench_mesh_cache.omc";
+        Clock::time_point start = Clock::now();
+        if (!MeshCache::write(cachePath, mesh)) continue;
+        double writeTime = seconds(start);
+
+        MappedFile obj, cache;
+        obj.open(path);
+        cache.open(cachePath);
+        double objMb = obj.size() / (1024.0 * 1024.0);
+        double cacheMb = cache.size() / (1024.0 * 1024.0);
+
+        // parse the obj on all threads, then fit the boxes
+        double objTime = 0;
+        for (int r = 0; r < repetitions; r++) {
+            start = Clock::now();
+            Mesh loaded;
+            loaded.read(path, 0);
+            BoundingBox axisAlignedBox, orientedBox;
+            axisAlignedBox.computeAxisAlignedBox(loaded.positions);
+            orientedBox.computeOrientedBox(loaded.positions);
+            objTime += seconds(start);
+        }
+
+        // map the cache and copy the arrays, with and without the checksum, the boxes are stored
+        double cacheTime = 0, unverifiedTime = 0;
+        for (int r = 0; r < repetitions; r++) {
+            for (bool verify : {true, false}) {
+                start = Clock::now();
+                Mesh loaded;
+                BoundingBox axisAlignedBox, orientedBox;
+                MeshCache::read(cachePath, loaded, &axisAlignedBox, &orientedBox, verify);
+                (verify ? cacheTime : unverifiedTime) += seconds(start);
+            }
+        }
+        std::remove(cachePath.c_str());
+
+        printf("%-50s %10.2f %10.2f %12.2f %12.2f %12.2f %14.2f %10.1f\n", path.c_str(), objMb, cacheMb,
+               1e3 * writeTime, 1e3 * objTime / repetitions, 1e3 * cacheTime / repetitions,
+               1e3 * unverifiedTime / repetitions, objTime / cacheTime);
+    }
+
+    return 0;
+}
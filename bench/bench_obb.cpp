@@ -0,0 +1,44 @@
+#include <cstdio>
+#include "BenchCommon.h"
+#include "BoundingBox.h"
+#include "Mesh.h"
+
+/**
+ * Compares the oriented bounding box algorithms by running time and by box volume relative to the
+ * PCA box.
+ * Usage: ./bench_obb [repetitions] [obj files...]
+ * Without files the meshes in assets/ are used.
+ */
+
+int main(int argc, char** argv) {
+    int repetitions = 10;
+    std::vector<std::string> paths;
+
+    parseMeshArguments(argc, argv, repetitions, paths);
+
+    const OrientedBoxMethod methods[] = {PrincipalComponents, HullPrincipalComponents, MinimumVolume,
+                                         SurfacePrincipalComponents, HullSurfacePrincipalComponents};
+    const char* names[] = {"pca", "hull pca", "min volume", "surface pca", "hull surface"};
+
+    printf("%-50s %-12s %12s %12s %14s\n", "file", "method", "ms", "volume", "volume / pca");
+    for (const std::string& path : paths) {
+        Mesh mesh;
+        if (!mesh.read(path)) continue;
+
+        double pcaVolume = 0;
+        for (int m = 0; m < 5; m++) {
+            BoundingBox bbox;
+            Clock::time_point start = Clock::now();
+            for (int r = 0; r < repetitions; r++) {
+                bbox.computeOrientedBox(mesh.positions, mesh.triangles, methods[m]);
+            }
+            double ms = 1000 * seconds(start) / repetitions;
+
+            if (m == 0) pcaVolume = bbox.volume();
+            printf("%-50s %-12s %12.3f %12.5f %14.3f\n", path.c_str(), names[m], ms, bbox.volume(),
+                   bbox.volume() / pcaVolume);
+        }
+    }
+
+    return 0;
+}
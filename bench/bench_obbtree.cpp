@@ -0,0 +1,55 @@
+#include <cstdio>
+#include "BenchCommon.h"
+#include "Mesh.h"
+#include "OBBTree.h"
+
+/**
+ * Measures the OBBTree build and the mesh-mesh overlap query. Each mesh is tested against a copy
+ * of itself, rotated and moved along x so that the copies overlap, graze each other or are apart.
+ * Usage: ./bench_obbtree [repetitions] [obj files...]
+ * Without files the meshes in assets/ are used.
+ */
+
+int main(int argc, char** argv) {
+    int repetitions = 20;
+    std::vector<std::string> paths;
+
+    parseMeshArguments(argc, argv, repetitions, paths);
+
+    const double offsets[] = {0.5, 1.5, 2.5};
+
+    printf("%-50s %10s %8s %6s %10s %10s %12s %12s %12s\n", "file", "triangles", "nodes", "depth", "build ms",
+           "build 1t", "us @ 0.5", "us @ 1.5", "us @ 2.5");
+    for (const std::string& path : paths) {
+        Mesh mesh;
+        if (!mesh.read(path)) continue;
+
+        OBBTree tree;
+        Clock::time_point start = Clock::now();
+        for (int r = 0; r < repetitions; r++) tree.build(mesh, 1);
+        double serialTime = seconds(start);
+
+        start = Clock::now();
+        for (int r = 0; r < repetitions; r++) tree.build(mesh);
+        double buildTime = seconds(start);
+
+        printf("%-50s %10zu %8zu %6d %10.3f %10.3f", path.c_str(), tree.triangleCount(), tree.nodeCount(),
+               tree.depth(), 1000 * buildTime / repetitions, 1000 * serialTime / repetitions);
+
+        for (double offset : offsets) {
+            Eigen::Isometry3d transform = Eigen::Isometry3d::Identity();
+            transform.translate(Eigen::Vector3d(offset, 0, 0));
+            transform.rotate(Eigen::AngleAxisd(0.5, Eigen::Vector3d(1, 1, 0).normalized()));
+
+            int queries = 100 * repetitions;
+            bool hit = false;
+            start = Clock::now();
+            for (int r = 0; r < queries; r++) hit = OBBTree::intersects(tree, tree, transform);
+            printf(" %10.2f %c", 1e6 * seconds(start) / queries, hit ? '*' : ' ');
+        }
+        printf("\n");
+    }
+    printf("* the copies intersect\n");
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+#include <cstdio>
+#include "BenchCommon.h"
+#include "Mesh.h"
+#include "MeshData.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+
+/**
+ * Measures the throughput of the memory-mapped obj parser in MB/s.
+ * Usage: ./bench_obj_parse [repetitions] [obj files...]
+ * Without files the meshes in assets/ are used. The chunked parser runs on all hardware threads.
+ */
+
+int main(int argc, char** argv) {
+    int repetitions = 10;
+    std::vector<std::string> paths;
+
+    parseMeshArguments(argc, argv, repetitions, paths);
+
+    printf("%-50s %10s %12s %14s %12s %12s\n", "file", "MB", "parse MB/s", "parallel MB/s", "read MB/s", "faces");
+    for (const std::string& path : paths) {
+        MappedFile file;
+        if (!file.open(path)) {
+            fprintf(stderr, "Error: could not open %s\n", path.c_str());
+            continue;
+        }
+
+        double mb = file.size() / (1024.0 * 1024.0);
+
+        // parse only
+        double parseTime = 0;
+        int faces = 0;
+        for (int r = 0; r < repetitions; r++) {
+            MeshData data;
+            Clock::time_point start = Clock::now();
+            ObjParser::parse(file.data(), file.data() + file.size(), data);
+            parseTime += seconds(start);
+            faces = data.faceCount();
+        }
+
+        // chunked parse on all hardware threads
+        double parallelTime = 0;
+        for (int r = 0; r < repetitions; r++) {
+            MeshData data;
+            Clock::time_point start = Clock::now();
+            ObjParser::parse(file.data(), file.data() + file.size(), data, 0);
+            parallelTime += seconds(start);
+        }
+
+        // parse, build and normalize
+        double readTime = 0;
+        for (int r = 0; r < repetitions; r++) {
+            Mesh mesh;
+            Clock::time_point start = Clock::now();
+            mesh.read(path);
+            readTime += seconds(start);
+        }
+
+        printf("%-50s %10.2f %12.1f %14.1f %12.1f %12d\n", path.c_str(), mb,
+               mb * repetitions / parseTime, mb * repetitions / parallelTime,
+               mb * repetitions / readTime, faces);
+    }
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include "BenchCommon.h"
+#include "Mesh.h"
+#include "ObjWriter.h"
+
+/**
+ * Measures the throughput of the obj writer in MB/s of output, writing to a file in the temporary
+ * directory. For reference the vertex and face records are also written with operator<< and std::endl,
+ * the way the writer formatted them before.
+ * Usage: ./bench_obj_write [repetitions] [obj files...]
+ * Without files the meshes in assets/ are used. The parallel writer runs on all hardware threads.
+ */
+
+// writes the v and f records with operator<<, flushing every line
+void writeWithStream(std::ofstream& out, const Mesh& mesh) {
+    for (VertexCIter v = mesh.vertices.begin(); v != mesh.vertices.end(); v++) {
+        out << "v " << v->position.x() << " " << v->position.y() << " " << v->position.z() << std::endl;
+    }
+
+    for (FaceCIter f = mesh.faces.begin(); f != mesh.faces.end(); f++) {
+        HalfEdgeId he = f->he;
+        if (mesh.halfEdges[he].onBoundary) continue;
+
+        out << "f";
+        do {
+            out << " " << mesh.halfEdges[he].vertex + 1;
+            he = mesh.halfEdges[he].next;
+        } while (he != f->he);
+        out << std::endl;
+    }
+}
+
+int main(int argc, char** argv) {
+    int repetitions = 10;
+    std::vector<std::string> paths;
+
+    parseMeshArguments(argc, argv, repetitions, paths);
+
+    std::string outputPath = (std::filesystem::temp_directory_path() / "bench_obj_write.obj").string();
+
+    printf("%-50s %10s %12s %14s %14s\n", "file", "MB", "write MB/s", "parallel MB/s", "ostream MB/s");
+    for (const std::string& path : paths) {
+        Mesh mesh;
+        if (!mesh.read(path)) {
+            fprintf(stderr, "Error: could not read %s\n", path.c_str());
+            continue;
+        }
+
+        // the writer on one thread, then on all hardware threads
+        double writeTime[2] = {0, 0};
+        for (int t = 0; t < 2; t++) {
+            for (int r = 0; r < repetitions; r++) {
+                Clock::time_point start = Clock::now();
+                mesh.write(outputPath, t == 0 ? 1 : 0);
+                writeTime[t] += seconds(start);
+            }
+        }
+        double mb = std::filesystem::file_size(outputPath) / (1024.0 * 1024.0);
+
+        // operator<< with a flush per line, which writes fewer records
+        double streamTime = 0, streamMb = 0;
+        for (int r = 0; r < repetitions; r++) {
+            Clock::time_point start = Clock::now();
+            std::ofstream out(outputPath.c_str());
+            writeWithStream(out, mesh);
+            out.close();
+            streamTime += seconds(start);
+        }
+        streamMb = std::filesystem::file_size(outputPath) / (1024.0 * 1024.0);
+
+        printf("%-50s %10.2f %12.1f %14.1f %14.1f\n", path.c_str(), mb, mb * repetitions / writeTime[0],
+               mb * repetitions / writeTime[1], streamMb * repetitions / streamTime);
+    }
+
+    std::filesystem::remove(outputPath);
+    return 0;
+}
@@ -0,0 +1,57 @@
+#include <cstdio>
+#include "BenchCommon.h"
+#include "BoundingBox.h"
+#include "MappedFile.h"
+#include "Mesh.h"
+#include "StreamingBounds.h"
+
+/**
+ * Compares the time to the axis-aligned and PCA boxes of an obj file when the mesh is loaded first and
+ * when the positions are streamed, and reports the streaming rate in MB/s.
+ * Usage: ./bench_streaming_bounds [repetitions] [obj files...]
+ * Without files the meshes in assets/ are used. Both paths run on all hardware threads.
+ */
+
+int main(int argc, char** argv) {
+    int repetitions = 10;
+    std::vector<std::string> paths;
+
+    parseMeshArguments(argc, argv, repetitions, paths);
+
+    printf("%-50s %10s %12s %12s %14s %10s\n", "file", "MB", "load ms", "stream ms", "stream MB/s", "speedup");
+    for (const std::string& path : paths) {
+        MappedFile file;
+        if (!file.open(path)) {
+            fprintf(stderr, "Error: could not open %s\n", path.c_str());
+            continue;
+        }
+        double mb = file.size() / (1024.0 * 1024.0);
+
+        // read the mesh, then fit the boxes
+        double loadTime = 0;
+        for (int r = 0; r < repetitions; r++) {
+            Clock::time_point start = Clock::now();
+            Mesh mesh;
+            mesh.read(path);
+            BoundingBox axisAlignedBox, orientedBox;
+            axisAlignedBox.computeAxisAlignedBox(mesh.positions);
+            orientedBox.computeOrientedBox(mesh.positions);
+            loadTime += seconds(start);
+        }
+
+        // stream the positions twice
+        double streamTime = 0;
+        for (int r = 0; r < repetitions; r++) {
+            Clock::time_point start = Clock::now();
+            BoundingBox axisAlignedBox, orientedBox;
+            StreamingBounds::computeBoxes(path, axisAlignedBox, orientedBox);
+            streamTime += seconds(start);
+        }
+
+        printf("%-50s %10.2f %12.2f %12.2f %14.1f %10.1f\n", path.c_str(), mb,
+               1e3 * loadTime / repetitions, 1e3 * streamTime / repetitions,
+               2 * mb * repetitions / streamTime, loadTime / streamTime);
+    }
+
+    return 0;
+}
@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+#include "BenchCommon.h"
+#include "BoundingBox.h"
+#include "Json.h"
+#include "MappedFile.h"
+#include "Mesh.h"
+#include "MeshData.h"
+#include "MeshIO.h"
+#include "MeshValidator.h"
+#include "ObjParser.h"
+#include "ThreadPool.h"
+
+/**
+ * Times every stage of loading an obj file and fitting its boxes: parse, build_mesh,
+ * validate, normalize, axis_aligned_box, oriented_box and write. Each input is run
+ * through the whole pipeline once per repetition.
+ * Usage: ./bench_suite [--repetitions N] [--threads N] [--triangles LIST] [--output FILE] [obj files or folders...]
+ * Without files every obj file under assets/ is used. LIST holds the triangle counts of synthetic
+ * tori, e.g. 1M,10M,50M (the default), or 0 for none. Sizes that would not fit in the available
+ * memory, and inputs whose mesh cannot be built, are skipped and listed in the report. The report
+ * is JSON in the format of Google Benchmark, so two runs can be diffed or compared with its
+ * compare.py. Peak RSS is the high water mark of the process during each stage.
+ */
+
+// rough memory use per triangle of the obj text, the parsed data and the halfedge mesh together
+const double bytesPerTriangle = 320;
+
+// an obj buffer to run the stages on
+struct Input {
+    std::string name;
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+// timings of one stage of one input over all repetitions
+struct StageResult {
+    std::string name;
+    std::vector<double> realSeconds;
+    std::vector<double> cpuSeconds;
+    size_t bytes = 0;
+    size_t peakRss = 0;
+};
+
+// resets the peak resident set size of the process, false if the kernel does not allow it
+bool resetPeakRss() {
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.close();
+
+    return (bool)clearRefs;
+}
+
+// returns the peak resident set size of the process in bytes since it was last reset
+size_t peakRss() {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) return std::stoull(line.substr(6)) * 1024;
+    }
+
+    return 0;
+}
+
+// returns the memory available to new allocations in bytes
+size_t availableMemory() {
+    std::ifstream meminfo("/proc/meminfo");
+    std::string line;
+    while (std::getline(meminfo, line)) {
+        if (line.compare(0, 13, "MemAvailable:") == 0) return std::stoull(line.substr(13)) * 1024;
+    }
+
+    return (size_t)sysconf(_SC_AVPHYS_PAGES) * (size_t)sysconf(_SC_PAGESIZE);
+}
+
+// parses a triangle count such as 500K, 10M or 1000000, 0 if it is not a number
+size_t parseCount(const std::string& s) {
+    char* end = nullptr;
+    double value = std::strtod(s.c_str(), &end);
+    if (end == s.c_str()) return 0;
+    if (*end == 'K' || *end == 'k') value *= 1e3;
+    if (*end == 'M' || *end == 'm') value *= 1e6;
+
+    return value > 0 ? (size_t)value : 0;
+}
+
+// returns a count with a K or M suffix
+std::string formatCount(size_t n) {
+    if (n >= 1000000 && n % 1000000 == 0) return std::to_string(n / 1000000) + "M";
+    if (n >= 1000 && n % 1000 == 0) return std::to_string(n / 1000) + "K";
+
+    return std::to_string(n);
+}
+
+// writes the obj text of a closed torus with about the given number of triangles
+std::string torusObj(size_t triangles) {
+    size_t quads = std::max<size_t>(triangles / 2, 9);
+    size_t rings = std::max<size_t>(3, (size_t)std::sqrt((double)quads));
+    size_t segments = std::max<size_t>(3, quads / rings);
+
+    std::string text;
+    text.reserve(rings * segments * 80);
+    char line[128];
+
+    for (size_t i = 0; i < rings; i++) {
+        double u = 2 * M_PI * i / rings;
+        for (size_t j = 0; j < segments; j++) {
+            double v = 2 * M_PI * j / segments;
+            double r = 1 + 0.35 * std::cos(v);
+            text.append(line, snprintf(line, sizeof(line), "v %.9g %.9g %.9g\n", r * std::cos(u), r * std::sin(u),
+                                       0.35 * std::sin(v)));
+        }
+    }
+
+    for (size_t i = 0; i < rings; i++) {
+        size_t next = (i + 1) % rings;
+        for (size_t j = 0; j < segments; j++) {
+            size_t k = (j + 1) % segments;
+            size_t a = i * segments + j + 1, b = next * segments + j + 1;
+            size_t c = next * segments + k + 1, d = i * segments + k + 1;
+            text.append(line, snprintf(line, sizeof(line), "f %zu %zu %zu\nf %zu %zu %zu\n", a, b, c, a, c, d));
+        }
+    }
+
+    return text;
+}
+
+// runs every stage of the pipeline on an input and appends the timings of this repetition; if the mesh cannot
+// be built the later stages are not run and false is returned with the problems in error
+bool runPipeline(const Input& input, int threads, const std::string& outputPath, std::vector<StageResult>& stages,
+                 size_t& triangles, std::string& error) {
+    auto stage = [&](size_t s, const char* name, const std::function<void()>& body) {
+        if (stages.size() <= s) stages.resize(s + 1);
+        stages[s].name = name;
+
+        resetPeakRss();
+        std::clock_t cpuStart = std::clock();
+        Clock::time_point start = Clock::now();
+        body();
+        stages[s].realSeconds.push_back(seconds(start));
+        stages[s].cpuSeconds.push_back((double)(std::clock() - cpuStart) / CLOCKS_PER_SEC);
+        stages[s].peakRss = std::max(stages[s].peakRss, peakRss());
+    };
+
+    MeshData data;
+    Mesh mesh;
+    BoundingBox axisAlignedBox, orientedBox;
+
+    stage(0, "parse", [&]() {
+        if (threads == 1) ObjParser::parse(input.data, input.data + input.size, data);
+        else ObjParser::parse(input.data, input.data + input.size, data, threads);
+    });
+    stages[0].bytes = input.size;
+
+    bool built = false;
+    stage(1, "build_mesh", [&]() {
+        built = MeshIO::buildMesh(data, mesh, mesh.diagnostics);
+        data = MeshData();
+    });
+    if (!built) {
+        error = mesh.diagnostics.hasErrors() ? mesh.diagnostics.summary() : "could not build the mesh";
+        return false;
+    }
+
+    stage(2, "validate", [&]() { MeshValidator::validate(mesh, threads); });
+    stage(3, "normalize", [&]() { mesh.normalize(); });
+
+    mesh.updatePositionBuffer();
+    mesh.updateTriangleBuffer();
+
+    stage(4, "axis_aligned_box", [&]() { axisAlignedBox.computeAxisAlignedBox(mesh.positions, threads); });
+    stage(5, "oriented_box", [&]() { orientedBox.computeOrientedBox(mesh.positions, threads); });
+    stage(6, "write", [&]() {
+        std::ofstream out(outputPath.c_str());
+        MeshIO::write(out, mesh, threads);
+    });
+    stages[6].bytes = std::filesystem::exists(outputPath) ? std::filesystem::file_size(outputPath) : 0;
+
+    triangles = mesh.triangles.size() / 3;
+    return true;
+}
+
+// writes the record of one stage of one input
+void writeBenchmark(std::ostream& out, const Input& input, const StageResult& stage, size_t triangles, bool& first) {
+    double realTime = 0, cpuTime = 0;
+    for (size_t r = 0; r < stage.realSeconds.size(); r++) {
+        realTime += stage.realSeconds[r];
+        cpuTime += stage.cpuSeconds[r];
+    }
+    realTime /= stage.realSeconds.size();
+    cpuTime /= stage.cpuSeconds.size();
+    double minTime = *std::min_element(stage.realSeconds.begin(), stage.realSeconds.end());
+    std::string name = stage.name + "/" + input.name;
+
+    out << (first ? "\n" : ",\n");
+    first = false;
+    out << "    {\"name\": " << Json::quote(name) << ", \"run_name\": " << Json::quote(name)
+        << ", \"run_type\": \"iteration\", \"iterations\": " << stage.realSeconds.size()
+        << ", \"real_time\": " << 1e3 * realTime << ", \"cpu_time\": " << 1e3 * cpuTime
+        << ", \"min_time\": " << 1e3 * minTime << ", \"time_unit\": \"ms\"";
+    if (stage.bytes > 0) out << ", \"bytes_per_second\": " << stage.bytes / realTime;
+    out << ", \"items_per_second\": " << triangles / realTime << ", \"triangles\": " << triangles
+        << ", \"peak_rss_bytes\": " << stage.peakRss << "}";
+}
+
+int main(int argc, char** argv) {
+    int repetitions = 3;
+    int threads = 0;
+    std::string output;
+    std::vector<size_t> syntheticSizes = {1000000, 10000000, 50000000};
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--repetitions" && hasValue) {
+            repetitions = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--threads" && hasValue) {
+            threads = std::max(0, atoi(argv[++i]));
+        } else if (arg == "--output" && hasValue) {
+            output = argv[++i];
+        } else if (arg == "--triangles" && hasValue) {
+            syntheticSizes.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                if (parseCount(item) > 0) syntheticSizes.push_back(parseCount(item));
+            }
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty()) inputs.push_back("assets");
+
+    std::vector<std::string> paths;
+    for (const std::string& input : inputs) {
+        if (std::filesystem::is_directory(input)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(input)) {
+                if (entry.is_regular_file() && entry.path().extension() == ".obj") paths.push_back(entry.path());
+            }
+        } else {
+            paths.push_back(input);
+        }
+    }
+    std::sort(paths.begin(), paths.end());
+
+    std::string outputPath = (std::filesystem::temp_directory_path() / "bench_suite_write.obj").string();
+    bool peakRssAvailable = resetPeakRss();
+    std::ostringstream benchmarks;
+    std::vector<std::string> skipped;
+    bool first = true;
+
+    auto run = [&](const Input& input) {
+        std::vector<StageResult> stages;
+        size_t triangles = 0;
+        std::string error;
+        for (int r = 0; r < repetitions; r++) {
+            if (!runPipeline(input, ThreadPool::resolveThreadCount(threads), outputPath, stages, triangles, error)) {
+                skipped.push_back(input.name + ": " + error);
+                fprintf(stderr, "Skipping %s\n", skipped.back().c_str());
+                return;
+            }
+        }
+
+        for (const StageResult& stage : stages) {
+            writeBenchmark(benchmarks, input, stage, triangles, first);
+            double milliseconds = 0;
+            for (double s : stage.realSeconds) milliseconds += 1e3 * s / stage.realSeconds.size();
+            fprintf(stderr, "%-24s %-50s %12.2f ms %10.1f MB\n", stage.name.c_str(), input.name.c_str(), milliseconds,
+                    stage.peakRss / (1024.0 * 1024.0));
+        }
+    };
+
+    for (const std::string& path : paths) {
+        MappedFile file;
+        if (!file.open(path)) {
+            skipped.push_back(path + ": could not open");
+            continue;
+        }
+        Input input;
+        input.name = path;
+        input.data = file.data();
+        input.size = file.size();
+        run(input);
+    }
+
+    for (size_t triangles : syntheticSizes) {
+        std::string name = "synthetic_torus_" + formatCount(triangles);
+        if (bytesPerTriangle * triangles > availableMemory()) {
+            skipped.push_back(name + ": needs about " + std::to_string((size_t)(bytesPerTriangle * triangles) >> 20) +
+                              " MB, more than is available");
+            fprintf(stderr, "Skipping %s\n", skipped.back().c_str());
+            continue;
+        }
+
+        std::string text = torusObj(triangles);
+        Input input;
+        input.name = name;
+        input.data = text.data();
+        input.size = text.size();
+        run(input);
+    }
+    std::remove(outputPath.c_str());
+
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+    char host[256] = "";
+    gethostname(host, sizeof(host) - 1);
+
+    std::ostringstream report;
+    report.precision(6);
+    report << "{\n  \"context\": {\"date\": " << Json::quote(date) << ", \"host_name\": " << Json::quote(host)
+           << ", \"executable\": " << Json::quote(argv[0]) << ", \"num_cpus\": " << std::thread::hardware_concurrency()
+           << ", \"threads\": " << ThreadPool::resolveThreadCount(threads) << ", \"repetitions\": " << repetitions
+           << ", \"peak_rss_per_stage\": "
+           << (peakRssAvailable ? "true" : "false") << ", \"skipped\": [";
+    for (size_t i = 0; i < skipped.size(); i++) report << (i > 0 ? ", " : "") << Json::quote(skipped[i]);
+    report << "]},\n  \"benchmarks\": [" << benchmarks.str() << "\n  ]\n}\n";
+
+    if (output.empty()) {
+        std::cout << report.str();
+    } else {
+        std::ofstream out(output.c_str());
+        out << report.str();
+        if (!out) {
+            fprintf(stderr, "Error: could not write %s\n", output.c_str());
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+#ifndef BVH_H
+#define BVH_H
+
+#include "Types.h"
+#include "PositionBuffer.h"
+
+// node of a BVH in 32 bytes, the first child of an inner node is stored right after it
+struct BVHNode {
+    // corners of the box, rounded outwards to float
+    float min[3];
+    float max[3];
+
+    // first triangle of a leaf, or index of the second child of an inner node
+    uint32_t offset;
+
+    // number of triangles of a leaf, 0 for inner nodes
+    uint32_t count;
+};
+
+// nearest intersection of a ray with the triangles
+struct RayHit {
+    // ray parameter of the hit, the distance for a unit direction
+    double distance;
+
+    // index of the triangle hit in the input triangles, InvalidId for a miss
+    uint32_t triangle;
+
+    // barycentric coordinates of the hit with respect to the second and third corner
+    double u;
+    double v;
+};
+
+// point on the triangles nearest to a query point
+struct ClosestPoint {
+    Eigen::Vector3d point;
+
+    // distance from the query point
+    double distance;
+
+    // index of the triangle in the input triangles, InvalidId if nothing is in range
+    uint32_t triangle;
+};
+
+class BVH {
+public:
+    // default constructor
+    BVH();
+
+    // builds the hierarchy over the triangles of a mesh
+    bool build(const Mesh& mesh);
+
+    // builds the hierarchy over triangles given as three indices into positions each
+    bool build(const PositionBuffer& positions, const std::vector<uint32_t>& triangles);
+
+    // finds the nearest hit of a ray within maxDistance, returns false on a miss
+    bool raycast(const Eigen::Vector3d& origin, const Eigen::Vector3d& direction, RayHit& hit,
+                 double maxDistance = INFINITY) const;
+
+    // casts one ray per origin and direction on threads threads (0 for all hardware threads)
+    bool raycast(const PositionBuffer& origins, const PositionBuffer& directions, std::vector<RayHit>& hits,
+                 int threads = 0, double maxDistance = INFINITY) const;
+
+    // finds the point on the triangles nearest to a point within maxDistance, returns false if there is none
+    bool closestPoint(const Eigen::Vector3d& point, ClosestPoint& result, double maxDistance = INFINITY) const;
+
+    // finds the closest point for each point on threads threads (0 for all hardware threads)
+    void closestPoints(const PositionBuffer& points, std::vector<ClosestPoint>& results, int threads = 0) const;
+
+    // returns the number of nodes
+    size_t nodeCount() const { return nodes.size(); }
+
+    // returns the number of triangles
+    size_t triangleCount() const { return triangleIndices.size(); }
+
+    // removes the hierarchy
+    void clear();
+
+    // nodes in depth first order, the root is nodes[0]
+    std::vector<BVHNode> nodes;
+
+    // three corners per triangle, in leaf order
+    std::vector<Eigen::Vector3d> corners;
+
+    // index of each triangle in the input triangles
+    std::vector<uint32_t> triangleIndices;
+
+    // number of bins of the surface area heuristic
+    static constexpr int binCount = 16;
+
+    // largest leaf the surface area heuristic may keep
+    static constexpr uint32_t maxLeafSize = 8;
+
+    // nodes deeper than this become leaves, which bounds the traversal stack
+    static constexpr int maxDepth = 64;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef BATCH_PROCESSOR_H
+#define BATCH_PROCESSOR_H
+
+#include <ostream>
+
+#include "Types.h"
+#include "BoundingBox.h"
+#include "OrientedBox.h"
+
+class ResultCache;
+
+// settings of a batch run
+struct BatchOptions {
+    // number of meshes processed at once, 0 for all hardware threads
+    int threads = 0;
+
+    // "jsonl" or "csv"
+    std::string format = "jsonl";
+
+    // algorithm of the oriented box
+    OrientedBoxMethod method = PrincipalComponents;
+
+    // number of meshes queued or in progress at any time, 0 for twice the thread count
+    size_t maxInFlight = 0;
+
+    // results of unchanged files are read from and new results written to this cache, null for none
+    ResultCache* cache = nullptr;
+};
+
+// boxes of one mesh, or why it could not be processed
+struct BatchResult {
+    std::string path;
+    bool success = false;
+    std::string error;
+    size_t vertexCount = 0;
+    size_t faceCount = 0;
+    BoundingBox axisAlignedBox;
+    OrientedBox orientedBox;
+    double loadMilliseconds = 0;
+    double fitMilliseconds = 0;
+};
+
+// Computes the boxes of many meshes without a window, one mesh per worker thread
+class BatchProcessor {
+public:
+    // processes the meshes and writes one record per mesh in input order, returns the number of failures
+    static size_t run(const std::vector<std::string>& paths, const BatchOptions& options, std::ostream& out);
+
+    // loads one mesh and fits its boxes on the calling thread, or reads them from the cache if it is not
+    // null and holds the file, errors are reported in the result
+    static BatchResult process(const std::string& path, OrientedBoxMethod method, ResultCache* cache = nullptr);
+
+    // writes the header of a format, if it has one
+    static void writeHeader(std::ostream& out, const std::string& format);
+
+    // writes the record of one mesh
+    static void writeRecord(std::ostream& out, const std::string& format, const BatchResult& result);
+
+    // looks up a method by its command line name (pca, hull-pca, min-volume, surface-pca,
+    // hull-surface-pca, dito-14, dito-26), returns false for an unknown name
+    static bool parseMethod(const std::string& name, OrientedBoxMethod& method);
+};
+
+#endif
@@ -2,6 +2,29 @@
 #define BOUNDING_BOX_H
 
 #include "Types.h"
+#include "PositionBuffer.h"
+
+class ConvexHull;
+class PointSource;
+struct PointMoments;
+
+// Algorithms for fitting an oriented bounding box
+enum OrientedBoxMethod {
+    // principal axes of the points
+    PrincipalComponents,
+    // principal axes of the convex hull vertices
+    HullPrincipalComponents,
+    // smallest box with a face flush with a convex hull face, found with rotating calipers
+    MinimumVolume,
+    // principal axes of the surface, area weighted, needs triangles
+    SurfacePrincipalComponents,
+    // principal axes of the convex hull surface, area weighted
+    HullSurfacePrincipalComponents,
+    // DiTO fit from the extremal points along 7 directions
+    DiTO14,
+    // DiTO fit from the extremal points along 13 directions
+    DiTO26
+};
 
 class BoundingBox {
 public:
@@ -35,12 +58,61 @@ public:
     // Compute an oriented bounding box using principal component analysis from a set of vertices
     void computeOrientedBox(std::vector<Vertex>& vertices);
 
+    // Compute an axis-aligned bounding box from a position buffer on threads threads (0 for all hardware threads)
+    void computeAxisAlignedBox(const PositionBuffer& positions, int threads = 0);
+
+    // Compute an oriented bounding box using principal component analysis from a position buffer on threads threads
+    void computeOrientedBox(const PositionBuffer& positions, int threads = 0);
+
+    // Compute an oriented bounding box from a position buffer with the given method, false for methods needing triangles
+    bool computeOrientedBox(const PositionBuffer& positions, OrientedBoxMethod method, int threads = 0);
+
+    // Compute an axis-aligned bounding box from a point source, such as a strided array, without copying it
+    void computeAxisAlignedBox(const PointSource& points, int threads = 0);
+
+    // Compute an oriented bounding box from a point source, PCA reads the points in place, other methods copy them
+    bool computeOrientedBox(const PointSource& points, OrientedBoxMethod method = PrincipalComponents, int threads = 0);
+
+    // Compute an oriented bounding box using principal component analysis of a triangulated surface
+    void computeOrientedBox(const PositionBuffer& positions, const std::vector<uint32_t>& triangles, int threads = 0);
+
+    // Compute an oriented bounding box of a triangulated surface with any method
+    void computeOrientedBox(const PositionBuffer& positions, const std::vector<uint32_t>& triangles,
+                            OrientedBoxMethod method, int threads = 0);
+
+    // Compute an oriented bounding box with the DiTO algorithm from the extremal points along K fixed directions
+    template <int K>
+    void computeDiTOBox(const PositionBuffer& positions, int threads = 0);
+
+    // Return the volume of the bounding box
+    double volume() const;
+
     // Member variables
     Eigen::Vector3d min;
     Eigen::Vector3d max;
     Eigen::Vector3d extent;
     std::vector<Eigen::Vector3d> orientedPoints;
     std::string type;
+
+private:
+    // the streaming bounds set the oriented points of the boxes they compute
+    friend class StreamingBounds;
+
+    // Set the oriented points from a center, principal axes and the extents along them
+    void setOrientedBox(const Eigen::Vector3d& center, const Eigen::Matrix3d& axes,
+                        const Eigen::Vector3d& minVals, const Eigen::Vector3d& maxVals);
+
+    // Fit the box along the principal axes of the given moments
+    void setPrincipalBox(const PointSource& points, const PointMoments& moments, int threads);
+
+    // Fit the smallest box with a face flush with a face of the hull
+    void computeMinimumVolumeBox(const ConvexHull& hull, int threads);
+
+    // Print the axis-aligned box
+    void printAxisAlignedBox(std::ostream& out) const;
+
+    // Print the oriented points
+    void printOrientedBox(std::ostream& out) const;
 };
 
 #endif // BOUNDING_BOX_H
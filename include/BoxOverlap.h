@@ -0,0 +1,27 @@
+#ifndef BOX_OVERLAP_H
+#define BOX_OVERLAP_H
+
+#include "Types.h"
+#include "OrientedBoxBuffer.h"
+
+// Batched overlap tests between oriented boxes, built on the SIMD separating axis kernels
+class BoxOverlap {
+public:
+    // tests every box of a against every box of b, result holds a.size() rows of b.size() flags
+    static void overlapMatrix(const OrientedBoxBuffer& a, const OrientedBoxBuffer& b, std::vector<uint8_t>& result,
+                              int threads = 0);
+
+    // lists the overlapping pairs (index in a, index in b) of all box pairs, sorted
+    static void overlappingPairs(const OrientedBoxBuffer& a, const OrientedBoxBuffer& b,
+                                 std::vector<std::pair<uint32_t, uint32_t>>& pairs, int threads = 0);
+
+    // lists the overlapping pairs i < j within one set of boxes, sorted, pruning candidates by
+    // sweeping their extents along one axis
+    static void sweepAndPrune(const OrientedBoxBuffer& boxes, std::vector<std::pair<uint32_t, uint32_t>>& pairs,
+                              int threads = 0);
+
+    // number of rows or candidate pairs per parallel task
+    static constexpr size_t blockSize = 4096;
+};
+
+#endif
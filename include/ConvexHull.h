@@ -0,0 +1,40 @@
+#ifndef CONVEX_HULL_H
+#define CONVEX_HULL_H
+
+#include "Types.h"
+#include "PositionBuffer.h"
+
+class ConvexHull {
+public:
+    // default constructor
+    ConvexHull();
+
+    // computes the hull of a set of points with quickhull, returns false if the points do not span a volume
+    bool compute(const PositionBuffer& points);
+
+    // computes the hull by divide and conquer over blocks of points on threads threads (0 for all hardware threads)
+    bool compute(const PositionBuffer& points, int threads);
+
+    // returns the number of triangles
+    size_t faceCount() const { return triangles.size() / 3; }
+
+    // returns the outward unit normal of triangle f
+    Eigen::Vector3d faceNormal(size_t f) const;
+
+    // removes the hull
+    void clear();
+
+    // positions of the hull vertices
+    PositionBuffer vertices;
+
+    // index of each hull vertex in the input points
+    std::vector<uint32_t> vertexIndices;
+
+    // three indices into vertices per triangle, counterclockwise seen from outside
+    std::vector<uint32_t> triangles;
+
+    // number of points per block in the divide and conquer mode
+    static constexpr size_t blockSize = 65536;
+};
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef DIAGNOSTICS_H
+#define DIAGNOSTICS_H
+
+#include <atomic>
+#include <functional>
+
+#include "Types.h"
+
+// severity of a message, from most to least verbose, LogOff silences everything
+enum LogLevel {
+    LogDebug,
+    LogInfo,
+    LogWarning,
+    LogError,
+    LogOff
+};
+
+// receives every message at or above the log level, called from any thread and possibly concurrently
+typedef std::function<void(LogLevel level, const std::string& message)> LogSink;
+
+// Routes the messages of the library to a sink. Off by default; a message below the level costs one
+// relaxed atomic load, so callers check isEnabled before formatting anything expensive.
+class Log {
+public:
+    // sets the least severe level that reaches the sink
+    static void setLevel(LogLevel level);
+
+    // returns the least severe level that reaches the sink
+    static LogLevel level() { return (LogLevel)threshold.load(std::memory_order_relaxed); }
+
+    // checks if messages of a level reach the sink
+    static bool isEnabled(LogLevel level) { return level >= threshold.load(std::memory_order_relaxed); }
+
+    // replaces the sink, an empty sink restores the default that writes to std::cerr
+    static void setSink(LogSink sink);
+
+    // passes a message to the sink if its level is enabled
+    static void write(LogLevel level, const std::string& message);
+
+    // parses a level name (debug, info, warning, error, off), returns false for an unknown name
+    static bool parseLevel(const std::string& name, LogLevel& level);
+
+private:
+    static std::atomic<int> threshold;
+};
+
+// one kind of problem and where it occurred
+struct DiagnosticEntry {
+    // what is wrong, e.g. "isolated_vertex" or "degenerate_face", the word after the underscore names
+    // the kind of element the indices refer to
+    std::string code;
+
+    // LogError if the problem made the operation fail
+    LogLevel level = LogWarning;
+
+    // occurrences of the problem
+    size_t count = 0;
+
+    // indices of the first DiagnosticsReport::maxIndices offending elements, in the order they were found
+    std::vector<int> indices;
+};
+
+// Problems found while reading a mesh, aggregated per kind. Checks count occurrences and keep the first
+// few indices, so that a scan with millions of bad elements formats and prints nothing until the whole
+// report is logged once, if at all.
+class DiagnosticsReport {
+public:
+    // counts one occurrence of a problem at an element index
+    void add(const char* code, LogLevel level, int index);
+
+    // adds the entries of another report
+    void merge(const DiagnosticsReport& report);
+
+    // drops all entries
+    void clear();
+
+    // checks if no problem was found
+    bool empty() const { return entries.empty(); }
+
+    // checks if a problem made the operation fail
+    bool hasErrors() const;
+
+    // returns the occurrences of a problem, 0 if it was not found
+    size_t count(const std::string& code) const;
+
+    // returns the entries separated by semicolons, e.g. "12 isolated_vertex: 4, 9, 17, ...; 1 ..."
+    std::string summary() const;
+
+    // writes the summary of every entry to the log at the level of the entry
+    void log() const;
+
+    // indices kept per entry
+    static constexpr size_t maxIndices = 16;
+
+    // member variables
+    std::vector<DiagnosticEntry> entries;
+
+private:
+    // returns the entry of a problem, adding it if it is new
+    DiagnosticEntry& findEntry(const char* code, LogLevel level);
+};
+
+#endif
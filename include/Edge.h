@@ -6,9 +6,10 @@
 class Edge {
 public:
     // one of the two half edges associated with this edge
-    HalfEdgeIter he;
+    HalfEdgeId he;
     
-    double length() const;
+    // returns edge length
+    double length(const Mesh& mesh) const;
 };
 
 #endif
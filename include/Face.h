@@ -6,16 +6,16 @@
 class Face {
 public:
     // one of the halfedges associated with this face
-    HalfEdgeIter he;
+    HalfEdgeId he;
 
     // checks if this face lies on boundary
-    bool isBoundary() const;
+    bool isBoundary(const Mesh& mesh) const;
 
     // returns face area
-    double area() const;
+    double area(const Mesh& mesh) const;
 
     // returns normal to face
-    Eigen::Vector3d normal() const;
+    Eigen::Vector3d normal(const Mesh& mesh) const;
 };
 
 #endif
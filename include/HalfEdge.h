@@ -6,28 +6,34 @@
 class HalfEdge {
 public:
     // next halfedge around the current face
-    HalfEdgeIter next;
+    HalfEdgeId next;
     
     // other halfedge associated with this edge
-    HalfEdgeIter flip;
+    HalfEdgeId flip;
     
     // vertex at the tail of the halfedge
-    VertexIter vertex;
+    VertexId vertex;
     
     // edge associated with this halfedge
-    EdgeIter edge;
+    EdgeId edge;
     
     // face associated with this halfedge
-    FaceIter face;
+    FaceId face;
     
-    // uv associated with vertex at tail of halfedge
-    Eigen::Vector3d uv;
+    // index into Mesh::uvs of the uv associated with vertex at tail of halfedge, InvalidId if none
+    uint32_t uv;
     
-    // normal associated with vertex at tail of halfedge
-    Eigen::Vector3d normal;
+    // index into Mesh::normals of the normal associated with vertex at tail of halfedge, InvalidId if none
+    uint32_t normal;
     
     // checks if this halfedge is contained in boundary loop
     bool onBoundary;
+
+    // returns the uv associated with vertex at tail of halfedge, zero if none
+    Eigen::Vector3d uvCoordinates(const Mesh& mesh) const;
+
+    // returns the normal associated with vertex at tail of halfedge, zero if none
+    Eigen::Vector3d vertexNormal(const Mesh& mesh) const;
 };
 
 #endif
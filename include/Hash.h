@@ -0,0 +1,15 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 64-bit non-cryptographic hash of a byte range, the XXH64 algorithm. Fast enough to checksum files
+// at memory bandwidth, and stable across runs and platforms of the same byte order.
+class Hash {
+public:
+    // hashes size bytes starting at data
+    static uint64_t compute(const void* data, size_t size, uint64_t seed = 0);
+};
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <string>
+
+// Helpers for the JSON reports of the batch mode, the profiler and the benchmark suite.
+class Json {
+public:
+    // returns s as a JSON string literal, with quotes, backslashes and control characters escaped
+    static std::string quote(const std::string& s);
+};
+
+#endif
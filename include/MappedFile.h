@@ -0,0 +1,38 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+
+class MappedFile {
+public:
+    // default constructor
+    MappedFile();
+
+    // unmaps the file
+    ~MappedFile();
+
+    // maps a file read-only into memory
+    bool open(const std::string& fileName);
+
+    // unmaps the file
+    void close();
+
+    // checks if a file is mapped
+    bool isOpen() const { return opened; }
+
+    // returns the first byte of the file
+    const char* data() const { return buffer; }
+
+    // returns the size of the file in bytes
+    size_t size() const { return length; }
+
+private:
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* buffer;
+    size_t length;
+    bool opened;
+};
+
+#endif
@@ -2,10 +2,12 @@
 #define MESH_H
 
 #include "Types.h"
+#include "Diagnostics.h"
 #include "Vertex.h"
 #include "Edge.h"
 #include "Face.h"
 #include "HalfEdge.h"
+#include "PositionBuffer.h"
 
 class Mesh {
 public:
@@ -15,11 +17,30 @@ public:
     // copy constructor
     Mesh(const Mesh& mesh);
         
-    // read mesh from file
-    bool read(const std::string& fileName);
+    // read mesh from file, parsing on threads threads (0 for all hardware threads), and validate it unless
+    // validate is false, the problems found are left in diagnostics
+    bool read(const std::string& fileName, int threads = 1, bool validate = true);
     
-    // write mesh to file
-    bool write(const std::string& fileName);
+    // write mesh to file, formatting on threads threads (0 for all hardware threads)
+    bool write(const std::string& fileName, int threads = 1) const;
+
+    // copy vertex positions into the position buffer, call after editing vertex positions
+    void updatePositionBuffer();
+
+    // triangulate the faces into the triangle buffer, call after changing the connectivity
+    void updateTriangleBuffer();
+
+    // list the two vertices of every edge in the edge buffer, call after changing the connectivity
+    void updateEdgeBuffer();
+
+    // compute area weighted vertex normals from the triangle buffer, call after editing vertex positions
+    void updateVertexNormals();
+
+    // center mesh about origin and rescale to unit radius, read does this after building the mesh
+    void normalize();
+
+    // exchange the contents of two meshes without copying or reallocating their arrays
+    void swap(Mesh& mesh);
     
     // member variables
     std::vector<HalfEdge> halfEdges;
@@ -28,11 +49,22 @@ public:
     std::vector<Eigen::Vector3d> normals;
     std::vector<Edge> edges;
     std::vector<Face> faces;
-    std::vector<HalfEdgeIter> boundaries;
+    std::vector<HalfEdgeId> boundaries;
 
-private:
-    // center mesh about origin and rescale to unit radius
-    void normalize();
+    // vertex positions as separate x, y, z arrays for the bounding box kernels
+    PositionBuffer positions;
+
+    // three vertex indices per triangle, faces with more sides are split into fans
+    std::vector<uint32_t> triangles;
+
+    // two vertex indices per edge, filled on demand by updateEdgeBuffer
+    std::vector<uint32_t> edgeVertices;
+
+    // unit normal of every vertex, filled on demand by updateVertexNormals
+    std::vector<Eigen::Vector3d> vertexNormals;
+
+    // problems found by the last read, e.g. isolated vertices, logged as one line per kind
+    DiagnosticsReport diagnostics;
 };
 
 #endif
\ No newline at end of file
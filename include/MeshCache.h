@@ -0,0 +1,27 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+#include "Types.h"
+
+class BoundingBox;
+
+// Binary snapshot of a loaded mesh: the vertices, uvs, normals, triangle buffer, halfedge connectivity
+// and the axis-aligned and PCA boxes. Arrays are stored as they are laid out in memory, so reading a
+// cache is one checked copy per array, with no parsing or connectivity build.
+// Caches are only read back on a machine with the same byte order and element layout.
+class MeshCache {
+public:
+    // writes the mesh and its boxes, fitted and checksummed on threads threads (0 for all hardware threads)
+    static bool write(const std::string& fileName, const Mesh& mesh, int threads = 0);
+
+    // reads a cache into mesh and, if not null, the stored boxes; false if it is missing, of another
+    // version or layout, truncated, corrupt (checked only if verify is set) or inconsistent, mesh is then
+    // left unchanged
+    static bool read(const std::string& fileName, Mesh& mesh, BoundingBox* axisAlignedBox = nullptr,
+                     BoundingBox* orientedBox = nullptr, bool verify = true);
+
+    // format version, bumped whenever the layout of the file changes
+    static constexpr uint32_t version = 2;
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef MESH_DATA_H
+#define MESH_DATA_H
+
+#include "Types.h"
+
+class Index {
+public:
+    Index() {}
+
+    Index(int v, int vt, int vn): position(v), uv(vt), normal(vn) {}
+
+    bool operator<(const Index& i) const {
+        if (position < i.position) return true;
+        if (position > i.position) return false;
+        if (uv < i.uv) return true;
+        if (uv > i.uv) return false;
+        if (normal < i.normal) return true;
+        if (normal > i.normal) return false;
+
+        return false;
+    }
+
+    int position;
+    int uv;
+    int normal;
+};
+
+class MeshData {
+public:
+    MeshData(): faceOffsets(1, 0) {}
+
+    // returns the number of faces
+    int faceCount() const { return (int)faceOffsets.size() - 1; }
+
+    // returns the number of corners of face f
+    int faceSize(int f) const { return faceOffsets[f+1] - faceOffsets[f]; }
+
+    std::vector<Eigen::Vector3d> positions;
+    std::vector<Eigen::Vector3d> uvs;
+    std::vector<Eigen::Vector3d> normals;
+
+    // face corners stored back to back, face f spans [faceOffsets[f], faceOffsets[f+1])
+    std::vector<Index> indices;
+    std::vector<int> faceOffsets;
+};
+
+#endif
@@ -1,34 +1,32 @@
 #ifndef MESH_IO_H
 #define MESH_IO_H
 
-#include <fstream>
+#include <ostream>
 #include "Types.h"
 
+class DiagnosticsReport;
 class MeshData;
 
 class MeshIO {
 public:
-    // reads data from obj file
-    static bool read(std::ifstream& in, Mesh& mesh);
+    // reads data from an obj buffer, parsing and validating on threads threads (0 for all hardware threads),
+    // the problems found are left in mesh.diagnostics
+    static bool read(const char* buffer, size_t size, Mesh& mesh, int threads = 1, bool validate = true);
     
-    // writes data in obj format
-    static void write(std::ofstream& out, Mesh& mesh);
+    // writes data in obj format with ObjWriter, formatting on threads threads (0 for all hardware threads)
+    static bool write(std::ostream& out, const Mesh& mesh, int threads = 1);
+
+    // builds the halfedge mesh from parsed obj data, read validates it afterwards with MeshValidator.
+    // Degenerate faces, faces with out of range vertices and faces adding a third face to an edge are
+    // added to the report as errors and make the build fail
+    static bool buildMesh(const MeshData& data, Mesh& mesh, DiagnosticsReport& report);
     
 private:
-    // reserves spave for mesh vertices, uvs, normals and faces
-    static void preallocateMeshElements(const MeshData& data, Mesh& mesh);
+    // reserves space for mesh vertices, uvs, normals, edges and faces
+    static void preallocateMeshElements(const MeshData& data, int nEdges, int nBoundaryEdges, Mesh& mesh);
     
     // sets index for vertices
     static  void indexVertices(Mesh& mesh);
-    
-    // checks if any vertex is not contained in a face
-    static void checkIsolatedVertices(const Mesh& mesh);
-    
-    // checks if a vertex is non-manifold
-    static void checkNonManifoldVertices(const Mesh& mesh);
-    
-    // builds the halfedge mesh
-    static bool buildMesh(const MeshData& data, Mesh& mesh);
 };
 
 #endif
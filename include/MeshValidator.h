@@ -0,0 +1,40 @@
+#ifndef MESH_VALIDATOR_H
+#define MESH_VALIDATOR_H
+
+#include "Types.h"
+
+class DiagnosticsReport;
+
+// problems of a built mesh, element indices in increasing order
+struct ValidationResult {
+    // vertices not contained in a face
+    std::vector<VertexId> isolatedVertices;
+
+    // vertices whose faces do not form a single fan, e.g. the tip of two cones touching at a point
+    std::vector<VertexId> nonManifoldVertices;
+
+    // edges whose two faces disagree on orientation or whose ends are the same vertex
+    std::vector<EdgeId> nonManifoldEdges;
+
+    // number of boundary cycles, 0 for a closed mesh
+    size_t boundaryLoops = 0;
+
+    // checks if no vertex or edge is non-manifold, isolated vertices are allowed
+    bool isManifold() const { return nonManifoldVertices.empty() && nonManifoldEdges.empty(); }
+};
+
+// Checks the connectivity of a built halfedge mesh by element index. Vertices, halfedges and edges are
+// checked in blocks on the thread pool, and nothing is hashed or allocated per element.
+class MeshValidator {
+public:
+    // finds the isolated vertices, non-manifold vertices and edges and counts the boundary loops
+    static ValidationResult validate(const Mesh& mesh, int threads = 0);
+
+    // adds the problems of a result to a report as warnings
+    static void addToReport(const ValidationResult& result, DiagnosticsReport& report);
+
+    // elements checked per parallel task
+    static constexpr size_t blockSize = 1 << 16;
+};
+
+#endif
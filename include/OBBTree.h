@@ -0,0 +1,69 @@
+#ifndef OBB_TREE_H
+#define OBB_TREE_H
+
+#include "Types.h"
+#include "PositionBuffer.h"
+#include "OrientedBox.h"
+
+// node of an OBBTree, the first child of an inner node is stored right after it
+struct OBBNode {
+    // box around the triangles below the node
+    OrientedBox box;
+
+    // first triangle below the node in OBBTree::triangles
+    uint32_t first;
+
+    // number of triangles of a leaf, 0 for inner nodes
+    uint32_t count;
+
+    // index of the second child of an inner node
+    uint32_t right;
+
+    // checks if the node is a leaf
+    bool isLeaf() const { return count > 0; }
+};
+
+class OBBTree {
+public:
+    // default constructor
+    OBBTree();
+
+    // builds the tree over the triangles of a mesh on threads threads (0 for all hardware threads)
+    bool build(const Mesh& mesh, int threads = 0);
+
+    // builds the tree over triangles given as three indices into positions each
+    bool build(const PositionBuffer& positions, const std::vector<uint32_t>& triangles, int threads = 0);
+
+    // returns the number of nodes
+    size_t nodeCount() const { return nodes.size(); }
+
+    // returns the number of triangles
+    size_t triangleCount() const { return triangles.size() / 3; }
+
+    // returns the depth of the tree, 1 for a single leaf
+    int depth() const;
+
+    // removes the tree
+    void clear();
+
+    // checks if the triangles of two trees intersect, transform moves b into the space of a
+    static bool intersects(const OBBTree& a, const OBBTree& b,
+                           const Eigen::Isometry3d& transform = Eigen::Isometry3d::Identity());
+
+    // nodes in depth first order, the root is nodes[0]
+    std::vector<OBBNode> nodes;
+
+    // positions of the triangle corners
+    PositionBuffer vertices;
+
+    // three indices into vertices per triangle, in leaf order
+    std::vector<uint32_t> triangles;
+
+    // index of each triangle in the input triangles
+    std::vector<uint32_t> triangleIndices;
+
+    // maximum number of triangles in a leaf
+    static constexpr uint32_t leafSize = 4;
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef OBJ_PARSER_H
+#define OBJ_PARSER_H
+
+#include "Types.h"
+
+class MeshData;
+class PositionBuffer;
+
+class ObjParser {
+public:
+    // parses v, vt, vn and f records of an obj buffer in place and appends them to data
+    static bool parse(const char* begin, const char* end, MeshData& data);
+
+    // parses an obj buffer in chunks on several threads, the result is identical to the serial parse
+    static bool parse(const char* begin, const char* end, MeshData& data, int threads);
+
+    // appends the positions of the v records starting at begin until maxCount have been read, skipping all
+    // other records, returns where parsing stopped
+    static const char* parsePositions(const char* begin, const char* end, PositionBuffer& positions, size_t maxCount);
+
+    // returns the start of the first record after p that does not continue the line before it
+    static const char* nextRecordStart(const char* p, const char* begin, const char* end);
+};
+
+#endif
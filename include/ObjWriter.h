@@ -0,0 +1,20 @@
+#ifndef OBJ_WRITER_H
+#define OBJ_WRITER_H
+
+#include <ostream>
+#include "Types.h"
+
+// Formats a mesh as obj text. Numbers are formatted with std::to_chars into one buffer per block of
+// records, so that blocks can be formatted in parallel, and each buffer is written with a single call.
+// Faces refer to vertices, uvs and normals by index.
+class ObjWriter {
+public:
+    // writes the v, vt, vn and f records of a mesh, formatting on threads threads (0 for all hardware
+    // threads), returns false if the stream fails
+    static bool write(std::ostream& out, const Mesh& mesh, int threads = 1);
+
+    // records formatted per parallel task
+    static constexpr size_t blockSize = 1 << 14;
+};
+
+#endif
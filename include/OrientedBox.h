@@ -0,0 +1,34 @@
+#ifndef ORIENTED_BOX_H
+#define ORIENTED_BOX_H
+
+#include "Types.h"
+
+class BoundingBox;
+
+// box given by its center, unit axes and half side lengths, used for overlap queries
+struct OrientedBox {
+    // default constructor, an empty box at the origin
+    OrientedBox();
+
+    // constructor from a center, unit axes as columns and half side lengths
+    OrientedBox(const Eigen::Vector3d& center, const Eigen::Matrix3d& axes, const Eigen::Vector3d& halfExtents);
+
+    // takes the box of a bounding box, oriented boxes are read from their orientedPoints
+    explicit OrientedBox(const BoundingBox& boundingBox);
+
+    // returns the box moved by a rigid transform
+    OrientedBox transformed(const Eigen::Isometry3d& transform) const;
+
+    // checks if two boxes overlap with the separating axis test, touching boxes overlap
+    bool overlaps(const OrientedBox& other) const;
+
+    // returns the volume of the box
+    double volume() const { return 8 * halfExtents.prod(); }
+
+    // member variables
+    Eigen::Vector3d center;
+    Eigen::Matrix3d axes;
+    Eigen::Vector3d halfExtents;
+};
+
+#endif
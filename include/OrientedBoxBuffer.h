@@ -0,0 +1,43 @@
+#ifndef ORIENTED_BOX_BUFFER_H
+#define ORIENTED_BOX_BUFFER_H
+
+#include "Types.h"
+#include "OrientedBox.h"
+
+class BoundingBox;
+
+// oriented boxes packed as 15 separate arrays for the SIMD overlap kernels
+class OrientedBoxBuffer {
+public:
+    // returns the number of boxes
+    size_t size() const { return values[0].size(); }
+
+    // checks if the buffer holds no boxes
+    bool empty() const { return values[0].empty(); }
+
+    // resizes the buffer to n boxes
+    void resize(size_t n);
+
+    // removes all boxes
+    void clear();
+
+    // packs a set of bounding boxes into the buffer
+    void assign(const std::vector<BoundingBox>& boxes);
+
+    // appends a box
+    void push_back(const OrientedBox& box);
+
+    // sets box i
+    void set(size_t i, const OrientedBox& box);
+
+    // returns box i
+    OrientedBox get(size_t i) const;
+
+    // fills the pointers to the value arrays in the order the kernels expect
+    void arrays(const double* result[15]) const;
+
+    // center x, y, z, then the x, y, z of each axis in turn, then the three half extents
+    std::vector<double> values[15];
+};
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef POINT_REDUCTION_H
+#define POINT_REDUCTION_H
+
+#include "Types.h"
+#include "PositionBuffer.h"
+
+// Supplies points to the reductions in blocks of separate x, y, z arrays
+class PointSource {
+public:
+    virtual ~PointSource() {}
+
+    // returns the number of points
+    virtual size_t size() const = 0;
+
+    // points x, y and z at the coordinates of points [begin, end), either inside the source or in scratch
+    virtual void block(size_t begin, size_t end, PositionBuffer& scratch,
+                       const double*& x, const double*& y, const double*& z) const = 0;
+};
+
+// Points stored in a position buffer, handed out without copying
+class PositionBufferSource : public PointSource {
+public:
+    // wraps a buffer, which must outlive the source
+    explicit PositionBufferSource(const PositionBuffer& positions) : positions(positions) {}
+
+    size_t size() const override { return positions.size(); }
+
+    void block(size_t begin, size_t end, PositionBuffer& scratch,
+               const double*& x, const double*& y, const double*& z) const override;
+
+private:
+    const PositionBuffer& positions;
+};
+
+// Points stored as rows of x, y, z values of type T with any strides, such as an (N, 3) array viewed
+// from Python. Each block is converted to double in scratch, so the points are never copied as a whole.
+template <typename T>
+class StridedPointSource : public PointSource {
+public:
+    // wraps count rows starting at data, rowStride bytes apart with the coordinates columnStride bytes
+    // apart, the data must outlive the source
+    StridedPointSource(const T* data, size_t count, ptrdiff_t rowStride = 3 * sizeof(T),
+                       ptrdiff_t columnStride = sizeof(T))
+        : data(reinterpret_cast<const char*>(data)), count(count), rowStride(rowStride), columnStride(columnStride) {}
+
+    size_t size() const override { return count; }
+
+    void block(size_t begin, size_t end, PositionBuffer& scratch,
+               const double*& x, const double*& y, const double*& z) const override {
+        scratch.resize(end - begin);
+        for (size_t i = begin; i < end; i++) {
+            const char* row = data + (ptrdiff_t)i * rowStride;
+            scratch.x[i - begin] = (double)*reinterpret_cast<const T*>(row);
+            scratch.y[i - begin] = (double)*reinterpret_cast<const T*>(row + columnStride);
+            scratch.z[i - begin] = (double)*reinterpret_cast<const T*>(row + 2 * columnStride);
+        }
+
+        x = scratch.x.data();
+        y = scratch.y.data();
+        z = scratch.z.data();
+    }
+
+private:
+    const char* data;
+    size_t count;
+    ptrdiff_t rowStride;
+    ptrdiff_t columnStride;
+};
+
+// Count, mean and scatter matrix of a set of points, or area, centroid and second moment of a surface
+struct PointMoments {
+    // zero points
+    PointMoments();
+
+    // combines the moments of two disjoint sets of points (Chan et al.)
+    void merge(const PointMoments& other);
+
+    // returns the covariance matrix, scatter divided by count
+    Eigen::Matrix3d covariance() const { return scatter / count; }
+
+    double count;
+    Eigen::Vector3d mean;
+    Eigen::Matrix3d scatter;
+};
+
+// Reductions over a point source, split in fixed blocks over the thread pool. Blocks are combined in
+// order, so the results do not depend on the thread count.
+class PointReduction {
+public:
+    // computes the count, mean and scatter matrix in a single pass over the points
+    static PointMoments moments(const PointSource& points, int threads = 0);
+
+    // integrates the area, centroid and second moment about the centroid over triangles, three
+    // indices into positions each, count holds the area
+    static PointMoments surfaceMoments(const PositionBuffer& positions, const std::vector<uint32_t>& triangles,
+                                       int threads = 0);
+
+    // computes the per-axis minimum and maximum of the points
+    static void minMax(const PointSource& points, Eigen::Vector3d& min, Eigen::Vector3d& max, int threads = 0);
+
+    // copies the points of a source into a position buffer, for the algorithms that need all points at once
+    static void copy(const PointSource& points, PositionBuffer& positions, int threads = 0);
+
+    // computes the range of the points relative to center projected on the columns of axes
+    static void projectMinMax(const PointSource& points, const Eigen::Vector3d& center, const Eigen::Matrix3d& axes,
+                              Eigen::Vector3d& min, Eigen::Vector3d& max, int threads = 0);
+
+    // number of points per block, small enough for a block to stay in cache between kernels
+    static constexpr size_t blockSize = 16384;
+};
+
+#endif
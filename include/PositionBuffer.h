@@ -0,0 +1,38 @@
+#ifndef POSITION_BUFFER_H
+#define POSITION_BUFFER_H
+
+#include "Types.h"
+
+class PositionBuffer {
+public:
+    // returns the number of points
+    size_t size() const { return x.size(); }
+
+    // checks if the buffer holds no points
+    bool empty() const { return x.empty(); }
+
+    // resizes the buffer to n points
+    void resize(size_t n);
+
+    // removes all points
+    void clear();
+
+    // copies the positions of a set of vertices into the buffer
+    void assign(const std::vector<Vertex>& vertices);
+
+    // appends a point
+    void push_back(const Eigen::Vector3d& p);
+
+    // sets point i
+    void set(size_t i, const Eigen::Vector3d& p) { x[i] = p.x(); y[i] = p.y(); z[i] = p.z(); }
+
+    // returns point i
+    Eigen::Vector3d get(size_t i) const { return Eigen::Vector3d(x[i], y[i], z[i]); }
+
+    // coordinates stored as separate contiguous arrays
+    std::vector<double> x;
+    std::vector<double> y;
+    std::vector<double> z;
+};
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <map>
+
+#include "Types.h"
+
+// totals of one instrumented stage since the profiler was last reset
+struct StageStats {
+    // number of times the stage ran
+    size_t calls = 0;
+
+    // wall time summed over the calls
+    double seconds = 0;
+
+    // elements processed, e.g. faces parsed or points fitted
+    size_t elements = 0;
+
+    // bytes of the arrays the stage allocated
+    size_t bytes = 0;
+};
+
+// stage totals keyed by stage name, e.g. "MeshIO::buildMesh"
+struct ProfileStats {
+    std::map<std::string, StageStats> stages;
+
+    // events held for the trace, and events dropped after the trace buffer filled up
+    size_t traceEvents = 0;
+    size_t droppedEvents = 0;
+};
+
+// Collects the wall time, element counts and allocation sizes of the stages of mesh loading and box
+// fitting, for the totals and as a Chrome trace. Off by default; a disabled stage costs one relaxed
+// atomic load. Building with MESHLIB_NO_PROFILING removes the timers altogether.
+class Profiler {
+public:
+    // starts or stops collecting, collected data is kept
+    static void setEnabled(bool enabled);
+
+    // checks if stages are being collected
+    static bool isEnabled() { return active.load(std::memory_order_relaxed); }
+
+    // returns the totals of every stage that ran since the last reset
+    static ProfileStats stats();
+
+    // drops the totals and the trace events
+    static void reset();
+
+    // writes the events as Chrome trace-event JSON, for chrome://tracing or Perfetto
+    static bool writeChromeTrace(const std::string& fileName);
+
+    // adds a finished stage to the totals and the trace, name must outlive the profiler
+    static void record(const char* name, std::chrono::steady_clock::time_point start,
+                       std::chrono::steady_clock::time_point end, size_t elements, size_t bytes);
+
+    // events kept for the trace, later events are only counted in the totals
+    static constexpr size_t maxTraceEvents = 1 << 20;
+
+private:
+    static std::atomic<bool> active;
+};
+
+#ifndef MESHLIB_NO_PROFILING
+
+// Times the enclosing scope as a profiler stage if the profiler is enabled when the scope is entered
+class ScopedTimer {
+public:
+    // starts timing the stage name, a string literal
+    explicit ScopedTimer(const char* name) : name(Profiler::isEnabled() ? name : nullptr), elements(0), bytes(0) {
+        if (this->name) start = std::chrono::steady_clock::now();
+    }
+
+    // records the stage
+    ~ScopedTimer() {
+        if (name) Profiler::record(name, start, std::chrono::steady_clock::now(), elements, bytes);
+    }
+
+    // counts processed elements
+    void addElements(size_t n) { elements += n; }
+
+    // counts allocated bytes
+    void addBytes(size_t n) { bytes += n; }
+
+    // checks if the stage is recorded, to skip computing counts that would be thrown away
+    bool isActive() const { return name != nullptr; }
+
+private:
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+    size_t elements;
+    size_t bytes;
+};
+
+#else
+
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char*) {}
+    void addElements(size_t) {}
+    void addBytes(size_t) {}
+    bool isActive() const { return false; }
+};
+
+#endif
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "Types.h"
+#include "BoundingBox.h"
+
+// boxes and counts of one mesh, as stored under a cache key
+struct CachedResult {
+    BoundingBox axisAlignedBox;
+    BoundingBox orientedBox;
+    size_t vertexCount = 0;
+    size_t triangleCount = 0;
+};
+
+// Box results kept on disk under a hash of the contents of the mesh file and the parameters of the
+// computation, so unchanged files are not parsed again. Each entry is a small file in the cache
+// directory. When there are more than maxEntries the least recently used entries are removed. Entries
+// are replaced by renaming, so threads and processes can share a directory.
+class ResultCache {
+public:
+    // opens or creates the cache directory and indexes its entries by last use
+    explicit ResultCache(const std::string& directory, size_t maxEntries = 10000);
+
+    // hashes the contents of a file and the parameters of a computation, false if the file cannot be read
+    static bool computeKey(const std::string& fileName, const std::string& parameters, uint64_t& key);
+
+    // reads the entry of a key and marks it as recently used, false on a miss or a damaged entry
+    bool lookup(uint64_t key, CachedResult& result);
+
+    // writes the entry of a key and evicts the least recently used entries beyond the limit
+    bool store(uint64_t key, const CachedResult& result);
+
+    // removes every entry and resets the counters
+    void clear();
+
+    // returns the number of entries
+    size_t size() const;
+
+    // counters since the cache was opened or cleared
+    size_t hits() const { return hitCount; }
+    size_t misses() const { return missCount; }
+    size_t evictions() const { return evictionCount; }
+
+    // returns the cache directory
+    const std::string& directory() const { return root; }
+
+    // entry format version, also part of every key
+    static constexpr uint32_t version = 1;
+
+private:
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // returns the file of an entry
+    std::string entryPath(uint64_t key) const;
+
+    // moves a key to the front of the use order, adding it if needed; call with the mutex held
+    void markUsed(uint64_t key);
+
+    // drops a key from the index; call with the mutex held
+    void forget(uint64_t key);
+
+    // removes the least recently used entries until there are at most capacity; call with the mutex held
+    void evictExcess();
+
+    std::string root;
+    size_t capacity;
+
+    // keys from the most to the least recently used, and the position of every key in that list
+    mutable std::mutex mutex;
+    std::list<uint64_t> useOrder;
+    std::unordered_map<uint64_t, std::list<uint64_t>::iterator> entries;
+
+    std::atomic<size_t> hitCount;
+    std::atomic<size_t> missCount;
+    std::atomic<size_t> evictionCount;
+};
+
+#endif
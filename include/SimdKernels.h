@@ -0,0 +1,56 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Reductions over points stored as separate x, y, z arrays, and box overlap tests over boxes stored
+// the same way. Each kernel has a scalar version and,
+// on x86-64, SSE2 and AVX2 versions; the fastest one supported by the cpu is picked at startup.
+class SimdKernels {
+public:
+    // computes the per-axis minimum and maximum of n points
+    static void minMax(const double* x, const double* y, const double* z, size_t n,
+                       double min[3], double max[3]);
+
+    // computes the per-axis sum of n points
+    static void sum(const double* x, const double* y, const double* z, size_t n, double sum[3]);
+
+    // accumulates the upper triangle (xx, xy, xz, yy, yz, zz) of the scatter matrix about center
+    static void scatter(const double* x, const double* y, const double* z, size_t n,
+                        const double center[3], double scatter[6]);
+
+    // computes the minimum and maximum of the points relative to center projected on three axes,
+    // axes holds the axes one after another
+    static void projectMinMax(const double* x, const double* y, const double* z, size_t n,
+                              const double center[3], const double axes[9], double min[3], double max[3]);
+
+    // integrates area, first and second moments relative to reference over count triangles given as
+    // three point indices each, moments receives area, x, y, z, xx, xy, xz, yy, yz, zz
+    static void surfaceMoments(const double* x, const double* y, const double* z, const uint32_t* triangles,
+                               size_t count, const double reference[3], double moments[10]);
+
+    // finds the first points with the least and the greatest projection on each of the first count (3, 7
+    // or 13) DiTO directions: the coordinate axes, the cube diagonals (1, ±1, ±1) and the face diagonals;
+    // reads one group of eight points in every step, and the last n % 8 points
+    static void extremalIndices(const double* x, const double* y, const double* z, size_t n,
+                                int count, size_t step, size_t* minIndex, size_t* maxIndex);
+
+    // tests one box against n boxes with the separating axis test, result[i] is 1 if they overlap; a box
+    // is packed as 15 values (center, the three axes one after another, half extents) and boxes holds
+    // one array per value
+    static void boxOverlaps(const double box[15], const double* const boxes[15], size_t n, uint8_t* result);
+
+    // tests n pairs of boxes, pairs holds an index into a and an index into b per pair
+    static void boxPairOverlaps(const double* const a[15], const double* const b[15], const uint32_t* pairs,
+                                size_t n, uint8_t* result);
+
+    // returns the instruction set in use: "avx2", "sse2" or "scalar"
+    static std::string instructionSet();
+
+    // selects an instruction set, returns false if the cpu does not support it
+    static bool setInstructionSet(const std::string& name);
+};
+
+#endif
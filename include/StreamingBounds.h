@@ -0,0 +1,35 @@
+#ifndef STREAMING_BOUNDS_H
+#define STREAMING_BOUNDS_H
+
+#include "Types.h"
+
+class BoundingBox;
+
+// Boxes of the positions of an obj file, accumulated while streaming its v records through a small
+// block buffer. No mesh is built, so faces are neither read nor validated. Positions are normalized to
+// the unit sphere like Mesh::read does, so the boxes match those of the loaded mesh.
+class StreamingBounds {
+public:
+    // computes the axis-aligned box of the normalized positions of an obj file in two passes
+    static bool computeAxisAlignedBox(const std::string& fileName, BoundingBox& box, int threads = 0);
+
+    // computes the principal component box of the normalized positions of an obj file in two passes
+    static bool computeOrientedBox(const std::string& fileName, BoundingBox& box, int threads = 0);
+
+    // computes both boxes in the same two passes
+    static bool computeBoxes(const std::string& fileName, BoundingBox& axisAlignedBox, BoundingBox& orientedBox,
+                             int threads = 0);
+
+    // number of positions parsed into the buffer at a time
+    static constexpr size_t blockSize = 4096;
+
+    // bytes of the file per parallel task, fixed so that the result does not depend on the thread count
+    static constexpr size_t chunkSize = 1 << 20;
+
+private:
+    // streams the file twice and fills the boxes that are not null
+    static bool streamBoxes(const std::string& fileName, int threads, BoundingBox* axisAlignedBox,
+                            BoundingBox* orientedBox);
+};
+
+#endif
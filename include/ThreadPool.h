@@ -0,0 +1,68 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+public:
+    // starts numThreads workers, 0 uses the hardware concurrency
+    explicit ThreadPool(int numThreads = 0);
+
+    // finishes queued tasks and joins the workers
+    ~ThreadPool();
+
+    // returns the number of workers
+    int size() const { return (int)workers.size(); }
+
+    // queues a task and returns a future holding its result
+    template <typename F>
+    std::future<typename std::invoke_result<F>::type> submit(F&& f);
+
+    // runs body(i) for every i in [0, n) on at most maxThreads threads (0 for all), the caller takes part;
+    // the first exception thrown by body is rethrown on the caller after the other threads stop
+    void parallelFor(size_t n, const std::function<void(size_t)>& body, int maxThreads = 0);
+
+    // returns the number of threads to use for a requested count, 0 meaning all hardware threads
+    static int resolveThreadCount(int threads);
+
+    // returns the pool shared by the library
+    static ThreadPool& global();
+
+private:
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // adds a task to the queue
+    void enqueue(std::function<void()> task);
+
+    // runs queued tasks until the pool is destroyed
+    void workerLoop();
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping;
+};
+
+template <typename F>
+std::future<typename std::invoke_result<F>::type> ThreadPool::submit(F&& f)
+{
+    typedef typename std::invoke_result<F>::type Result;
+
+    std::shared_ptr<std::packaged_task<Result()>> task =
+        std::make_shared<std::packaged_task<Result()>>(std::forward<F>(f));
+    std::future<Result> result = task->get_future();
+    enqueue([task]() { (*task)(); });
+
+    return result;
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define TYPES_H
 
 #include <stdlib.h>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -17,6 +18,15 @@ class HalfEdge;
 class Mesh;
 class MeshIO;
 
+// connectivity is stored as 32-bit indices into the element arrays of a Mesh
+typedef uint32_t HalfEdgeId;
+typedef uint32_t VertexId;
+typedef uint32_t EdgeId;
+typedef uint32_t FaceId;
+
+// marks a missing element, e.g. the halfedge of an isolated vertex or a halfedge without uv
+const uint32_t InvalidId = 0xffffffff;
+
 typedef std::vector<HalfEdge>::iterator HalfEdgeIter;
 typedef std::vector<HalfEdge>::const_iterator HalfEdgeCIter;
 typedef std::vector<Vertex>::iterator VertexIter;
@@ -5,15 +5,15 @@
 
 class Vertex {
 public:
-    // outgoing halfedge
-    HalfEdgeIter he;
-    
-    // location in 3d
-    Eigen::Vector3d position;
+    // outgoing halfedge, InvalidId if the vertex is isolated
+    HalfEdgeId he;
     
     // id between 0 and |V|-1
     int index;
     
+    // location in 3d
+    Eigen::Vector3d position;
+    
     // checks if vertex is contained in any edge or face
     bool isIsolated() const;
 };
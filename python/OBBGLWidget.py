@@ -2,6 +2,7 @@
 # -*- coding: utf-8 -*-
 
 import sys
+import numpy as np
 import _meshlib
 from PySide2.QtWidgets import QApplication, QOpenGLWidget
 from PySide2.QtGui import QOpenGLFunctions
@@ -69,6 +70,9 @@ class OBBGLWidget(QOpenGLWidget, QOpenGLFunctions):
 
     def loadMesh(self):
         self.mesh.read(self.mesh_file)
+        # OpenGL needs tightly packed arrays, the edge list is already packed
+        self.positions = np.ascontiguousarray(self.mesh.positions)
+        self.edgeVertices = self.mesh.edgeVertices
         self.computeBoundingBox()
 
     def computeBoundingBox(self):
@@ -159,25 +163,11 @@ class OBBGLWidget(QOpenGLWidget, QOpenGLFunctions):
     def drawFaces(self):
         glColor4f(0.0, 0.0, 1.0, 0.6)  # Set color for the faces
 
-        for face in self.mesh.faces:
-            if face.isBoundary:  # Skip boundary faces if any
-                continue
-
-            glBegin(GL_LINE_LOOP)  # Start drawing a face
-
-            half_edge = face.he   # Get the starting half edge of the face
-            start_he = half_edge  # Remember the start to detect loop end
-
-            while True:
-                glVertex3d(half_edge.vertex.position[0],
-                           half_edge.vertex.position[1],
-                           half_edge.vertex.position[2])
-
-                half_edge = half_edge.next  # Move to the next half edge
-                if half_edge == start_he:
-                    break
-
-            glEnd()
+        # every face outline is made of mesh edges, so drawing the edges draws the wireframe in one call
+        glEnableClientState(GL_VERTEX_ARRAY)
+        glVertexPointer(3, GL_DOUBLE, 0, self.positions)
+        glDrawElements(GL_LINES, self.edgeVertices.size, GL_UNSIGNED_INT, self.edgeVertices)
+        glDisableClientState(GL_VERTEX_ARRAY)
 
     def drawBoundingBox(self):
         if self.drawAABB:
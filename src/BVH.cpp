@@ -0,0 +1,454 @@
+#include "BVH.h"
+
+#include "BoundingBox.h"
+#include "Diagnostics.h"
+#include "Mesh.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+// number of queries per task of the batch queries
+const size_t queryBlockSize = 64;
+
+// surface area of a box
+double surfaceArea(const BoundingBox& box) {
+    const Eigen::Vector3d& e = box.extent;
+    return 2 * (e.x() * e.y() + e.x() * e.z() + e.y() * e.z());
+}
+
+// box of a bin, empty until the first triangle is added
+struct Bin {
+    BoundingBox bounds;
+    uint32_t count = 0;
+
+    void add(const BoundingBox& box) {
+        if (count++ == 0) bounds = box;
+        else bounds.expandToInclude(box);
+    }
+};
+
+class BVHBuilder {
+public:
+    BVHBuilder(const PositionBuffer& positions, const std::vector<uint32_t>& triangles, std::vector<uint32_t>& order,
+               std::vector<BVHNode>& nodes);
+
+    // builds the subtree over order[begin, end) and returns the index of its root
+    uint32_t build(uint32_t begin, uint32_t end, int depth);
+
+private:
+    // chooses the split of order[begin, end) with the binned surface area heuristic and partitions
+    // the triangles, returns end if a leaf is cheaper
+    uint32_t split(uint32_t begin, uint32_t end, const BoundingBox& bounds);
+
+    std::vector<uint32_t>& order;
+    std::vector<BVHNode>& nodes;
+    std::vector<BoundingBox> triangleBounds;
+    std::vector<Eigen::Vector3d> centroids;
+};
+
+BVHBuilder::BVHBuilder(const PositionBuffer& positions, const std::vector<uint32_t>& triangles,
+                       std::vector<uint32_t>& order, std::vector<BVHNode>& nodes)
+    : order(order), nodes(nodes), triangleBounds(triangles.size() / 3), centroids(triangles.size() / 3) {
+    for (size_t t = 0; t < centroids.size(); t++) {
+        triangleBounds[t] = BoundingBox(positions.get(triangles[3*t]));
+        triangleBounds[t].expandToInclude(positions.get(triangles[3*t + 1]));
+        triangleBounds[t].expandToInclude(positions.get(triangles[3*t + 2]));
+        centroids[t] = (triangleBounds[t].min + triangleBounds[t].max) / 2;
+    }
+}
+
+uint32_t BVHBuilder::build(uint32_t begin, uint32_t end, int depth) {
+    uint32_t index = (uint32_t)nodes.size();
+    nodes.push_back(BVHNode());
+
+    BoundingBox bounds = triangleBounds[order[begin]];
+    for (uint32_t i = begin + 1; i < end; i++) bounds.expandToInclude(triangleBounds[order[i]]);
+
+    // round outwards so that the float box still encloses the triangles
+    BVHNode& node = nodes[index];
+    for (int k = 0; k < 3; k++) {
+        node.min[k] = std::nextafter((float)bounds.min[k], -INFINITY);
+        node.max[k] = std::nextafter((float)bounds.max[k], INFINITY);
+    }
+
+    uint32_t middle = depth < BVH::maxDepth ? split(begin, end, bounds) : end;
+    if (middle == end) {
+        nodes[index].offset = begin;
+        nodes[index].count = end - begin;
+        return index;
+    }
+
+    build(begin, middle, depth + 1);
+    uint32_t right = build(middle, end, depth + 1);
+    nodes[index].offset = right;
+    nodes[index].count = 0;
+
+    return index;
+}
+
+uint32_t BVHBuilder::split(uint32_t begin, uint32_t end, const BoundingBox& bounds) {
+    uint32_t count = end - begin;
+    if (count <= 1) return end;
+
+    BoundingBox centroidBounds(centroids[order[begin]]);
+    for (uint32_t i = begin + 1; i < end; i++) centroidBounds.expandToInclude(centroids[order[i]]);
+
+    int axis = centroidBounds.maxDimension();
+    double lo = centroidBounds.min[axis], width = centroidBounds.extent[axis];
+
+    // all centroids coincide, halve the triangles if there are too many for a leaf
+    if (width <= 0) {
+        return count <= BVH::maxLeafSize ? end : begin + count / 2;
+    }
+
+    auto binOf = [&](uint32_t t) {
+        int b = (int)(BVH::binCount * (centroids[t][axis] - lo) / width);
+        return std::min(b, BVH::binCount - 1);
+    };
+
+    Bin bins[BVH::binCount];
+    for (uint32_t i = begin; i < end; i++) bins[binOf(order[i])].add(triangleBounds[order[i]]);
+
+    // area times count of the boxes left of each boundary, swept from the left and the right
+    double leftCost[BVH::binCount], rightCost[BVH::binCount];
+    Bin left, right;
+    for (int b = 0; b < BVH::binCount - 1; b++) {
+        if (bins[b].count > 0) {
+            if (left.count == 0) left.bounds = bins[b].bounds;
+            else left.bounds.expandToInclude(bins[b].bounds);
+            left.count += bins[b].count;
+        }
+        leftCost[b] = left.count > 0 ? left.count * surfaceArea(left.bounds) : 0;
+
+        int r = BVH::binCount - 1 - b;
+        if (bins[r].count > 0) {
+            if (right.count == 0) right.bounds = bins[r].bounds;
+            else right.bounds.expandToInclude(bins[r].bounds);
+            right.count += bins[r].count;
+        }
+        rightCost[r - 1] = right.count > 0 ? right.count * surfaceArea(right.bounds) : 0;
+    }
+
+    // one traversal step plus the expected number of triangle tests
+    int best = 0;
+    for (int b = 1; b < BVH::binCount - 1; b++) {
+        if (leftCost[b] + rightCost[b] < leftCost[best] + rightCost[best]) best = b;
+    }
+    double area = surfaceArea(bounds);
+    double splitCost = 1 + (area > 0 ? (leftCost[best] + rightCost[best]) / area : count);
+    if (splitCost >= count && count <= BVH::maxLeafSize) return end;
+
+    uint32_t* middle = std::partition(order.data() + begin, order.data() + end,
+                                      [&](uint32_t t) { return binOf(t) <= best; });
+    return (uint32_t)(middle - order.data());
+}
+
+// entry distance of a ray into a node box, infinity on a miss or beyond limit; slabs the ray runs
+// inside produce NaN, which the comparisons ignore
+inline double enterBox(const BVHNode& node, const Eigen::Vector3d& origin, const Eigen::Vector3d& inverse,
+                       double limit) {
+    double near = 0, far = limit;
+    for (int k = 0; k < 3; k++) {
+        double t0 = (node.min[k] - origin[k]) * inverse[k];
+        double t1 = (node.max[k] - origin[k]) * inverse[k];
+        near = std::max(near, std::min(t0, t1));
+        far = std::min(far, std::max(t0, t1));
+    }
+
+    return near <= far ? near : INFINITY;
+}
+
+// squared distance from a point to a node box
+inline double boxDistance2(const BVHNode& node, const Eigen::Vector3d& p) {
+    double d2 = 0;
+    for (int k = 0; k < 3; k++) {
+        double d = std::max({(double)node.min[k] - p[k], 0.0, p[k] - (double)node.max[k]});
+        d2 += d * d;
+    }
+
+    return d2;
+}
+
+// Moller-Trumbore ray triangle intersection, both sides count
+inline bool intersectTriangle(const Eigen::Vector3d* c, const Eigen::Vector3d& origin,
+                              const Eigen::Vector3d& direction, double& t, double& u, double& v) {
+    Eigen::Vector3d e1 = c[1] - c[0], e2 = c[2] - c[0];
+    Eigen::Vector3d p = direction.cross(e2);
+    double det = e1.dot(p);
+    if (det == 0) return false;
+
+    double inverse = 1 / det;
+    Eigen::Vector3d s = origin - c[0];
+    u = s.dot(p) * inverse;
+    if (u < 0 || u > 1) return false;
+
+    Eigen::Vector3d q = s.cross(e1);
+    v = direction.dot(q) * inverse;
+    if (v < 0 || u + v > 1) return false;
+
+    t = e2.dot(q) * inverse;
+    return t >= 0;
+}
+
+// point of a triangle nearest to p, by the Voronoi region of p
+Eigen::Vector3d closestOnTriangle(const Eigen::Vector3d& p, const Eigen::Vector3d& a, const Eigen::Vector3d& b,
+                                  const Eigen::Vector3d& c) {
+    Eigen::Vector3d ab = b - a, ac = c - a, ap = p - a;
+    double d1 = ab.dot(ap), d2 = ac.dot(ap);
+    if (d1 <= 0 && d2 <= 0) return a;
+
+    Eigen::Vector3d bp = p - b;
+    double d3 = ab.dot(bp), d4 = ac.dot(bp);
+    if (d3 >= 0 && d4 <= d3) return b;
+
+    double vc = d1 * d4 - d3 * d2;
+    if (vc <= 0 && d1 >= 0 && d3 <= 0) return a + ab * (d1 / (d1 - d3));
+
+    Eigen::Vector3d cp = p - c;
+    double d5 = ab.dot(cp), d6 = ac.dot(cp);
+    if (d6 >= 0 && d5 <= d6) return c;
+
+    double vb = d5 * d2 - d1 * d6;
+    if (vb <= 0 && d2 >= 0 && d6 <= 0) return a + ac * (d2 / (d2 - d6));
+
+    double va = d3 * d6 - d5 * d4;
+    if (va <= 0 && d4 - d3 >= 0 && d5 - d6 >= 0) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    double denominator = va + vb + vc;
+    if (denominator == 0) return a;
+    return a + ab * (vb / denominator) + ac * (vc / denominator);
+}
+
+// node waiting on the traversal stack with a lower bound of its distance
+struct StackEntry {
+    uint32_t node;
+    double bound;
+};
+
+} // namespace
+
+/**
+ * Functionality: Creates an empty hierarchy.
+ */
+BVH::BVH() {}
+
+/**
+ * Functionality: Builds the hierarchy over the triangles of a mesh, faces with more than three
+ * sides are split into fans as in Mesh::triangles.
+ * Parameter:
+ *     mesh: const Mesh&, the mesh.
+ * Returns:
+ *     bool: Returns true if the hierarchy was built, false if the mesh has no triangles.
+ */
+bool BVH::build(const Mesh& mesh) {
+    return build(mesh.positions, mesh.triangles);
+}
+
+/**
+ * Functionality: Builds the hierarchy top down. The centroids of a node are sorted into binCount
+ * bins along the longest axis of their bounds, and the node is split at the bin boundary with the
+ * lowest surface area cost. A node becomes a leaf when no split is cheaper than testing all of its
+ * triangles and it holds at most maxLeafSize, or when it reaches maxDepth.
+ * Parameter:
+ *     positions: const PositionBuffer&, the triangle corners.
+ *     triangles: const std::vector<uint32_t>&, three indices into positions per triangle.
+ * Returns:
+ *     bool: Returns true if the hierarchy was built, false if there are no triangles or an index is
+ *           out of range, in which case the hierarchy is left empty.
+ */
+bool BVH::build(const PositionBuffer& positions, const std::vector<uint32_t>& triangles) {
+    clear();
+
+    uint32_t count = (uint32_t)(triangles.size() / 3);
+    if (count == 0) return false;
+
+    for (uint32_t index : triangles) {
+        if (index >= positions.size()) {
+            Log::write(LogError, "triangle index " + std::to_string(index) + " is out of range");
+            return false;
+        }
+    }
+
+    triangleIndices.resize(count);
+    std::iota(triangleIndices.begin(), triangleIndices.end(), 0);
+    nodes.reserve(2 * (size_t)count);
+
+    BVHBuilder builder(positions, triangles, triangleIndices, nodes);
+    builder.build(0, count, 0);
+
+    corners.resize(3 * (size_t)count);
+    for (uint32_t t = 0; t < count; t++) {
+        for (int k = 0; k < 3; k++) corners[3*t + k] = positions.get(triangles[3*triangleIndices[t] + k]);
+    }
+
+    return true;
+}
+
+/**
+ * Functionality: Finds the nearest intersection of a ray with the triangles. Children are visited
+ * near first, and nodes that the ray enters beyond the nearest hit so far are skipped.
+ * Parameter:
+ *     origin: const Eigen::Vector3d&, the origin of the ray.
+ *     direction: const Eigen::Vector3d&, the direction of the ray, not necessarily unit.
+ *     hit: RayHit&, receives the nearest hit, its triangle is InvalidId on a miss.
+ *     maxDistance: double, hits with a larger ray parameter are ignored.
+ * Returns:
+ *     bool: Returns true if the ray hits a triangle.
+ */
+bool BVH::raycast(const Eigen::Vector3d& origin, const Eigen::Vector3d& direction, RayHit& hit,
+                  double maxDistance) const {
+    hit = RayHit{maxDistance, InvalidId, 0, 0};
+    if (nodes.empty()) return false;
+
+    // the node boxes are rounded outwards, the slab test runs in double so the ray cannot slip
+    // past a triangle that touches its box
+    Eigen::Vector3d inverse = direction.cwiseInverse();
+
+    StackEntry stack[maxDepth + 1];
+    int size = 0;
+    if (enterBox(nodes[0], origin, inverse, hit.distance) < INFINITY) stack[size++] = StackEntry{0, 0};
+
+    while (size > 0) {
+        StackEntry entry = stack[--size];
+        if (entry.bound > hit.distance) continue;
+
+        const BVHNode& node = nodes[entry.node];
+        if (node.count > 0) {
+            for (uint32_t t = node.offset; t < node.offset + node.count; t++) {
+                double distance, u, v;
+                if (intersectTriangle(&corners[3*t], origin, direction, distance, u, v) && distance < hit.distance) {
+                    hit = RayHit{distance, triangleIndices[t], u, v};
+                }
+            }
+            continue;
+        }
+
+        uint32_t near = entry.node + 1, far = node.offset;
+        double tNear = enterBox(nodes[near], origin, inverse, hit.distance);
+        double tFar = enterBox(nodes[far], origin, inverse, hit.distance);
+        if (tFar < tNear) {
+            std::swap(near, far);
+            std::swap(tNear, tFar);
+        }
+
+        if (tFar < INFINITY) stack[size++] = StackEntry{far, tFar};
+        if (tNear < INFINITY) stack[size++] = StackEntry{near, tNear};
+    }
+
+    return hit.triangle != InvalidId;
+}
+
+/**
+ * Functionality: Casts a batch of rays. Blocks of rays are distributed over the threads.
+ * Parameter:
+ *     origins: const PositionBuffer&, the origin of each ray.
+ *     directions: const PositionBuffer&, the direction of each ray.
+ *     hits: std::vector<RayHit>&, receives the nearest hit of each ray.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ *     maxDistance: double, hits with a larger ray parameter are ignored.
+ * Returns:
+ *     bool: Returns false if the numbers of origins and directions differ.
+ */
+bool BVH::raycast(const PositionBuffer& origins, const PositionBuffer& directions, std::vector<RayHit>& hits,
+                  int threads, double maxDistance) const {
+    if (origins.size() != directions.size()) {
+        Log::write(LogError, std::to_string(origins.size()) + " ray origins but " +
+                                 std::to_string(directions.size()) + " directions");
+        return false;
+    }
+
+    size_t n = origins.size();
+    hits.resize(n);
+    ThreadPool::global().parallelFor((n + queryBlockSize - 1) / queryBlockSize, [&](size_t b) {
+        for (size_t i = b * queryBlockSize; i < std::min(n, (b + 1) * queryBlockSize); i++) {
+            raycast(origins.get(i), directions.get(i), hits[i], maxDistance);
+        }
+    }, ThreadPool::resolveThreadCount(threads));
+
+    return true;
+}
+
+/**
+ * Functionality: Finds the point on the triangles nearest to a point. Children are visited near
+ * first, and nodes farther than the nearest point so far are skipped.
+ * Parameter:
+ *     point: const Eigen::Vector3d&, the query point.
+ *     result: ClosestPoint&, receives the nearest point, its triangle is InvalidId if none is in range.
+ *     maxDistance: double, points farther away are ignored.
+ * Returns:
+ *     bool: Returns true if a point was found.
+ */
+bool BVH::closestPoint(const Eigen::Vector3d& point, ClosestPoint& result, double maxDistance) const {
+    result = ClosestPoint{point, maxDistance, InvalidId};
+    if (nodes.empty()) return false;
+
+    double best2 = maxDistance * maxDistance;
+    StackEntry stack[maxDepth + 1];
+    int size = 0;
+    stack[size++] = StackEntry{0, boxDistance2(nodes[0], point)};
+
+    while (size > 0) {
+        StackEntry entry = stack[--size];
+        if (entry.bound > best2) continue;
+
+        const BVHNode& node = nodes[entry.node];
+        if (node.count > 0) {
+            for (uint32_t t = node.offset; t < node.offset + node.count; t++) {
+                const Eigen::Vector3d* c = &corners[3*t];
+                Eigen::Vector3d q = closestOnTriangle(point, c[0], c[1], c[2]);
+                double d2 = (q - point).squaredNorm();
+                if (d2 < best2) {
+                    best2 = d2;
+                    result.point = q;
+                    result.triangle = triangleIndices[t];
+                }
+            }
+            continue;
+        }
+
+        uint32_t near = entry.node + 1, far = node.offset;
+        double dNear = boxDistance2(nodes[near], point), dFar = boxDistance2(nodes[far], point);
+        if (dFar < dNear) {
+            std::swap(near, far);
+            std::swap(dNear, dFar);
+        }
+
+        if (dFar <= best2) stack[size++] = StackEntry{far, dFar};
+        if (dNear <= best2) stack[size++] = StackEntry{near, dNear};
+    }
+
+    if (result.triangle == InvalidId) return false;
+    result.distance = std::sqrt(best2);
+    return true;
+}
+
+/**
+ * Functionality: Finds the closest points of a batch of points. Blocks of points are distributed
+ * over the threads.
+ * Parameter:
+ *     points: const PositionBuffer&, the query points.
+ *     results: std::vector<ClosestPoint>&, receives the closest point of each query point.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ */
+void BVH::closestPoints(const PositionBuffer& points, std::vector<ClosestPoint>& results, int threads) const {
+    size_t n = points.size();
+    results.resize(n);
+    ThreadPool::global().parallelFor((n + queryBlockSize - 1) / queryBlockSize, [&](size_t b) {
+        for (size_t i = b * queryBlockSize; i < std::min(n, (b + 1) * queryBlockSize); i++) {
+            closestPoint(points.get(i), results[i]);
+        }
+    }, ThreadPool::resolveThreadCount(threads));
+}
+
+/**
+ * Functionality: Removes the hierarchy.
+ */
+void BVH::clear() {
+    nodes.clear();
+    corners.clear();
+    triangleIndices.clear();
+}
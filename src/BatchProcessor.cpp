@@ -0,0 +1,253 @@
+#include "BatchProcessor.h"
+
+#include "Diagnostics.h"
+#include "Json.h"
+#include "Mesh.h"
+#include "ResultCache.h"
+#include "ThreadPool.h"
+
+#include <chrono>
+#include <deque>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// milliseconds since start
+double milliseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// command line names of the oriented box methods, in enum order
+const char* const methodNames[] = {"pca", "hull-pca", "min-volume", "surface-pca", "hull-surface-pca",
+                                   "dito-14", "dito-26"};
+
+// quotes a string for CSV if it contains a separator, quote or line break
+std::string csvString(const std::string& s) {
+    if (s.find_first_of(",\"\n\r") == std::string::npos) return s;
+
+    std::string quoted = "\"";
+    for (char c : s) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+
+    return quoted + "\"";
+}
+
+// writes a vector as a JSON array
+void writeJsonVector(std::ostream& out, const Eigen::Vector3d& v) {
+    out << '[' << v.x() << ',' << v.y() << ',' << v.z() << ']';
+}
+
+// formats a timing with microsecond resolution
+std::string formatMilliseconds(double ms) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3) << ms;
+
+    return out.str();
+}
+
+// writes the coordinates of a vector as CSV fields
+void writeCsvVector(std::ostream& out, const Eigen::Vector3d& v) {
+    out << ',' << v.x() << ',' << v.y() << ',' << v.z();
+}
+
+} // namespace
+
+/**
+ * Functionality: Processes a list of meshes on a pool of worker threads, one mesh per worker. At
+ * most maxInFlight meshes are queued or being processed at a time, so memory stays bounded however
+ * long the list is. Records are written as soon as all meshes before them are done, in input order.
+ * Parameter:
+ *     paths: const std::vector<std::string>&, the mesh files.
+ *     options: const BatchOptions&, the thread count, output format, method and in flight limit.
+ *     out: std::ostream&, receives the header and one record per mesh.
+ * Returns:
+ *     size_t: The number of meshes that could not be processed.
+ */
+size_t BatchProcessor::run(const std::vector<std::string>& paths, const BatchOptions& options, std::ostream& out) {
+    int threads = ThreadPool::resolveThreadCount(options.threads);
+    size_t maxInFlight = options.maxInFlight > 0 ? options.maxInFlight : 2 * (size_t)threads;
+
+    ThreadPool pool(threads);
+    std::deque<std::future<BatchResult>> inFlight;
+    size_t failures = 0;
+
+    auto finishOldest = [&]() {
+        BatchResult result = inFlight.front().get();
+        inFlight.pop_front();
+        if (!result.success) failures++;
+        writeRecord(out, options.format, result);
+    };
+
+    writeHeader(out, options.format);
+    for (const std::string& path : paths) {
+        if (inFlight.size() >= maxInFlight) finishOldest();
+
+        OrientedBoxMethod method = options.method;
+        ResultCache* cache = options.cache;
+        inFlight.push_back(pool.submit([path, method, cache]() { return process(path, method, cache); }));
+    }
+    while (!inFlight.empty()) finishOldest();
+
+    out.flush();
+    return failures;
+}
+
+/**
+ * Functionality: Loads a mesh and fits its axis-aligned and oriented boxes on the calling thread. With a
+ * cache the file is hashed first, and on a hit the stored result is returned without parsing the mesh.
+ * Parameter:
+ *     path: const std::string&, the mesh file.
+ *     method: OrientedBoxMethod, the algorithm of the oriented box.
+ *     cache: ResultCache*, the result cache, null for none.
+ * Returns:
+ *     BatchResult: The boxes and timings, or success set to false and the reason in error.
+ */
+BatchResult BatchProcessor::process(const std::string& path, OrientedBoxMethod method, ResultCache* cache) {
+    BatchResult result;
+    result.path = path;
+
+    try {
+        Clock::time_point start = Clock::now();
+        uint64_t key = 0;
+        bool keyed = cache && ResultCache::computeKey(path, std::string("mesh ") + methodNames[method], key);
+
+        CachedResult entry;
+        if (keyed && cache->lookup(key, entry)) {
+            result.loadMilliseconds = milliseconds(start);
+            result.axisAlignedBox = entry.axisAlignedBox;
+            result.orientedBox = OrientedBox(entry.orientedBox);
+            result.vertexCount = entry.vertexCount;
+            result.faceCount = entry.triangleCount;
+            result.success = true;
+            return result;
+        }
+
+        // the boxes do not depend on the validation, so it only runs when its warnings would be seen
+        Mesh mesh;
+        if (!mesh.read(path, 1, Log::isEnabled(LogWarning))) {
+            result.error = mesh.diagnostics.hasErrors() ? mesh.diagnostics.summary() : "could not read mesh";
+            return result;
+        }
+        result.loadMilliseconds = milliseconds(start);
+
+        start = Clock::now();
+        result.axisAlignedBox.computeAxisAlignedBox(mesh.positions, 1);
+
+        BoundingBox orientedBox;
+        orientedBox.computeOrientedBox(mesh.positions, mesh.triangles, method, 1);
+        result.orientedBox = OrientedBox(orientedBox);
+        result.fitMilliseconds = milliseconds(start);
+
+        result.vertexCount = mesh.positions.size();
+        result.faceCount = mesh.triangles.size() / 3;
+        result.success = true;
+
+        if (keyed) {
+            entry.axisAlignedBox = result.axisAlignedBox;
+            entry.orientedBox = orientedBox;
+            entry.vertexCount = result.vertexCount;
+            entry.triangleCount = result.faceCount;
+            cache->store(key, entry);
+        }
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+
+    return result;
+}
+
+/**
+ * Functionality: Writes the header of an output format. JSON Lines has none.
+ * Parameter:
+ *     out: std::ostream&, the output.
+ *     format: const std::string&, "jsonl" or "csv".
+ */
+void BatchProcessor::writeHeader(std::ostream& out, const std::string& format) {
+    if (format != "csv") return;
+
+    out << "path,ok,vertices,triangles"
+        << ",aabb_min_x,aabb_min_y,aabb_min_z,aabb_max_x,aabb_max_y,aabb_max_z"
+        << ",obb_center_x,obb_center_y,obb_center_z";
+    for (int i = 0; i < 3; i++) out << ",obb_axis" << i << "_x,obb_axis" << i << "_y,obb_axis" << i << "_z";
+    out << ",obb_half_extent_x,obb_half_extent_y,obb_half_extent_z,load_ms,fit_ms,error\n";
+}
+
+/**
+ * Functionality: Writes the record of one mesh. Coordinates are written with full precision, a failed
+ * mesh only gets its path and error.
+ * Parameter:
+ *     out: std::ostream&, the output.
+ *     format: const std::string&, "jsonl" or "csv".
+ *     result: const BatchResult&, the result of the mesh.
+ */
+void BatchProcessor::writeRecord(std::ostream& out, const std::string& format, const BatchResult& result) {
+    std::ostringstream line;
+    line << std::setprecision(std::numeric_limits<double>::max_digits10);
+
+    const OrientedBox& obb = result.orientedBox;
+    if (format == "csv") {
+        line << csvString(result.path) << ',' << (result.success ? "true" : "false");
+        if (result.success) {
+            line << ',' << result.vertexCount << ',' << result.faceCount;
+            writeCsvVector(line, result.axisAlignedBox.min);
+            writeCsvVector(line, result.axisAlignedBox.max);
+            writeCsvVector(line, obb.center);
+            for (int i = 0; i < 3; i++) writeCsvVector(line, obb.axes.col(i));
+            writeCsvVector(line, obb.halfExtents);
+            line << ',' << formatMilliseconds(result.loadMilliseconds) << ','
+                 << formatMilliseconds(result.fitMilliseconds) << ',';
+        } else {
+            line << std::string(26, ',') << csvString(result.error);
+        }
+    } else {
+        line << "{\"path\":" << Json::quote(result.path) << ",\"ok\":" << (result.success ? "true" : "false");
+        if (result.success) {
+            line << ",\"vertices\":" << result.vertexCount << ",\"triangles\":" << result.faceCount;
+            line << ",\"aabb\":{\"min\":";
+            writeJsonVector(line, result.axisAlignedBox.min);
+            line << ",\"max\":";
+            writeJsonVector(line, result.axisAlignedBox.max);
+            line << "},\"obb\":{\"center\":";
+            writeJsonVector(line, obb.center);
+            line << ",\"axes\":[";
+            for (int i = 0; i < 3; i++) {
+                if (i > 0) line << ',';
+                writeJsonVector(line, obb.axes.col(i));
+            }
+            line << "],\"halfExtents\":";
+            writeJsonVector(line, obb.halfExtents);
+            line << "},\"load_ms\":" << formatMilliseconds(result.loadMilliseconds)
+                 << ",\"fit_ms\":" << formatMilliseconds(result.fitMilliseconds);
+        } else {
+            line << ",\"error\":" << Json::quote(result.error);
+        }
+        line << '}';
+    }
+
+    out << line.str() << '\n';
+}
+
+/**
+ * Functionality: Looks up an oriented box method by its command line name.
+ * Parameter:
+ *     name: const std::string&, the name.
+ *     method: OrientedBoxMethod&, receives the method.
+ * Returns:
+ *     bool: Returns false if the name is unknown, method is then left unchanged.
+ */
+bool BatchProcessor::parseMethod(const std::string& name, OrientedBoxMethod& method) {
+    for (int i = 0; i <= DiTO26; i++) {
+        if (name == methodNames[i]) {
+            method = (OrientedBoxMethod)i;
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -1,9 +1,170 @@
 #include <iostream>
 #include <iomanip>
+#include <sstream>
 #include "BoundingBox.h"
 
 #include "Eigen/Eigenvalues"
 #include "Vertex.h"
+#include "PointReduction.h"
+#include "ConvexHull.h"
+#include "Diagnostics.h"
+#include "Profiler.h"
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <array>
+
+namespace {
+
+// returns the convex hull of 2d points, counterclockwise without collinear points (Andrew's monotone chain)
+std::vector<Eigen::Vector2d> convexHull2d(std::vector<Eigen::Vector2d> points) {
+    std::sort(points.begin(), points.end(), [](const Eigen::Vector2d& a, const Eigen::Vector2d& b) {
+        return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+    });
+
+    auto cross = [](const Eigen::Vector2d& o, const Eigen::Vector2d& a, const Eigen::Vector2d& b) {
+        return (a.x() - o.x()) * (b.y() - o.y()) - (a.y() - o.y()) * (b.x() - o.x());
+    };
+
+    size_t n = points.size(), k = 0;
+    if (n < 3) return points;
+
+    std::vector<Eigen::Vector2d> hull(2 * n);
+    for (size_t i = 0; i < n; i++) {
+        while (k >= 2 && cross(hull[k - 2], hull[k - 1], points[i]) <= 0) k--;
+        hull[k++] = points[i];
+    }
+    for (size_t i = n - 1, lower = k + 1; i > 0; i--) {
+        while (k >= lower && cross(hull[k - 2], hull[k - 1], points[i - 1]) <= 0) k--;
+        hull[k++] = points[i - 1];
+    }
+    hull.resize(k - 1);
+
+    return hull;
+}
+
+// returns the direction of the minimum area rectangle enclosing a convex polygon (rotating calipers)
+Eigen::Vector2d minimumAreaDirection(const std::vector<Eigen::Vector2d>& hull) {
+    size_t m = hull.size();
+    if (m < 3) return Eigen::Vector2d(1, 0);
+
+    auto next = [m](size_t i) { return (i + 1) % m; };
+
+    // calipers for the first edge: farthest along the edge, farthest from it and least along it
+    Eigen::Vector2d e = (hull[1] - hull[0]).normalized();
+    Eigen::Vector2d normal(-e.y(), e.x());
+    size_t right = 0, top = 0, left = 0;
+    for (size_t i = 1; i < m; i++) {
+        if (hull[i].dot(e) > hull[right].dot(e)) right = i;
+        if (hull[i].dot(normal) > hull[top].dot(normal)) top = i;
+        if (hull[i].dot(e) < hull[left].dot(e)) left = i;
+    }
+
+    double bestArea = INFINITY;
+    Eigen::Vector2d best = e;
+    for (size_t i = 0; i < m; i++) {
+        e = (hull[next(i)] - hull[i]).normalized();
+        normal = Eigen::Vector2d(-e.y(), e.x());
+
+        // the calipers only move forward as the edge direction turns counterclockwise
+        for (size_t s = 0; s < m && (hull[next(right)] - hull[right]).dot(e) > 0; s++) right = next(right);
+        for (size_t s = 0; s < m && (hull[next(top)] - hull[top]).dot(normal) > 0; s++) top = next(top);
+        for (size_t s = 0; s < m && (hull[next(left)] - hull[left]).dot(e) < 0; s++) left = next(left);
+
+        double area = (hull[right] - hull[left]).dot(e) * (hull[top] - hull[i]).dot(normal);
+        if (area < bestArea) {
+            bestArea = area;
+            best = e;
+        }
+    }
+
+    return best;
+}
+
+// returns the range of points relative to center projected on the columns of axes
+void projectedRange(const PositionBuffer& points, const Eigen::Vector3d& center, const Eigen::Matrix3d& axes,
+                    Eigen::Vector3d& minVals, Eigen::Vector3d& maxVals) {
+    SimdKernels::projectMinMax(points.x.data(), points.y.data(), points.z.data(), points.size(),
+                               center.data(), axes.data(), minVals.data(), maxVals.data());
+}
+
+// sample directions of DiTO-14: the coordinate axes and the cube diagonals, in the order of
+// SimdKernels::extremalIndices
+const Eigen::Vector3d ditoDirections[13] = {
+    Eigen::Vector3d(1, 0, 0), Eigen::Vector3d(0, 1, 0), Eigen::Vector3d(0, 0, 1),
+    Eigen::Vector3d(1, 1, 1), Eigen::Vector3d(1, 1, -1), Eigen::Vector3d(1, -1, 1), Eigen::Vector3d(1, -1, -1),
+    // DiTO-26 adds the face diagonals
+    Eigen::Vector3d(1, 1, 0), Eigen::Vector3d(1, -1, 0), Eigen::Vector3d(1, 0, 1),
+    Eigen::Vector3d(1, 0, -1), Eigen::Vector3d(0, 1, 1), Eigen::Vector3d(0, 1, -1)
+};
+
+// DiTO searches larger inputs for the extremal points on one group of eight points in every step groups,
+// at most ditoMaxStep apart and keeping at least ditoSearchPoints; the final fit still reads every point
+const size_t ditoSearchPoints = 1024;
+const size_t ditoMaxStep = 8;
+
+// indices of the points with the least and greatest projection on each of the first K directions among
+// the points the search reads, see SimdKernels::extremalIndices
+template <int K>
+void extremalPoints(const PositionBuffer& positions, size_t step, int threads, uint32_t minIndex[K], uint32_t maxIndex[K]) {
+    size_t n = positions.size();
+    size_t blocks = (n + PointReduction::blockSize - 1) / PointReduction::blockSize;
+    std::vector<std::array<size_t, 2 * K>> indices(blocks);
+
+    ThreadPool::global().parallelFor(blocks, [&](size_t b) {
+        size_t begin = b * PointReduction::blockSize;
+        size_t end = std::min(n, begin + PointReduction::blockSize);
+
+        SimdKernels::extremalIndices(positions.x.data() + begin, positions.y.data() + begin,
+                                     positions.z.data() + begin, end - begin, K, step,
+                                     indices[b].data(), indices[b].data() + K);
+        for (size_t& i : indices[b]) i += begin;
+    }, ThreadPool::resolveThreadCount(threads));
+
+    // merge in block order, ties keep the lowest index
+    for (int k = 0; k < K; k++) {
+        const Eigen::Vector3d& d = ditoDirections[k];
+        minIndex[k] = (uint32_t)indices[0][k];
+        maxIndex[k] = (uint32_t)indices[0][K + k];
+        for (size_t b = 1; b < blocks; b++) {
+            if (d.dot(positions.get(indices[b][k])) < d.dot(positions.get(minIndex[k]))) minIndex[k] = (uint32_t)indices[b][k];
+            if (d.dot(positions.get(indices[b][K + k])) > d.dot(positions.get(maxIndex[k]))) maxIndex[k] = (uint32_t)indices[b][K + k];
+        }
+    }
+}
+
+// DiTO quality of a box with the given extents: half its surface area
+double ditoQuality(const Eigen::Vector3d& e) {
+    return e.x() * e.y() + e.x() * e.z() + e.y() * e.z();
+}
+
+// appends the axes built from each edge of triangle (a, b, c) and its normal
+void ditoTriangleAxes(const Eigen::Vector3d& a, const Eigen::Vector3d& b, const Eigen::Vector3d& c,
+                      std::vector<Eigen::Matrix3d>& candidates) {
+    Eigen::Vector3d n = (b - a).cross(c - a);
+    if (n.squaredNorm() == 0) return;
+    n.normalize();
+
+    const Eigen::Vector3d edges[3] = {b - a, c - b, a - c};
+    for (const Eigen::Vector3d& edge : edges) {
+        if (edge.squaredNorm() == 0) continue;
+
+        Eigen::Matrix3d axes;
+        axes.col(0) = edge.normalized();
+        axes.col(1) = n.cross(axes.col(0));
+        axes.col(2) = n;
+        candidates.push_back(axes);
+    }
+}
+
+// logs that the surface PCA was asked for without the triangles of a surface
+bool rejectSurfaceMethod() {
+    Log::write(LogError, "SurfacePrincipalComponents needs the triangles of the surface, "
+                         "pass them with the positions");
+    return false;
+}
+
+} // namespace
 
 
 /**
@@ -121,76 +282,493 @@ bool BoundingBox::contains(const BoundingBox& boundingBox, double& dist) const {
  * Parameter:
  *     vertices: std::vector<Vertex>, the vertices to be enclosed in the bounding box.
  * Sets the type to "Axis Aligned" and adjusts the min and max points to enclose all vertices.
+ * The box always contains the origin. The box is logged at LogDebug.
  */
 void BoundingBox::computeAxisAlignedBox(std::vector<Vertex>& vertices) {
+    PositionBuffer positions;
+    positions.assign(vertices);
+
+    computeAxisAlignedBox(positions);
+    min = min.cwiseMin(Eigen::Vector3d::Zero());
+    max = max.cwiseMax(Eigen::Vector3d::Zero());
+    extent = max - min;
+
+    if (Log::isEnabled(LogDebug)) {
+        std::ostringstream out;
+        printAxisAlignedBox(out);
+        Log::write(LogDebug, out.str());
+    }
+}
+
+/**
+ * Functionality: Computes the oriented bounding box for a set of vertices using PCA.
+ * Parameter:
+ *     vertices: std::vector<Vertex>, the vertices to be enclosed in the bounding box.
+ * Sets the type to "Oriented" and calculates the oriented bounding box that best fits the vertices.
+ * The box is logged at LogDebug.
+ */
+void BoundingBox::computeOrientedBox(std::vector<Vertex>& vertices) {
+    PositionBuffer positions;
+    positions.assign(vertices);
+
+    computeOrientedBox(positions);
+
+    if (Log::isEnabled(LogDebug)) {
+        std::ostringstream out;
+        printOrientedBox(out);
+        Log::write(LogDebug, out.str());
+    }
+}
+
+/**
+ * Functionality: Computes the axis-aligned bounding box of a position buffer.
+ * Parameter:
+ *     positions: const PositionBuffer&, the points to be enclosed in the bounding box.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Sets the type to "Axis Aligned" and sets min and max to the exact range of the points,
+ * or to zero if there are none.
+ */
+void BoundingBox::computeAxisAlignedBox(const PositionBuffer& positions, int threads) {
+    computeAxisAlignedBox(PositionBufferSource(positions), threads);
+}
+
+/**
+ * Functionality: Computes the axis-aligned bounding box of a point source.
+ * Parameter:
+ *     points: const PointSource&, the points to be enclosed in the bounding box.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Sets the type to "Axis Aligned" and sets min and max to the exact range of the points,
+ * or to zero if there are none.
+ */
+void BoundingBox::computeAxisAlignedBox(const PointSource& points, int threads) {
+    ScopedTimer timer("BoundingBox::computeAxisAlignedBox");
+    timer.addElements(points.size());
+
     type = "Axis Aligned";
 
     min.setZero();
     max.setZero();
 
-    for (VertexIter v = vertices.begin(); v != vertices.end(); v++) {
-        expandToInclude(v->position);
+    if (points.size() > 0) {
+        PointReduction::minMax(points, min, max, threads);
     }
 
+    extent = max - min;
+}
 
-    std::cout << "(C++) Min: [" << std::fixed << std::setprecision(8) << min.transpose() << "]" << std::endl;
-    std::cout << "(C++) Max: [" << std::fixed << std::setprecision(8) << max.transpose() << "]" << std::endl;
-    std::cout << "(C++) Extent: [" << std::fixed << std::setprecision(8) << extent.transpose() << "]" << std::endl;
+/**
+ * Functionality: Computes the oriented bounding box of a position buffer using PCA.
+ * The mean and covariance are accumulated in a single parallel pass, followed by a parallel
+ * projection pass. The result does not depend on the thread count.
+ * Parameter:
+ *     positions: const PositionBuffer&, the points to be enclosed in the bounding box.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Sets the type to "Oriented" and calculates the oriented bounding box that best fits the points.
+ * Without points the box collapses to the origin.
+ */
+void BoundingBox::computeOrientedBox(const PositionBuffer& positions, int threads) {
+    computeOrientedBox(PositionBufferSource(positions), PrincipalComponents, threads);
 }
 
 /**
- * Functionality: Computes the oriented bounding box for a set of vertices using PCA.
+ * Functionality: Computes the oriented bounding box of a point source. The PCA box reads the points
+ * in place, the other methods copy them into a position buffer first.
  * Parameter:
- *     vertices: std::vector<Vertex>, the vertices to be enclosed in the bounding box.
- * Sets the type to "Oriented" and calculates the oriented bounding box that best fits the vertices.
+ *     points: const PointSource&, the points to be enclosed in the bounding box.
+ *     method: OrientedBoxMethod, the algorithm to use, any but SurfacePrincipalComponents.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Returns: bool, false if the method needs triangles, the box is then left unchanged.
+ * Without points the box collapses to the origin.
  */
-void BoundingBox::computeOrientedBox(std::vector<Vertex>& vertices) {
+bool BoundingBox::computeOrientedBox(const PointSource& points, OrientedBoxMethod method, int threads) {
+    if (method != PrincipalComponents) {
+        if (method == SurfacePrincipalComponents) return rejectSurfaceMethod();
+        PositionBuffer positions;
+        PointReduction::copy(points, positions, threads);
+        return computeOrientedBox(positions, method, threads);
+    }
+
+    ScopedTimer timer("BoundingBox::computeOrientedBox");
+    timer.addElements(points.size());
+
     type = "Oriented";
     orientedPoints.clear();
 
-    // Compute the mean of the vertices
-    Eigen::Vector3d center = Eigen::Vector3d::Zero();
-    for (const auto& v : vertices) {
-        center += v.position;
+    if (points.size() == 0) {
+        setOrientedBox(Eigen::Vector3d::Zero(), Eigen::Matrix3d::Identity(), Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero());
+        return true;
     }
-    center /= static_cast<double>(vertices.size());
 
-    // Adjust vertices based on the mean and compute covariance matrix
-    Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
-    for (const auto& v : vertices) {
-        Eigen::Vector3d adjustedPosition = v.position - center;
-        covariance += adjustedPosition * adjustedPosition.transpose();
+    // Compute the mean and covariance matrix
+    PointMoments moments = PointReduction::moments(points, threads);
+
+    setPrincipalBox(points, moments, threads);
+    return true;
+}
+
+/**
+ * Functionality: Computes the oriented bounding box of a triangulated surface using PCA of the
+ * surface rather than of its vertices. Every triangle contributes in proportion to its area, so
+ * the axes do not depend on the tessellation.
+ * Parameter:
+ *     positions: const PositionBuffer&, the points to be enclosed in the bounding box.
+ *     triangles: const std::vector<uint32_t>&, three indices into positions per triangle.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Falls back to the PCA of the points if the triangles have no area.
+ */
+void BoundingBox::computeOrientedBox(const PositionBuffer& positions, const std::vector<uint32_t>& triangles,
+                                     int threads) {
+    ScopedTimer timer("BoundingBox::computeSurfaceOrientedBox");
+    timer.addElements(triangles.size() / 3);
+
+    PointMoments moments = PointReduction::surfaceMoments(positions, triangles, threads);
+    if (moments.count <= 0) {
+        computeOrientedBox(positions, threads);
+        return;
     }
-    covariance /= static_cast<double>(vertices.size());
 
+    type = "Oriented";
+    setPrincipalBox(PositionBufferSource(positions), moments, threads);
+}
+
+/**
+ * Functionality: Fits the box along the principal axes of a covariance.
+ * Parameter:
+ *     points: const PointSource&, the points to be enclosed in the bounding box.
+ *     moments: const PointMoments&, the mean and covariance the axes are taken from.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ */
+void BoundingBox::setPrincipalBox(const PointSource& points, const PointMoments& moments, int threads) {
     // Perform PCA - compute the eigenvectors
-    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigenSolver(covariance);
+    Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigenSolver(moments.covariance());
     Eigen::Matrix3d eigenVectors = eigenSolver.eigenvectors();
 
-    // Initialize min and max values for each principal component
-    Eigen::Vector3d minVals = Eigen::Vector3d::Constant(INFINITY);
-    Eigen::Vector3d maxVals = Eigen::Vector3d::Constant(-INFINITY);
+    // Project the points onto the principal components and find min/max
+    Eigen::Vector3d minVals, maxVals;
+    PointReduction::projectMinMax(points, moments.mean, eigenVectors, minVals, maxVals, threads);
 
-    // Project the vertices onto the principal components and find min/max
-    for (const auto& v : vertices) {
-        Eigen::Vector3d projected = eigenVectors.transpose() * (v.position - center);
-        minVals = minVals.cwiseMin(projected);
-        maxVals = maxVals.cwiseMax(projected);
+    setOrientedBox(moments.mean, eigenVectors, minVals, maxVals);
+}
+
+/**
+ * Functionality: Computes the oriented bounding box of a position buffer with a chosen algorithm.
+ * The hull based methods build the hull in parallel and fall back to PCA on all points if the
+ * points do not span a volume.
+ * Parameter:
+ *     positions: const PositionBuffer&, the points to be enclosed in the bounding box.
+ *     method: OrientedBoxMethod, the algorithm. SurfacePrincipalComponents needs the triangles of
+ *             the surface and is rejected, use the overload taking them.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Returns: bool, false if the method needs triangles, the box is then left unchanged.
+ */
+bool BoundingBox::computeOrientedBox(const PositionBuffer& positions, OrientedBoxMethod method, int threads) {
+    if (method == SurfacePrincipalComponents) return rejectSurfaceMethod();
+    if (method == PrincipalComponents) {
+        computeOrientedBox(positions, threads);
+        return true;
+    }
+    if (method == DiTO14) {
+        computeDiTOBox<7>(positions, threads);
+        return true;
+    }
+    if (method == DiTO26) {
+        computeDiTOBox<13>(positions, threads);
+        return true;
+    }
+
+    ConvexHull hull;
+    if (!hull.compute(positions, threads)) {
+        computeOrientedBox(positions, threads);
+        return true;
+    }
+
+    if (method == HullPrincipalComponents) {
+        computeOrientedBox(hull.vertices, threads);
+    } else if (method == HullSurfacePrincipalComponents) {
+        computeOrientedBox(hull.vertices, hull.triangles, threads);
+    } else {
+        computeMinimumVolumeBox(hull, threads);
+    }
+    return true;
+}
+
+/**
+ * Functionality: Computes the oriented bounding box of a triangulated surface with any algorithm.
+ * SurfacePrincipalComponents fits the surface itself, every other method only reads the positions.
+ * Parameter:
+ *     positions: const PositionBuffer&, the points to be enclosed in the bounding box.
+ *     triangles: const std::vector<uint32_t>&, three indices into positions per triangle.
+ *     method: OrientedBoxMethod, the algorithm to use.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ */
+void BoundingBox::computeOrientedBox(const PositionBuffer& positions, const std::vector<uint32_t>& triangles,
+                                     OrientedBoxMethod method, int threads) {
+    if (method == SurfacePrincipalComponents) {
+        computeOrientedBox(positions, triangles, threads);
+    } else {
+        computeOrientedBox(positions, method, threads);
+    }
+}
+
+/**
+ * Functionality: Fits the smallest box that has a face flush with a face of the convex hull. For every
+ * hull face the hull is projected on the face plane and the minimum area rectangle of the projection is
+ * found with rotating calipers. The hull PCA box is kept if no face gives a smaller box.
+ * Parameter:
+ *     hull: const ConvexHull&, the convex hull of the points.
+ *     threads: int, the number of threads the hull faces are split over, 0 for all hardware threads.
+ */
+void BoundingBox::computeMinimumVolumeBox(const ConvexHull& hull, int threads) {
+    ScopedTimer timer("BoundingBox::computeMinimumVolumeBox");
+    timer.addElements(hull.faceCount());
+
+    computeOrientedBox(hull.vertices, threads);
+    double bestVolume = volume();
+
+    const PositionBuffer& points = hull.vertices;
+    Eigen::Vector3d center;
+    SimdKernels::sum(points.x.data(), points.y.data(), points.z.data(), points.size(), center.data());
+    center /= (double)points.size();
+
+    std::vector<double> volumes(hull.faceCount());
+    std::vector<Eigen::Matrix3d> axes(hull.faceCount());
+    ThreadPool::global().parallelFor(hull.faceCount(), [&](size_t f) {
+        Eigen::Vector3d n = hull.faceNormal(f);
+        Eigen::Vector3d u = n.unitOrthogonal();
+        Eigen::Vector3d v = n.cross(u);
+
+        std::vector<Eigen::Vector2d> projected(points.size());
+        for (size_t i = 0; i < points.size(); i++) {
+            Eigen::Vector3d p = points.get(i) - center;
+            projected[i] = Eigen::Vector2d(p.dot(u), p.dot(v));
+        }
+        Eigen::Vector2d e = minimumAreaDirection(convexHull2d(projected));
+
+        axes[f].col(0) = e.x() * u + e.y() * v;
+        axes[f].col(1) = n.cross(axes[f].col(0));
+        axes[f].col(2) = n;
+
+        Eigen::Vector3d minVals, maxVals;
+        projectedRange(points, center, axes[f], minVals, maxVals);
+        volumes[f] = (maxVals - minVals).prod();
+    }, ThreadPool::resolveThreadCount(threads));
+
+    // the first face with the smallest volume, independent of the thread count
+    size_t best = volumes.size();
+    for (size_t f = 0; f < volumes.size(); f++) {
+        if (volumes[f] < bestVolume) {
+            bestVolume = volumes[f];
+            best = f;
+        }
+    }
+    if (best == volumes.size()) return;
+
+    Eigen::Vector3d minVals, maxVals;
+    projectedRange(points, center, axes[best], minVals, maxVals);
+    setOrientedBox(center, axes[best], minVals, maxVals);
+}
+
+/**
+ * Functionality: Computes an oriented bounding box with the DiTO algorithm (Larsson and Kallberg,
+ * "Fast Computation of Tight-Fitting Oriented Bounding Boxes"). One pass finds the extremal points
+ * along K fixed directions. The two farthest apart and the one farthest from their line form a
+ * triangle, which is extended to a ditetrahedron by the extremal points above and below it. The
+ * edges and normals of these triangles give candidate axes, scored on the extremal points. A final
+ * pass fits the best candidate to all points, and the axis-aligned box replaces it when it holds
+ * less volume. Inputs above 2 * ditoSearchPoints are searched on a sample of the points, which
+ * only affects the choice of axes: the final box always encloses every point. There is no
+ * covariance and no eigen decomposition.
+ * Parameter:
+ *     positions: const PositionBuffer&, the points to be enclosed in the bounding box.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * K is the number of sample directions, 7 (DiTO-14) or 13 (DiTO-26).
+ */
+template <int K>
+void BoundingBox::computeDiTOBox(const PositionBuffer& positions, int threads) {
+    static_assert(K == 3 || K == 7 || K == 13, "DiTO uses 3, 7 or 13 sample directions");
+
+    ScopedTimer timer("BoundingBox::computeDiTOBox");
+    timer.addElements(positions.size());
+
+    type = "Oriented";
+    orientedPoints.clear();
+
+    if (positions.empty()) {
+        setOrientedBox(Eigen::Vector3d::Zero(), Eigen::Matrix3d::Identity(), Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero());
+        return;
+    }
+
+    size_t step = std::max<size_t>(1, std::min(positions.size() / ditoSearchPoints, ditoMaxStep));
+    uint32_t minIndex[K], maxIndex[K];
+    extremalPoints<K>(positions, step, threads, minIndex, maxIndex);
+
+    // the axis-aligned box of the searched points, exact when the search read every point
+    Eigen::Vector3d aabbMin, aabbMax;
+    for (int i = 0; i < 3; i++) {
+        aabbMin[i] = positions.get(minIndex[i])[i];
+        aabbMax[i] = positions.get(maxIndex[i])[i];
+    }
+
+    // the candidates are scored on the extremal points, each once
+    std::vector<uint32_t> unique(minIndex, minIndex + K);
+    unique.insert(unique.end(), maxIndex, maxIndex + K);
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+    PositionBuffer points;
+    points.resize(unique.size());
+    for (size_t i = 0; i < unique.size(); i++) points.set(i, positions.get(unique[i]));
+
+    // base triangle: the farthest pair of extremal points and the point farthest from their line
+    Eigen::Vector3d a, b;
+    double farthest = -1;
+    for (int k = 0; k < K; k++) {
+        Eigen::Vector3d lo = positions.get(minIndex[k]), hi = positions.get(maxIndex[k]);
+        double d = (hi - lo).squaredNorm();
+        if (d > farthest) {
+            farthest = d;
+            a = lo;
+            b = hi;
+        }
+    }
+
+    // three per triangle: the base triangle and the three triangles of each apex
+    std::vector<Eigen::Matrix3d> candidates;
+    candidates.reserve(21);
+    if (farthest > 0) {
+        Eigen::Vector3d line = (b - a).normalized();
+        Eigen::Vector3d c = a;
+        farthest = 0;
+        for (size_t i = 0; i < points.size(); i++) {
+            double d = line.cross(points.get(i) - a).squaredNorm();
+            if (d > farthest) {
+                farthest = d;
+                c = points.get(i);
+            }
+        }
+        ditoTriangleAxes(a, b, c, candidates);
+
+        // ditetrahedron apexes on both sides of the base triangle
+        Eigen::Vector3d n = (b - a).cross(c - a);
+        if (n.squaredNorm() > 0) {
+            Eigen::Vector3d below = a, above = a;
+            for (size_t i = 0; i < points.size(); i++) {
+                Eigen::Vector3d p = points.get(i);
+                if (n.dot(p - a) < n.dot(below - a)) below = p;
+                if (n.dot(p - a) > n.dot(above - a)) above = p;
+            }
+            for (const Eigen::Vector3d& q : {below, above}) {
+                ditoTriangleAxes(a, b, q, candidates);
+                ditoTriangleAxes(b, c, q, candidates);
+                ditoTriangleAxes(c, a, q, candidates);
+            }
+        }
+    }
+
+    // the axis-aligned box is the first candidate
+    Eigen::Matrix3d best = Eigen::Matrix3d::Identity();
+    Eigen::Vector3d bestExtents = aabbMax - aabbMin;
+    double bestQuality = ditoQuality(bestExtents);
+    const double origin[3] = {0, 0, 0};
+    for (const Eigen::Matrix3d& axes : candidates) {
+        Eigen::Vector3d lo, hi;
+        SimdKernels::projectMinMax(points.x.data(), points.y.data(), points.z.data(), points.size(), origin,
+                                   axes.data(), lo.data(), hi.data());
+        double quality = ditoQuality(hi - lo);
+        if (quality < bestQuality) {
+            bestQuality = quality;
+            bestExtents = hi - lo;
+            best = axes;
+        }
+    }
+
+    // the axis-aligned box can still hold less volume than the chosen axes. The searched box is exact when
+    // the search read every point and a lower bound otherwise, so the exact box is only computed once it
+    // could win. It wins without a fit when it holds less than the candidate does on the extremal points
+    bool exact = step == 1;
+    if (!best.isIdentity() && (aabbMax - aabbMin).prod() < bestExtents.prod()) {
+        if (!exact) PointReduction::minMax(PositionBufferSource(positions), aabbMin, aabbMax, threads);
+        exact = true;
+        if ((aabbMax - aabbMin).prod() < bestExtents.prod()) best = Eigen::Matrix3d::Identity();
+    }
+
+    // fit the chosen axes to all points
+    Eigen::Vector3d minVals = aabbMin, maxVals = aabbMax;
+    if (!best.isIdentity()) {
+        PointReduction::projectMinMax(PositionBufferSource(positions), Eigen::Vector3d::Zero(), best, minVals, maxVals, threads);
+        if ((aabbMax - aabbMin).prod() < (maxVals - minVals).prod()) {
+            if (!exact) PointReduction::minMax(PositionBufferSource(positions), aabbMin, aabbMax, threads);
+            if ((aabbMax - aabbMin).prod() < (maxVals - minVals).prod()) {
+                best = Eigen::Matrix3d::Identity();
+                minVals = aabbMin;
+                maxVals = aabbMax;
+            }
+        }
+    } else if (!exact) {
+        PointReduction::minMax(PositionBufferSource(positions), minVals, maxVals, threads);
+    }
+
+    setOrientedBox(Eigen::Vector3d::Zero(), best, minVals, maxVals);
+}
+
+template void BoundingBox::computeDiTOBox<7>(const PositionBuffer& positions, int threads);
+template void BoundingBox::computeDiTOBox<13>(const PositionBuffer& positions, int threads);
+
+/**
+ * Functionality: Computes the volume of the bounding box.
+ * Returns:
+ *     double: The volume of the oriented box if the type is "Oriented", of the axis-aligned box otherwise.
+ */
+double BoundingBox::volume() const {
+    if (type == "Oriented" && orientedPoints.size() == 6) {
+        return (orientedPoints[1] - orientedPoints[0]).norm() *
+               (orientedPoints[3] - orientedPoints[2]).norm() *
+               (orientedPoints[5] - orientedPoints[4]).norm();
     }
 
-    // Construct the oriented bounding box points
+    return extent.prod();
+}
+
+/**
+ * Functionality: Constructs the oriented points of the box.
+ * Parameter:
+ *     center: const Eigen::Vector3d&, the origin of the box frame.
+ *     axes: const Eigen::Matrix3d&, the box axes stored as columns.
+ *     minVals, maxVals: const Eigen::Vector3d&, the extents of the box along each axis, relative to center.
+ */
+void BoundingBox::setOrientedBox(const Eigen::Vector3d& center, const Eigen::Matrix3d& axes,
+                                 const Eigen::Vector3d& minVals, const Eigen::Vector3d& maxVals) {
+    orientedPoints.clear();
+
     for (int i = 0; i < 3; ++i) {
-        orientedPoints.push_back(center + eigenVectors.col(i) * minVals[i]);
-        orientedPoints.push_back(center + eigenVectors.col(i) * maxVals[i]);
+        orientedPoints.push_back(center + axes.col(i) * minVals[i]);
+        orientedPoints.push_back(center + axes.col(i) * maxVals[i]);
     }
+}
 
-    // Print the oriented points
-    std::cout << "(C++) Oriented Point Xmin: [" << orientedPoints[0].x() << ", " << orientedPoints[0].y() << ", " << orientedPoints[0].z() << "]" << std::endl;
-    std::cout << "(C++) Oriented Point Xmax: [" << orientedPoints[1].x() << ", " << orientedPoints[1].y() << ", " << orientedPoints[1].z() << "]" << std::endl;
-    std::cout << "(C++) Oriented Point Ymin: [" << orientedPoints[2].x() << ", " << orientedPoints[2].y() << ", " << orientedPoints[2].z() << "]" << std::endl;
-    std::cout << "(C++) Oriented Point Ymax: [" << orientedPoints[3].x() << ", " << orientedPoints[3].y() << ", " << orientedPoints[3].z() << "]" << std::endl;
-    std::cout << "(C++) Oriented Point Zmin: [" << orientedPoints[4].x() << ", " << orientedPoints[4].y() << ", " << orientedPoints[4].z() << "]" << std::endl;
-    std::cout << "(C++) Oriented Point Zmax: [" << orientedPoints[5].x() << ", " << orientedPoints[5].y() << ", " << orientedPoints[5].z() << "]" << std::endl;
+/**
+ * Functionality: Prints the min, max and extent of the axis-aligned box.
+ * Parameter:
+ *     out: std::ostream&, the stream to print to.
+ */
+void BoundingBox::printAxisAlignedBox(std::ostream& out) const {
+    out << "(C++) Min: [" << std::fixed << std::setprecision(8) << min.transpose() << "]\n";
+    out << "(C++) Max: [" << std::fixed << std::setprecision(8) << max.transpose() << "]\n";
+    out << "(C++) Extent: [" << std::fixed << std::setprecision(8) << extent.transpose() << "]";
+}
+
+/**
+ * Functionality: Prints the oriented points of the box.
+ * Parameter:
+ *     out: std::ostream&, the stream to print to.
+ */
+void BoundingBox::printOrientedBox(std::ostream& out) const {
+    out << "(C++) Oriented Point Xmin: [" << orientedPoints[0].x() << ", " << orientedPoints[0].y() << ", " << orientedPoints[0].z() << "]\n";
+    out << "(C++) Oriented Point Xmax: [" << orientedPoints[1].x() << ", " << orientedPoints[1].y() << ", " << orientedPoints[1].z() << "]\n";
+    out << "(C++) Oriented Point Ymin: [" << orientedPoints[2].x() << ", " << orientedPoints[2].y() << ", " << orientedPoints[2].z() << "]\n";
+    out << "(C++) Oriented Point Ymax: [" << orientedPoints[3].x() << ", " << orientedPoints[3].y() << ", " << orientedPoints[3].z() << "]\n";
+    out << "(C++) Oriented Point Zmin: [" << orientedPoints[4].x() << ", " << orientedPoints[4].y() << ", " << orientedPoints[4].z() << "]\n";
+    out << "(C++) Oriented Point Zmax: [" << orientedPoints[5].x() << ", " << orientedPoints[5].y() << ", " << orientedPoints[5].z() << "]";
 }
 
 /* Old compute have a little fault */
@@ -0,0 +1,157 @@
+#include "BoxOverlap.h"
+
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// copies the packed values of box i
+void packedBox(const OrientedBoxBuffer& boxes, size_t i, double box[15]) {
+    for (int k = 0; k < 15; k++) box[k] = boxes.values[k][i];
+}
+
+// number of rows of an a.size() by m test per task, about blockSize tests each
+size_t rowsPerTask(size_t m) {
+    return std::max<size_t>(1, BoxOverlap::blockSize / std::max<size_t>(1, m));
+}
+
+} // namespace
+
+/**
+ * Functionality: Tests every box of one set against every box of another. Blocks of rows are spread
+ * over the threads, each row tests one box against all of b four pairs at a time.
+ * Parameter:
+ *     a: const OrientedBoxBuffer&, the first set.
+ *     b: const OrientedBoxBuffer&, the second set.
+ *     result: std::vector<uint8_t>&, receives a.size() * b.size() flags, result[i * b.size() + j] is 1
+ *             if box i of a overlaps box j of b.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ */
+void BoxOverlap::overlapMatrix(const OrientedBoxBuffer& a, const OrientedBoxBuffer& b, std::vector<uint8_t>& result,
+                               int threads) {
+    size_t n = a.size(), m = b.size();
+    result.resize(n * m);
+
+    const double* arrays[15];
+    b.arrays(arrays);
+
+    size_t rows = rowsPerTask(m);
+    ThreadPool::global().parallelFor((n + rows - 1) / rows, [&](size_t task) {
+        double box[15];
+        for (size_t i = task * rows; i < std::min(n, (task + 1) * rows); i++) {
+            packedBox(a, i, box);
+            SimdKernels::boxOverlaps(box, arrays, m, result.data() + i * m);
+        }
+    }, ThreadPool::resolveThreadCount(threads));
+}
+
+/**
+ * Functionality: Lists the overlapping pairs among all pairs of boxes from two sets, without storing
+ * the whole overlap matrix.
+ * Parameter:
+ *     a: const OrientedBoxBuffer&, the first set.
+ *     b: const OrientedBoxBuffer&, the second set.
+ *     pairs: std::vector<std::pair<uint32_t, uint32_t>>&, receives (index in a, index in b) of each
+ *            overlapping pair, sorted.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ */
+void BoxOverlap::overlappingPairs(const OrientedBoxBuffer& a, const OrientedBoxBuffer& b,
+                                  std::vector<std::pair<uint32_t, uint32_t>>& pairs, int threads) {
+    size_t n = a.size(), m = b.size();
+    pairs.clear();
+
+    const double* arrays[15];
+    b.arrays(arrays);
+
+    size_t rows = rowsPerTask(m);
+    size_t tasks = (n + rows - 1) / rows;
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> found(tasks);
+
+    ThreadPool::global().parallelFor(tasks, [&](size_t task) {
+        double box[15];
+        std::vector<uint8_t> flags(m);
+        for (size_t i = task * rows; i < std::min(n, (task + 1) * rows); i++) {
+            packedBox(a, i, box);
+            SimdKernels::boxOverlaps(box, arrays, m, flags.data());
+            for (size_t j = 0; j < m; j++) {
+                if (flags[j]) found[task].push_back({(uint32_t)i, (uint32_t)j});
+            }
+        }
+    }, ThreadPool::resolveThreadCount(threads));
+
+    for (const std::vector<std::pair<uint32_t, uint32_t>>& block : found) {
+        pairs.insert(pairs.end(), block.begin(), block.end());
+    }
+}
+
+/**
+ * Functionality: Lists the overlapping pairs within one set of boxes. The extent of each box along
+ * the coordinate axis with the largest spread of centers is swept in sorted order, and only pairs
+ * whose extents overlap are passed to the separating axis test, in parallel blocks.
+ * Parameter:
+ *     boxes: const OrientedBoxBuffer&, the boxes.
+ *     pairs: std::vector<std::pair<uint32_t, uint32_t>>&, receives (i, j) with i < j for each
+ *            overlapping pair, sorted.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ */
+void BoxOverlap::sweepAndPrune(const OrientedBoxBuffer& boxes, std::vector<std::pair<uint32_t, uint32_t>>& pairs,
+                               int threads) {
+    size_t n = boxes.size();
+    pairs.clear();
+    if (n < 2) return;
+
+    int axis = 0;
+    double spread = -1;
+    for (int k = 0; k < 3; k++) {
+        std::pair<std::vector<double>::const_iterator, std::vector<double>::const_iterator> range =
+            std::minmax_element(boxes.values[k].begin(), boxes.values[k].end());
+        if (*range.second - *range.first > spread) {
+            spread = *range.second - *range.first;
+            axis = k;
+        }
+    }
+
+    // extent of each box along the axis: the center plus and minus the projected half extents
+    std::vector<double> lo(n), hi(n);
+    for (size_t i = 0; i < n; i++) {
+        double radius = 0;
+        for (int k = 0; k < 3; k++) radius += std::abs(boxes.values[3 + 3*k + axis][i]) * boxes.values[12 + k][i];
+        lo[i] = boxes.values[axis][i] - radius;
+        hi[i] = boxes.values[axis][i] + radius;
+    }
+
+    std::vector<uint32_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return lo[a] < lo[b] || (lo[a] == lo[b] && a < b);
+    });
+
+    std::vector<uint32_t> candidates;
+    for (size_t s = 0; s < n; s++) {
+        uint32_t i = order[s];
+        for (size_t r = s + 1; r < n && lo[order[r]] <= hi[i]; r++) {
+            uint32_t j = order[r];
+            candidates.push_back(std::min(i, j));
+            candidates.push_back(std::max(i, j));
+        }
+    }
+
+    const double* arrays[15];
+    boxes.arrays(arrays);
+
+    size_t count = candidates.size() / 2;
+    std::vector<uint8_t> flags(count);
+    ThreadPool::global().parallelFor((count + blockSize - 1) / blockSize, [&](size_t task) {
+        size_t begin = task * blockSize;
+        size_t end = std::min(count, begin + blockSize);
+        SimdKernels::boxPairOverlaps(arrays, arrays, candidates.data() + 2 * begin, end - begin, flags.data() + begin);
+    }, ThreadPool::resolveThreadCount(threads));
+
+    for (size_t c = 0; c < count; c++) {
+        if (flags[c]) pairs.push_back({candidates[2*c], candidates[2*c + 1]});
+    }
+    std::sort(pairs.begin(), pairs.end());
+}
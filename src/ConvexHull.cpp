@@ -0,0 +1,408 @@
+#include "ConvexHull.h"
+
+#include "Profiler.h"
+#include "ThreadPool.h"
+
+#include <cfloat>
+#include <unordered_map>
+
+namespace {
+
+// triangle of the hull under construction, neighbor[i] shares the edge from v[i] to v[(i + 1) % 3]
+struct HullFace {
+    uint32_t v[3];
+    uint32_t neighbor[3];
+    Eigen::Vector3d normal;
+    double offset;
+    std::vector<uint32_t> outside;
+    uint32_t farthest;
+    double farthestDistance;
+    bool alive;
+};
+
+class Quickhull {
+public:
+    Quickhull(const PositionBuffer& points, size_t begin, size_t end)
+        : x(points.x.data() + begin), y(points.y.data() + begin), z(points.z.data() + begin),
+          n(end - begin), epsilon(0) {}
+
+    // builds the hull, returns false if the points do not span a volume
+    bool build();
+
+    // appends the indices of the hull vertices, offset by base, in increasing order
+    void hullVertices(uint32_t base, std::vector<uint32_t>& indices) const;
+
+    // copies the hull into the result
+    void extract(ConvexHull& hull) const;
+
+private:
+    // returns point i
+    Eigen::Vector3d point(uint32_t i) const { return Eigen::Vector3d(x[i], y[i], z[i]); }
+
+    // returns the signed distance of point i above face f
+    double distance(const HullFace& f, uint32_t i) const { return f.normal.dot(point(i)) - f.offset; }
+
+    // adds a face through a, b and c, returns its index
+    uint32_t addFace(uint32_t a, uint32_t b, uint32_t c);
+
+    // adds point i to the outside set of the first face in [begin, end) it lies above, if any
+    void assign(uint32_t i, const std::vector<uint32_t>& candidates);
+
+    // builds the initial tetrahedron, returns false if the points are degenerate
+    bool initialSimplex();
+
+    // adds the farthest outside point of face f to the hull
+    void addPoint(uint32_t f);
+
+    const double* x;
+    const double* y;
+    const double* z;
+    size_t n;
+    double epsilon;
+    std::vector<HullFace> faces;
+    std::vector<uint32_t> pending;
+    std::vector<uint32_t> visitStamp;
+    std::vector<uint8_t> visibility;
+    uint32_t stamp = 0;
+};
+
+uint32_t Quickhull::addFace(uint32_t a, uint32_t b, uint32_t c) {
+    HullFace f;
+    f.v[0] = a; f.v[1] = b; f.v[2] = c;
+    f.neighbor[0] = f.neighbor[1] = f.neighbor[2] = InvalidId;
+
+    Eigen::Vector3d n = (point(b) - point(a)).cross(point(c) - point(a));
+    double length = n.norm();
+    f.normal = length > 0 ? Eigen::Vector3d(n / length) : Eigen::Vector3d::Zero();
+    f.offset = f.normal.dot(point(a));
+    f.farthest = InvalidId;
+    f.farthestDistance = 0;
+    f.alive = true;
+
+    faces.push_back(std::move(f));
+    visitStamp.push_back(0);
+    visibility.push_back(0);
+
+    return (uint32_t)faces.size() - 1;
+}
+
+void Quickhull::assign(uint32_t i, const std::vector<uint32_t>& candidates) {
+    for (uint32_t f : candidates) {
+        HullFace& face = faces[f];
+        double d = distance(face, i);
+        if (d > epsilon) {
+            face.outside.push_back(i);
+            if (d > face.farthestDistance) {
+                face.farthestDistance = d;
+                face.farthest = i;
+            }
+            return;
+        }
+    }
+}
+
+bool Quickhull::initialSimplex() {
+    if (n < 4) return false;
+
+    // extreme points along the axes, also used to scale the tolerance
+    uint32_t extremes[6] = {0, 0, 0, 0, 0, 0};
+    Eigen::Vector3d maxAbs = Eigen::Vector3d::Zero();
+    for (uint32_t i = 0; i < n; i++) {
+        Eigen::Vector3d p = point(i);
+        for (int k = 0; k < 3; k++) {
+            if (p[k] < point(extremes[2*k])[k]) extremes[2*k] = i;
+            if (p[k] > point(extremes[2*k + 1])[k]) extremes[2*k + 1] = i;
+        }
+        maxAbs = maxAbs.cwiseMax(p.cwiseAbs());
+    }
+    epsilon = 3 * DBL_EPSILON * maxAbs.sum();
+
+    // the two extremes farthest apart
+    uint32_t a = 0, b = 0;
+    double best = 0;
+    for (int i = 0; i < 6; i++) {
+        for (int j = i + 1; j < 6; j++) {
+            double d = (point(extremes[i]) - point(extremes[j])).squaredNorm();
+            if (d > best) {
+                best = d;
+                a = extremes[i];
+                b = extremes[j];
+            }
+        }
+    }
+    if (std::sqrt(best) <= epsilon) return false;
+
+    // the point farthest from the line ab
+    Eigen::Vector3d ab = (point(b) - point(a)).normalized();
+    uint32_t c = 0;
+    best = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        double d = ab.cross(point(i) - point(a)).norm();
+        if (d > best) {
+            best = d;
+            c = i;
+        }
+    }
+    if (best <= epsilon) return false;
+
+    // the point farthest from the plane abc
+    Eigen::Vector3d normal = (point(b) - point(a)).cross(point(c) - point(a)).normalized();
+    uint32_t d = 0;
+    best = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        double dist = std::abs(normal.dot(point(i) - point(a)));
+        if (dist > best) {
+            best = dist;
+            d = i;
+        }
+    }
+    if (best <= epsilon) return false;
+
+    // orient the tetrahedron so that every face points away from d's opposite side
+    if (normal.dot(point(d) - point(a)) > 0) std::swap(b, c);
+
+    uint32_t f0 = addFace(a, b, c);
+    uint32_t f1 = addFace(a, d, b);
+    uint32_t f2 = addFace(b, d, c);
+    uint32_t f3 = addFace(c, d, a);
+
+    faces[f0].neighbor[0] = f1; faces[f0].neighbor[1] = f2; faces[f0].neighbor[2] = f3;
+    faces[f1].neighbor[0] = f3; faces[f1].neighbor[1] = f2; faces[f1].neighbor[2] = f0;
+    faces[f2].neighbor[0] = f1; faces[f2].neighbor[1] = f3; faces[f2].neighbor[2] = f0;
+    faces[f3].neighbor[0] = f2; faces[f3].neighbor[1] = f1; faces[f3].neighbor[2] = f0;
+
+    std::vector<uint32_t> all = {f0, f1, f2, f3};
+    for (uint32_t i = 0; i < n; i++) {
+        if (i != a && i != b && i != c && i != d) assign(i, all);
+    }
+
+    for (uint32_t f : all) {
+        if (!faces[f].outside.empty()) pending.push_back(f);
+    }
+
+    return true;
+}
+
+void Quickhull::addPoint(uint32_t start) {
+    uint32_t eye = faces[start].farthest;
+    Eigen::Vector3d p = point(eye);
+    stamp++;
+
+    // collect the faces visible from the eye point and the horizon around them
+    std::vector<uint32_t> visible;
+    std::vector<std::pair<uint32_t, uint32_t>> horizon;  // (visible face, edge)
+    std::vector<std::pair<uint32_t, int>> stack = {{start, 0}};
+    visitStamp[start] = stamp;
+    visibility[start] = 1;
+    visible.push_back(start);
+
+    // depth first walk so that horizon edges come out in order around the eye
+    while (!stack.empty()) {
+        uint32_t f = stack.back().first;
+        int edge = stack.back().second;
+        if (edge == 3) {
+            stack.pop_back();
+            continue;
+        }
+        stack.back().second++;
+
+        uint32_t g = faces[f].neighbor[edge];
+        if (visitStamp[g] != stamp) {
+            visitStamp[g] = stamp;
+            visibility[g] = faces[g].normal.dot(p) - faces[g].offset > epsilon;
+            if (visibility[g]) {
+                visible.push_back(g);
+                stack.push_back({g, 0});
+                continue;
+            }
+        }
+        if (!visibility[g]) horizon.push_back({f, (uint32_t)edge});
+    }
+
+    // cone of new faces from the horizon to the eye point
+    std::vector<uint32_t> created;
+    std::unordered_map<uint32_t, uint32_t> startingAt;
+    for (const auto& h : horizon) {
+        const HullFace& f = faces[h.first];
+        uint32_t a = f.v[h.second], b = f.v[(h.second + 1) % 3];
+        uint32_t outer = f.neighbor[h.second];
+
+        uint32_t g = addFace(a, b, eye);
+        faces[g].neighbor[0] = outer;
+        for (int k = 0; k < 3; k++) {
+            if (faces[outer].v[k] == b && faces[outer].v[(k + 1) % 3] == a) faces[outer].neighbor[k] = g;
+        }
+
+        startingAt[a] = g;
+        created.push_back(g);
+    }
+    for (uint32_t g : created) {
+        HullFace& f = faces[g];
+        f.neighbor[1] = startingAt[f.v[1]];
+        faces[f.neighbor[1]].neighbor[2] = g;
+    }
+
+    // hand the outside points of the removed faces to the new faces
+    for (uint32_t f : visible) {
+        faces[f].alive = false;
+        std::vector<uint32_t> outside;
+        outside.swap(faces[f].outside);
+        for (uint32_t i : outside) {
+            if (i != eye) assign(i, created);
+        }
+    }
+
+    for (uint32_t g : created) {
+        if (!faces[g].outside.empty()) pending.push_back(g);
+    }
+}
+
+bool Quickhull::build() {
+    if (!initialSimplex()) return false;
+
+    while (!pending.empty()) {
+        uint32_t f = pending.back();
+        pending.pop_back();
+
+        if (faces[f].alive && !faces[f].outside.empty()) addPoint(f);
+    }
+
+    return true;
+}
+
+void Quickhull::hullVertices(uint32_t base, std::vector<uint32_t>& indices) const {
+    std::vector<bool> used(n, false);
+    for (const HullFace& f : faces) {
+        if (!f.alive) continue;
+        for (int k = 0; k < 3; k++) used[f.v[k]] = true;
+    }
+
+    for (uint32_t i = 0; i < n; i++) {
+        if (used[i]) indices.push_back(base + i);
+    }
+}
+
+void Quickhull::extract(ConvexHull& hull) const {
+    hull.clear();
+
+    // number the hull vertices in input order
+    hullVertices(0, hull.vertexIndices);
+    std::unordered_map<uint32_t, uint32_t> local;
+    for (uint32_t i : hull.vertexIndices) {
+        local[i] = (uint32_t)hull.vertices.size();
+        hull.vertices.push_back(point(i));
+    }
+
+    for (const HullFace& f : faces) {
+        if (!f.alive) continue;
+        for (int k = 0; k < 3; k++) hull.triangles.push_back(local[f.v[k]]);
+    }
+}
+
+} // namespace
+
+/**
+ * Default constructor for ConvexHull.
+ * Initializes an empty hull.
+ */
+ConvexHull::ConvexHull() {
+}
+
+/**
+ * Functionality: Computes the convex hull of a set of points with quickhull.
+ * Parameter:
+ *     points: const PositionBuffer&, the points.
+ * Returns:
+ *     bool: Returns true if the hull was built, false if there are fewer than four points or the
+ *           points are coplanar, in which case the hull is left empty.
+ */
+bool ConvexHull::compute(const PositionBuffer& points) {
+    Quickhull quickhull(points, 0, points.size());
+
+    if (!quickhull.build()) {
+        clear();
+        return false;
+    }
+
+    quickhull.extract(*this);
+
+    return true;
+}
+
+/**
+ * Functionality: Computes the convex hull of a set of points by divide and conquer. The points are
+ * split in fixed blocks whose hulls are built in parallel, then the hull of the block hull vertices
+ * is built. Points inside a block hull cannot be on the hull of the whole set, so the final step
+ * only sees a small fraction of the points on dense inputs.
+ * Parameter:
+ *     points: const PositionBuffer&, the points.
+ *     threads: int, the number of threads to use, 0 for all hardware threads. The hull does not
+ *              depend on the thread count.
+ * Returns:
+ *     bool: Returns true if the hull was built, false if there are fewer than four points or the
+ *           points are coplanar, in which case the hull is left empty.
+ */
+bool ConvexHull::compute(const PositionBuffer& points, int threads) {
+    ScopedTimer timer("ConvexHull::compute");
+    timer.addElements(points.size());
+
+    size_t n = points.size();
+    size_t blocks = (n + blockSize - 1) / blockSize;
+    if (blocks < 2) return compute(points);
+
+    std::vector<std::vector<uint32_t>> candidates(blocks);
+    ThreadPool::global().parallelFor(blocks, [&](size_t b) {
+        size_t begin = b * blockSize;
+        size_t end = std::min(n, begin + blockSize);
+
+        Quickhull quickhull(points, begin, end);
+        if (quickhull.build()) {
+            quickhull.hullVertices((uint32_t)begin, candidates[b]);
+        } else {
+            // a flat block keeps all its points
+            for (size_t i = begin; i < end; i++) candidates[b].push_back((uint32_t)i);
+        }
+    }, ThreadPool::resolveThreadCount(threads));
+
+    // hull of the surviving points, in input order
+    PositionBuffer merged;
+    std::vector<uint32_t> mergedIndices;
+    for (const std::vector<uint32_t>& block : candidates) {
+        for (uint32_t i : block) {
+            merged.push_back(points.get(i));
+            mergedIndices.push_back(i);
+        }
+    }
+
+    if (!compute(merged)) return false;
+
+    for (uint32_t& i : vertexIndices) {
+        i = mergedIndices[i];
+    }
+
+    return true;
+}
+
+/**
+ * Functionality: Computes the normal of a hull triangle.
+ * Parameter:
+ *     f: size_t, the index of the triangle.
+ * Returns:
+ *     Eigen::Vector3d: The outward unit normal of the triangle.
+ */
+Eigen::Vector3d ConvexHull::faceNormal(size_t f) const {
+    Eigen::Vector3d a = vertices.get(triangles[3*f]);
+    Eigen::Vector3d b = vertices.get(triangles[3*f + 1]);
+    Eigen::Vector3d c = vertices.get(triangles[3*f + 2]);
+
+    return (b - a).cross(c - a).normalized();
+}
+
+/**
+ * Functionality: Removes the hull.
+ */
+void ConvexHull::clear() {
+    vertices.clear();
+    vertexIndices.clear();
+    triangles.clear();
+}
@@ -0,0 +1,215 @@
+#include "Diagnostics.h"
+
+#include <algorithm>
+#include <mutex>
+#include <sstream>
+
+std::atomic<int> Log::threshold(LogOff);
+
+namespace {
+
+const char* levelNames[] = {"debug", "info", "warning", "error", "off"};
+
+// writes a message to std::cerr, prefixed like the messages of the command line tool
+void standardErrorSink(LogLevel level, const std::string& message) {
+    static const char* prefixes[] = {"Debug: ", "Info: ", "Warning: ", "Error: ", ""};
+    std::cerr << prefixes[level] << message << '\n';
+}
+
+// the sink and the lock that guards replacing it
+struct SinkData {
+    std::mutex mutex;
+    LogSink sink = standardErrorSink;
+};
+
+SinkData& sinkData() {
+    static SinkData* data = new SinkData();
+    return *data;
+}
+
+// writes the count, code and kept indices of an entry, followed by "..." if indices were dropped
+void writeEntry(std::ostream& out, const DiagnosticEntry& entry) {
+    out << entry.count << ' ' << entry.code << ':';
+    for (size_t i = 0; i < entry.indices.size(); i++) {
+        out << (i > 0 ? ", " : " ") << entry.indices[i];
+    }
+    if (entry.count > entry.indices.size()) out << ", ...";
+}
+
+} // namespace
+
+/**
+ * Functionality: Sets the least severe level that reaches the sink. LogOff, the default, drops every
+ * message.
+ * Parameter:
+ *     level: LogLevel, the level.
+ */
+void Log::setLevel(LogLevel level) {
+    threshold.store(level, std::memory_order_relaxed);
+}
+
+/**
+ * Functionality: Replaces the sink that receives the enabled messages.
+ * Parameter:
+ *     sink: LogSink, the new sink, empty to write to std::cerr again.
+ */
+void Log::setSink(LogSink sink) {
+    SinkData& data = sinkData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+    data.sink = sink ? sink : standardErrorSink;
+}
+
+/**
+ * Functionality: Passes a message to the sink if its level is enabled. The sink is called without a lock
+ * held, so that a sink may take locks of its own, and may be called from several threads at once.
+ * Parameter:
+ *     level: LogLevel, the severity of the message.
+ *     message: const std::string&, the message without prefix or trailing newline.
+ */
+void Log::write(LogLevel level, const std::string& message) {
+    if (level == LogOff || !isEnabled(level)) return;
+
+    LogSink sink;
+    {
+        SinkData& data = sinkData();
+        std::lock_guard<std::mutex> lock(data.mutex);
+        sink = data.sink;
+    }
+    sink(level, message);
+}
+
+/**
+ * Functionality: Looks up a level by name.
+ * Parameter:
+ *     name: const std::string&, one of debug, info, warning, error and off.
+ *     level: LogLevel&, receives the level.
+ * Returns:
+ *     bool: Returns false if the name is unknown.
+ */
+bool Log::parseLevel(const std::string& name, LogLevel& level) {
+    for (int i = LogDebug; i <= LogOff; i++) {
+        if (name == levelNames[i]) {
+            level = (LogLevel)i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Functionality: Counts one occurrence of a problem. Only the first maxIndices indices of a problem are
+ * kept, so a check can call this for every bad element.
+ * Parameter:
+ *     code: const char*, what is wrong, e.g. "isolated_vertex".
+ *     level: LogLevel, LogError if the problem makes the operation fail, LogWarning otherwise.
+ *     index: int, the index of the offending element.
+ */
+void DiagnosticsReport::add(const char* code, LogLevel level, int index) {
+    DiagnosticEntry& entry = findEntry(code, level);
+    if (entry.indices.size() < maxIndices) entry.indices.push_back(index);
+    entry.count++;
+}
+
+/**
+ * Functionality: Adds the counts and indices of another report to this one.
+ * Parameter:
+ *     report: const DiagnosticsReport&, the report to add.
+ */
+void DiagnosticsReport::merge(const DiagnosticsReport& report) {
+    for (const DiagnosticEntry& other : report.entries) {
+        DiagnosticEntry& entry = findEntry(other.code.c_str(), other.level);
+        for (size_t i = 0; i < other.indices.size() && entry.indices.size() < maxIndices; i++) {
+            entry.indices.push_back(other.indices[i]);
+        }
+        entry.count += other.count;
+    }
+}
+
+/**
+ * Functionality: Finds the entry of a problem, adding an empty one if it is new.
+ * Parameter:
+ *     code: const char*, the problem.
+ *     level: LogLevel, raises the level of the entry if it is more severe.
+ * Returns:
+ *     DiagnosticEntry&: The entry, valid until the next entry is added.
+ */
+DiagnosticEntry& DiagnosticsReport::findEntry(const char* code, LogLevel level) {
+    for (DiagnosticEntry& entry : entries) {
+        if (entry.code == code) {
+            entry.level = std::max(entry.level, level);
+            return entry;
+        }
+    }
+
+    entries.push_back(DiagnosticEntry());
+    entries.back().code = code;
+    entries.back().level = level;
+
+    return entries.back();
+}
+
+/**
+ * Functionality: Drops all entries.
+ */
+void DiagnosticsReport::clear() {
+    entries.clear();
+}
+
+/**
+ * Functionality: Checks if a problem made the operation fail.
+ * Returns:
+ *     bool: Returns true if an entry has level LogError.
+ */
+bool DiagnosticsReport::hasErrors() const {
+    for (const DiagnosticEntry& entry : entries) {
+        if (entry.level >= LogError) return true;
+    }
+
+    return false;
+}
+
+/**
+ * Functionality: Returns the occurrences of a problem.
+ * Parameter:
+ *     code: const std::string&, the problem.
+ * Returns:
+ *     size_t: The count, 0 if the problem was not found.
+ */
+size_t DiagnosticsReport::count(const std::string& code) const {
+    for (const DiagnosticEntry& entry : entries) {
+        if (entry.code == code) return entry.count;
+    }
+
+    return 0;
+}
+
+/**
+ * Functionality: Formats each entry as the count, the code and the kept indices, followed by
+ * "..." if more elements were found than kept.
+ * Returns:
+ *     std::string: The entries, separated by semicolons.
+ */
+std::string DiagnosticsReport::summary() const {
+    std::ostringstream out;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (i > 0) out << "; ";
+        writeEntry(out, entries[i]);
+    }
+
+    return out.str();
+}
+
+/**
+ * Functionality: Writes one line per entry to the log at the level of the entry. Nothing is formatted
+ * unless the level is enabled.
+ */
+void DiagnosticsReport::log() const {
+    for (const DiagnosticEntry& entry : entries) {
+        if (!Log::isEnabled(entry.level)) continue;
+
+        std::ostringstream out;
+        writeEntry(out, entry);
+        Log::write(entry.level, out.str());
+    }
+}
@@ -1,16 +1,18 @@
 #include "Edge.h"
-#include "HalfEdge.h"
-#include "Vertex.h"
+#include "Mesh.h"
 
 /**
  * Functionality: Calculates the length of the edge.
+ * Parameter:
+ *     mesh: const Mesh&, the mesh owning the edge.
  * Returns:
  *     double: Returns the length of the edge.
  */
-double Edge::length() const
+double Edge::length(const Mesh& mesh) const
 {
-    Eigen::Vector3d a = he->vertex->position;
-    Eigen::Vector3d b = he->flip->vertex->position;
+    const HalfEdge& h = mesh.halfEdges[he];
+    Eigen::Vector3d a = mesh.vertices[h.vertex].position;
+    Eigen::Vector3d b = mesh.vertices[mesh.halfEdges[h.flip].vertex].position;
 
     return (b-a).norm();
 }
\ No newline at end of file
@@ -1,41 +1,50 @@
 #include "Face.h"
-#include "HalfEdge.h"
-#include "Vertex.h"
+#include "Mesh.h"
 
 /**
  * Functionality: Checks if the face is a boundary face.
+ * Parameter:
+ *     mesh: const Mesh&, the mesh owning the face.
  * Returns:
  *     bool: Returns true if the face is a boundary face, false otherwise.
  */
-bool Face::isBoundary() const
+bool Face::isBoundary(const Mesh& mesh) const
 {
-    return he->onBoundary;
+    return mesh.halfEdges[he].onBoundary;
 }
 
 /**
  * Functionality: Calculates the area of the face.
+ * Parameter:
+ *     mesh: const Mesh&, the mesh owning the face.
  * Returns:
  *     double: Returns the area of the face.
  */
-double Face::area() const
+double Face::area(const Mesh& mesh) const
 {
-    if (isBoundary()) {
+    if (isBoundary(mesh)) {
         return 0;
     }
 
-    return 0.5 * normal().norm();
+    return 0.5 * normal(mesh).norm();
 }
 
 /**
  * Functionality: Calculates the normal of the face.
+ * Parameter:
+ *     mesh: const Mesh&, the mesh owning the face.
  * Returns:
  *     Eigen::Vector3d: Returns the normal of the face.
  */
-Eigen::Vector3d Face::normal() const
+Eigen::Vector3d Face::normal(const Mesh& mesh) const
 {
-    Eigen::Vector3d a = he->vertex->position;
-    Eigen::Vector3d b = he->next->vertex->position;
-    Eigen::Vector3d c = he->next->next->vertex->position;
+    const HalfEdge& h0 = mesh.halfEdges[he];
+    const HalfEdge& h1 = mesh.halfEdges[h0.next];
+    const HalfEdge& h2 = mesh.halfEdges[h1.next];
+
+    Eigen::Vector3d a = mesh.vertices[h0.vertex].position;
+    Eigen::Vector3d b = mesh.vertices[h1.vertex].position;
+    Eigen::Vector3d c = mesh.vertices[h2.vertex].position;
 
     Eigen::Vector3d v1 = a - b;
     Eigen::Vector3d v2 = c - b;
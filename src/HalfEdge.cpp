@@ -1 +1,34 @@
 #include "HalfEdge.h"
+#include "Mesh.h"
+
+/**
+ * Functionality: Looks up the uv associated with the vertex at the tail of the halfedge.
+ * Parameter:
+ *     mesh: const Mesh&, the mesh owning the halfedge.
+ * Returns:
+ *     Eigen::Vector3d: Returns the uv, or zero if the halfedge has none.
+ */
+Eigen::Vector3d HalfEdge::uvCoordinates(const Mesh& mesh) const
+{
+    if (uv == InvalidId) {
+        return Eigen::Vector3d::Zero();
+    }
+
+    return mesh.uvs[uv];
+}
+
+/**
+ * Functionality: Looks up the normal associated with the vertex at the tail of the halfedge.
+ * Parameter:
+ *     mesh: const Mesh&, the mesh owning the halfedge.
+ * Returns:
+ *     Eigen::Vector3d: Returns the normal, or zero if the halfedge has none.
+ */
+Eigen::Vector3d HalfEdge::vertexNormal(const Mesh& mesh) const
+{
+    if (normal == InvalidId) {
+        return Eigen::Vector3d::Zero();
+    }
+
+    return mesh.normals[normal];
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "Hash.h"
+
+#include <cstring>
+
+namespace {
+
+const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t prime3 = 0x165667B19E3779F9ULL;
+const uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+uint64_t rotateLeft(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// reads 8 bytes that need not be aligned
+uint64_t read64(const unsigned char* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// reads 4 bytes that need not be aligned
+uint32_t read32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// mixes 8 bytes of input into one of the four lanes
+uint64_t round(uint64_t lane, uint64_t input) {
+    lane += input * prime2;
+    lane = rotateLeft(lane, 31);
+    return lane * prime1;
+}
+
+// folds a lane into the hash
+uint64_t mergeRound(uint64_t hash, uint64_t lane) {
+    hash ^= round(0, lane);
+    return hash * prime1 + prime4;
+}
+
+} // namespace
+
+/**
+ * Functionality: Hashes a byte range with XXH64. Four independent lanes consume 32 bytes per
+ * iteration, then the tail is mixed in and the result is avalanched.
+ * Parameter:
+ *     data: const void*, the first byte.
+ *     size: size_t, the number of bytes.
+ *     seed: uint64_t, changes the hash of every input, so hashes can be chained.
+ * Returns:
+ *     uint64_t: The hash.
+ */
+uint64_t Hash::compute(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+    uint64_t hash;
+
+    if (size >= 32) {
+        uint64_t lanes[4] = {seed + prime1 + prime2, seed + prime2, seed, seed - prime1};
+        const unsigned char* limit = end - 32;
+        do {
+            for (int i = 0; i < 4; i++) lanes[i] = round(lanes[i], read64(p + 8 * i));
+            p += 32;
+        } while (p <= limit);
+
+        hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) +
+               rotateLeft(lanes[3], 18);
+        for (int i = 0; i < 4; i++) hash = mergeRound(hash, lanes[i]);
+    } else {
+        hash = seed + prime5;
+    }
+
+    hash += (uint64_t)size;
+
+    for (; p + 8 <= end; p += 8) {
+        hash ^= round(0, read64(p));
+        hash = rotateLeft(hash, 27) * prime1 + prime4;
+    }
+    if (p + 4 <= end) {
+        hash ^= (uint64_t)read32(p) * prime1;
+        hash = rotateLeft(hash, 23) * prime2 + prime3;
+        p += 4;
+    }
+    for (; p < end; p++) {
+        hash ^= (*p) * prime5;
+        hash = rotateLeft(hash, 11) * prime1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= prime2;
+    hash ^= hash >> 29;
+    hash *= prime3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
@@ -0,0 +1,39 @@
+#include "Json.h"
+
+#include <cstdio>
+
+/**
+ * Functionality: Quotes a string for JSON. Quotes and backslashes are escaped, line breaks and tabs
+ * are written as \n, \r and \t and the other control characters as \u00XX. Other bytes, including
+ * UTF-8 sequences, are copied.
+ * Parameter:
+ *     s: const std::string&, the string.
+ * Returns:
+ *     std::string: The string literal, with its quotes.
+ */
+std::string Json::quote(const std::string& s) {
+    std::string quoted;
+    quoted.reserve(s.size() + 2);
+    quoted += '"';
+
+    for (unsigned char c : s) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += (char)c;
+        } else if (c == '\n') {
+            quoted += "\\n";
+        } else if (c == '\r') {
+            quoted += "\\r";
+        } else if (c == '\t') {
+            quoted += "\\t";
+        } else if (c < 0x20 || c == 0x7f) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            quoted += escaped;
+        } else {
+            quoted += (char)c;
+        }
+    }
+
+    return quoted + '"';
+}
@@ -0,0 +1,78 @@
+#include "MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Default constructor for MappedFile.
+ * Initializes an unmapped file.
+ */
+MappedFile::MappedFile() : buffer(nullptr),
+                           length(0),
+                           opened(false) {
+}
+
+/**
+ * Destructor for MappedFile.
+ * Releases the mapping if one is held.
+ */
+MappedFile::~MappedFile() {
+    close();
+}
+
+/**
+ * Functionality: Maps a file read-only into the address space of the process.
+ * Parameter:
+ *     fileName: const std::string&, the name of the file to map.
+ * Returns:
+ *     bool: Returns true if the file is mapped (empty files map to a null buffer of size 0), false otherwise.
+ */
+bool MappedFile::open(const std::string& fileName) {
+    close();
+
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        ::close(fd);
+        return false;
+    }
+
+    length = (size_t)st.st_size;
+    if (length > 0) {
+        void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            length = 0;
+            return false;
+        }
+
+        // the parsers walk the file front to back
+        madvise(addr, length, MADV_SEQUENTIAL);
+        buffer = static_cast<const char*>(addr);
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    opened = true;
+
+    return true;
+}
+
+/**
+ * Functionality: Unmaps the file and resets the buffer.
+ */
+void MappedFile::close() {
+    if (buffer) {
+        munmap(const_cast<char*>(buffer), length);
+    }
+
+    buffer = nullptr;
+    length = 0;
+    opened = false;
+}
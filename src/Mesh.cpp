@@ -1,6 +1,16 @@
 #include "Mesh.h"
 
+#include "Diagnostics.h"
 #include "MeshIO.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+#include <fstream>
+#include <type_traits>
+
+// connectivity holds no pointers, so element arrays can be copied and serialized byte for byte
+static_assert(std::is_trivially_copyable<HalfEdge>::value, "HalfEdge must be trivially copyable");
+static_assert(std::is_trivially_copyable<Edge>::value, "Edge must be trivially copyable");
+static_assert(std::is_trivially_copyable<Face>::value, "Face must be trivially copyable");
 
 /**
  * Default constructor for Mesh.
@@ -11,7 +21,8 @@ Mesh::Mesh() {
 
 /**
  * Copy constructor for Mesh.
- * Creates a new Mesh object as a copy of an existing Mesh.
+ * Creates a new Mesh object as a copy of an existing Mesh. Connectivity is index based,
+ * so the copy is independent of the original.
  * Parameter:
  *     mesh: const Mesh&, reference to the Mesh object to be copied.
  */
@@ -20,46 +31,138 @@ Mesh::Mesh(const Mesh& mesh) {
 }
 
 /**
- * Functionality: Reads mesh data from a file and normalizes the mesh.
+ * Functionality: Reads mesh data from a memory-mapped file and normalizes the mesh. The problems found
+ * are kept in diagnostics and logged once the mesh is read.
  * Parameter:
  *     fileName: const std::string&, the name of the file to read from.
+ *     threads: int, the number of threads used to parse and validate the file, 0 for all hardware threads.
+ *              The parsed data is identical for every thread count.
+ *     validate: bool, true to look for isolated and non-manifold elements with MeshValidator.
  * Returns:
  *     bool: Returns true if the file is successfully read, false otherwise.
  */
-bool Mesh::read(const std::string& fileName) {
-    std::ifstream in(fileName.c_str());
+bool Mesh::read(const std::string& fileName, int threads, bool validate) {
+    ScopedTimer timer("Mesh::read");
+    MappedFile in;
 
-    if (!in.is_open()) {
-        std::cerr << "Error: Could not open file for reading" << std::endl;
+    diagnostics.clear();
+    if (!in.open(fileName)) {
+        Log::write(LogError, "Could not open " + fileName + " for reading");
         return false;
     }
 
     bool readSuccessful = false;
-    if ((readSuccessful = MeshIO::read(in, *this))) {
+    if ((readSuccessful = MeshIO::read(in.data(), in.size(), *this, threads, validate))) {
         normalize();
+        updatePositionBuffer();
+        updateTriangleBuffer();
+        edgeVertices.clear();
+        vertexNormals.clear();
+        timer.addElements(triangles.size() / 3);
     }
+    diagnostics.log();
 
     return readSuccessful;
 }
 
 /**
- * Functionality: Writes mesh data to a file.
+ * Functionality: Writes mesh data to a file in obj format. The mesh is not modified.
  * Parameter:
  *     fileName: const std::string&, the name of the file to write to.
+ *     threads: int, the number of threads used to format the file, 0 for all hardware threads.
+ *              The file is identical for every thread count.
  * Returns:
- *     bool: Returns false as the method currently does not implement successful write checking.
+ *     bool: Returns true if the file is successfully written, false otherwise.
  */
-bool Mesh::write(const std::string& fileName) {
-    std::ofstream out(fileName.c_str());
+bool Mesh::write(const std::string& fileName, int threads) const {
+    std::ofstream out(fileName.c_str(), std::ios::binary);
 
     if (!out.is_open()) {
-        std::cerr << "Error: Could not open file for writing" << std::endl;
+        Log::write(LogError, "Could not open " + fileName + " for writing");
         return false;
     }
 
-    MeshIO::write(out, *this);
+    if (!MeshIO::write(out, *this, threads)) {
+        Log::write(LogError, "Could not write " + fileName);
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Functionality: Copies the vertex positions into the position buffer so that it matches vertices.
+ */
+void Mesh::updatePositionBuffer() {
+    ScopedTimer timer("Mesh::updatePositionBuffer");
+    positions.assign(vertices);
+
+    timer.addElements(positions.size());
+    timer.addBytes(3 * positions.x.capacity() * sizeof(double));
+}
+
+/**
+ * Functionality: Fills the triangle buffer by walking the halfedge loop of every face. A face with
+ * n sides is split into the n - 2 triangles of a fan around its first vertex, in face order. The
+ * faces that close boundary loops are not part of the surface and are skipped.
+ */
+void Mesh::updateTriangleBuffer() {
+    ScopedTimer timer("Mesh::updateTriangleBuffer");
+    triangles.clear();
+    triangles.reserve(3 * faces.size());
+
+    for (const Face& f : faces) {
+        if (f.isBoundary(*this)) continue;
+
+        HalfEdgeId first = f.he;
+        HalfEdgeId he = halfEdges[first].next;
+
+        while (halfEdges[he].next != first) {
+            triangles.push_back(halfEdges[first].vertex);
+            triangles.push_back(halfEdges[he].vertex);
+            triangles.push_back(halfEdges[halfEdges[he].next].vertex);
+            he = halfEdges[he].next;
+        }
+    }
+
+    timer.addElements(triangles.size() / 3);
+    timer.addBytes(triangles.capacity() * sizeof(uint32_t));
+}
+
+/**
+ * Functionality: Fills the edge buffer with the vertices at the two ends of every edge, in edge order.
+ */
+void Mesh::updateEdgeBuffer() {
+    edgeVertices.resize(2 * edges.size());
+
+    for (size_t e = 0; e < edges.size(); e++) {
+        const HalfEdge& he = halfEdges[edges[e].he];
+        edgeVertices[2*e] = he.vertex;
+        edgeVertices[2*e + 1] = halfEdges[he.flip].vertex;
+    }
+}
+
+/**
+ * Functionality: Computes the normal of every vertex as the sum of the normals of its triangles,
+ * weighted by their areas, scaled to unit length. Isolated vertices get a zero normal.
+ */
+void Mesh::updateVertexNormals() {
+    vertexNormals.assign(vertices.size(), Eigen::Vector3d::Zero());
+
+    for (size_t t = 0; t + 2 < triangles.size(); t += 3) {
+        const Eigen::Vector3d& a = vertices[triangles[t]].position;
+        const Eigen::Vector3d& b = vertices[triangles[t + 1]].position;
+        const Eigen::Vector3d& c = vertices[triangles[t + 2]].position;
 
-    return false;
+        // the cross product is twice the area times the unit normal
+        Eigen::Vector3d n = (b - a).cross(c - a);
+        for (int k = 0; k < 3; k++) vertexNormals[triangles[t + k]] += n;
+    }
+
+    for (Eigen::Vector3d& n : vertexNormals) {
+        double length = n.norm();
+        if (length > 0) n /= length;
+    }
 }
 
 /**
@@ -67,6 +170,9 @@ bool Mesh::write(const std::string& fileName) {
  * This method computes the center of mass of the mesh, translates the mesh to the origin, and rescales it.
  */
 void Mesh::normalize() {
+    ScopedTimer timer("Mesh::normalize");
+    timer.addElements(vertices.size());
+
     // compute center of mass
     Eigen::Vector3d cm = Eigen::Vector3d::Zero();
     for (VertexCIter v = vertices.begin(); v != vertices.end(); v++) {
@@ -90,3 +196,26 @@ void Mesh::normalize() {
         v->position /= rMax;
     }
 }
+
+/**
+ * Functionality: Exchanges the contents of two meshes. The arrays change owner without being copied,
+ * so pointers into them stay valid and follow them to the other mesh.
+ * Parameter:
+ *     mesh: Mesh&, the mesh to exchange contents with.
+ */
+void Mesh::swap(Mesh& mesh) {
+    halfEdges.swap(mesh.halfEdges);
+    vertices.swap(mesh.vertices);
+    uvs.swap(mesh.uvs);
+    normals.swap(mesh.normals);
+    edges.swap(mesh.edges);
+    faces.swap(mesh.faces);
+    boundaries.swap(mesh.boundaries);
+    positions.x.swap(mesh.positions.x);
+    positions.y.swap(mesh.positions.y);
+    positions.z.swap(mesh.positions.z);
+    triangles.swap(mesh.triangles);
+    edgeVertices.swap(mesh.edgeVertices);
+    vertexNormals.swap(mesh.vertexNormals);
+    std::swap(diagnostics, mesh.diagnostics);
+}
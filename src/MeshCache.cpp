@@ -0,0 +1,368 @@
+#include "MeshCache.h"
+
+#include "BoundingBox.h"
+#include "Diagnostics.h"
+#include "Hash.h"
+#include "MappedFile.h"
+#include "Mesh.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/mman.h>
+#include <thread>
+#include <unistd.h>
+
+static_assert(sizeof(Eigen::Vector3d) == 3 * sizeof(double), "Eigen::Vector3d must be three packed doubles");
+
+namespace {
+
+// arrays of the file, in file order
+enum Section {
+    Vertices,
+    HalfEdges,
+    Uvs,
+    Normals,
+    Edges,
+    Faces,
+    Boundaries,
+    Triangles,
+    SectionCount
+};
+
+// bytes per element of every section
+const size_t elementSizes[SectionCount] = {
+    sizeof(Vertex), sizeof(HalfEdge), sizeof(Eigen::Vector3d), sizeof(Eigen::Vector3d), sizeof(Edge),
+    sizeof(Face), sizeof(HalfEdgeId), sizeof(uint32_t)};
+
+// bytes of a section hashed as one block of the checksum, small enough to stay in cache while a block
+// is copied, hashed and checked, and a multiple of every element size
+constexpr size_t checksumBlockSize = 3 << 16;
+
+const char magic[8] = {'O', 'M', 'C', 'A', 'C', 'H', 'E', '\0'};
+
+// written as is, reads back differently on a machine of the other byte order
+const uint32_t byteOrderMark = 0x01020304;
+
+// fixed size start of the file, followed by the sections at 8 byte aligned offsets
+struct CacheHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;
+    uint32_t elementSizes[SectionCount];
+    uint64_t counts[SectionCount];
+    // axis-aligned min and max, then the six oriented points of the PCA box
+    double boxes[24];
+    uint64_t fileSize;
+    // hash of the header with this field zeroed, seeding the hash of the block hashes of the sections
+    uint64_t checksum;
+};
+
+size_t alignUp(size_t offset) {
+    return (offset + 7) & ~(size_t)7;
+}
+
+// computes the offset of every section and the file size, false if a count cannot fit in limit bytes
+bool computeLayout(const uint64_t counts[], size_t limit, size_t offsets[], size_t& fileSize) {
+    size_t offset = alignUp(sizeof(CacheHeader));
+    for (int s = 0; s < SectionCount; s++) {
+        if (counts[s] > limit / elementSizes[s]) return false;
+        offsets[s] = offset;
+        offset = alignUp(offset + counts[s] * elementSizes[s]);
+    }
+    fileSize = offset;
+
+    return true;
+}
+
+// hashes the header and then the block hashes of the sections in file order
+uint64_t combineChecksum(const CacheHeader& header, const std::vector<uint64_t>& blockHashes) {
+    CacheHeader blank = header;
+    blank.checksum = 0;
+
+    uint64_t hash = Hash::compute(&blank, sizeof(blank));
+    return Hash::compute(blockHashes.data(), blockHashes.size() * sizeof(uint64_t), hash);
+}
+
+// hashes the sections in blocks on threads threads and combines the block hashes with the header
+uint64_t computeChecksum(const CacheHeader& header, const char* const sections[], int threads) {
+    std::vector<std::pair<int, size_t>> blocks;
+    for (int s = 0; s < SectionCount; s++) {
+        for (size_t offset = 0; offset < header.counts[s] * elementSizes[s]; offset += checksumBlockSize) {
+            blocks.push_back(std::make_pair(s, offset));
+        }
+    }
+
+    std::vector<uint64_t> blockHashes(blocks.size());
+    ThreadPool::global().parallelFor(blocks.size(), [&](size_t b) {
+        int s = blocks[b].first;
+        size_t offset = blocks[b].second;
+        size_t bytes = std::min(checksumBlockSize, header.counts[s] * elementSizes[s] - offset);
+        blockHashes[b] = Hash::compute(sections[s] + offset, bytes);
+    }, ThreadPool::resolveThreadCount(threads));
+
+    return combineChecksum(header, blockHashes);
+}
+
+// asks for huge pages behind the whole 2 MB pages of an allocation that is not touched yet, faulting
+// the arrays of a large mesh in is then several times faster; a hint only, ignored where unsupported
+void adviseHugePages(const void* data, size_t bytes) {
+#ifdef MADV_HUGEPAGE
+    const uintptr_t hugePageSize = (uintptr_t)1 << 21;
+    uintptr_t begin = (reinterpret_cast<uintptr_t>(data) + hugePageSize - 1) & ~(hugePageSize - 1);
+    uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes) & ~(hugePageSize - 1);
+    if (end > begin) madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+#endif
+}
+
+// empties a vector and reserves count elements on huge pages, to be appended without zeroing them first
+template <typename T>
+void reserveArray(std::vector<T>& values, size_t count) {
+    values.clear();
+    values.reserve(count);
+    adviseHugePages(values.data(), count * sizeof(T));
+}
+
+// checks an index into an array of size elements, InvalidId is accepted where allowed
+bool inRange(uint32_t id, size_t size, bool allowInvalid = false) {
+    return id < size || (allowInvalid && id == InvalidId);
+}
+
+// copies a section into a vector of its elements one checksum block at a time, so that while a block
+// is in cache it is hashed onto blockHashes, if not null, and every element is passed to visit; false
+// if visit rejects an element
+template <typename T, typename Visit>
+bool copySection(const char* section, uint64_t count, std::vector<T>& values, std::vector<uint64_t>* blockHashes,
+                 Visit visit) {
+    static_assert(checksumBlockSize % sizeof(T) == 0, "checksum blocks must hold whole elements");
+    const T* source = reinterpret_cast<const T*>(section);
+    const size_t blockCount = checksumBlockSize / sizeof(T);
+
+    reserveArray(values, count);
+    bool valid = true;
+    for (size_t begin = 0; begin < count; begin += blockCount) {
+        size_t end = std::min<size_t>(count, begin + blockCount);
+        values.insert(values.end(), source + begin, source + end);
+        if (blockHashes) blockHashes->push_back(Hash::compute(values.data() + begin, (end - begin) * sizeof(T)));
+        for (size_t i = begin; i < end; i++) {
+            valid &= visit(values[i]);
+        }
+    }
+
+    return valid;
+}
+
+} // namespace
+
+/**
+ * Functionality: Writes a mesh to a cache file. The file is written next to its final name under a name
+ * unique to the writer and renamed into place, so a reader never sees a partial cache and concurrent
+ * writers of the same cache do not mix their output.
+ * Parameter:
+ *     fileName: const std::string&, the cache file.
+ *     mesh: const Mesh&, the mesh, with its position and triangle buffers up to date.
+ *     threads: int, the number of threads used to fit the boxes and hash the arrays, 0 for all hardware
+ *              threads.
+ * Returns:
+ *     bool: Returns false if the file cannot be written.
+ */
+bool MeshCache::write(const std::string& fileName, const Mesh& mesh, int threads) {
+    PositionBuffer copy;
+    const PositionBuffer* positions = &mesh.positions;
+    if (positions->size() != mesh.vertices.size()) {
+        copy.assign(mesh.vertices);
+        positions = &copy;
+    }
+
+    BoundingBox axisAlignedBox, orientedBox;
+    axisAlignedBox.computeAxisAlignedBox(*positions, threads);
+    orientedBox.computeOrientedBox(*positions, threads);
+
+    CacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.byteOrder = byteOrderMark;
+    for (int s = 0; s < SectionCount; s++) {
+        header.elementSizes[s] = (uint32_t)elementSizes[s];
+    }
+
+    const char* sections[SectionCount] = {
+        reinterpret_cast<const char*>(mesh.vertices.data()),
+        reinterpret_cast<const char*>(mesh.halfEdges.data()),
+        reinterpret_cast<const char*>(mesh.uvs.data()),
+        reinterpret_cast<const char*>(mesh.normals.data()),
+        reinterpret_cast<const char*>(mesh.edges.data()),
+        reinterpret_cast<const char*>(mesh.faces.data()),
+        reinterpret_cast<const char*>(mesh.boundaries.data()),
+        reinterpret_cast<const char*>(mesh.triangles.data())};
+    const size_t counts[SectionCount] = {
+        mesh.vertices.size(), mesh.halfEdges.size(), mesh.uvs.size(), mesh.normals.size(), mesh.edges.size(),
+        mesh.faces.size(), mesh.boundaries.size(), mesh.triangles.size()};
+    for (int s = 0; s < SectionCount; s++) {
+        header.counts[s] = counts[s];
+    }
+
+    for (int i = 0; i < 3; i++) {
+        header.boxes[i] = axisAlignedBox.min[i];
+        header.boxes[3 + i] = axisAlignedBox.max[i];
+    }
+    for (size_t p = 0; p < orientedBox.orientedPoints.size() && p < 6; p++) {
+        for (int i = 0; i < 3; i++) header.boxes[6 + 3 * p + i] = orientedBox.orientedPoints[p][i];
+    }
+
+    size_t offsets[SectionCount], fileSize = 0;
+    computeLayout(header.counts, SIZE_MAX, offsets, fileSize);
+    header.fileSize = fileSize;
+    header.checksum = computeChecksum(header, sections, threads);
+
+    // the temporary name is unique to the process and thread, so concurrent writers do not collide
+    std::string tempName = fileName + "." + std::to_string(::getpid()) + "-" +
+                           std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    std::ofstream out(tempName.c_str(), std::ios::binary);
+    if (!out.is_open()) {
+        Log::write(LogError, "Could not open " + tempName + " for writing");
+        return false;
+    }
+
+    const char padding[8] = {};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    size_t offset = sizeof(header);
+    for (int s = 0; s < SectionCount; s++) {
+        out.write(padding, offsets[s] - offset);
+        size_t bytes = header.counts[s] * elementSizes[s];
+        out.write(sections[s], bytes);
+        offset = offsets[s] + bytes;
+    }
+    out.write(padding, fileSize - offset);
+    out.close();
+
+    if (!out || std::rename(tempName.c_str(), fileName.c_str()) != 0) {
+        Log::write(LogError, "Could not write mesh cache " + fileName);
+        std::remove(tempName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Functionality: Maps a cache file and copies its arrays into a mesh. The header is checked against
+ * this build and the section sizes against the file size before anything is copied. The arrays are
+ * then copied in blocks, and while a block is in cache it is hashed for the checksum, if verify is set,
+ * and its indices are range checked, so the file is read once. A cache read without verification may
+ * hold wrong values but never sends a traversal out of bounds.
+ * Parameter:
+ *     fileName: const std::string&, the cache file.
+ *     mesh: Mesh&, receives the mesh, normalized as when it was written.
+ *     axisAlignedBox: BoundingBox*, receives the stored axis-aligned box if not null.
+ *     orientedBox: BoundingBox*, receives the stored PCA box if not null.
+ *     verify: bool, whether the checksum is checked.
+ * Returns:
+ *     bool: Returns false if the file cannot be read or fails a check, the mesh and boxes are then
+ *           unchanged.
+ */
+bool MeshCache::read(const std::string& fileName, Mesh& mesh, BoundingBox* axisAlignedBox,
+                     BoundingBox* orientedBox, bool verify) {
+    MappedFile in;
+    if (!in.open(fileName)) {
+        Log::write(LogError, "Could not open " + fileName + " for reading");
+        return false;
+    }
+
+    CacheHeader header;
+    if (in.size() < sizeof(header)) {
+        Log::write(LogError, fileName + " is too short to be a mesh cache");
+        return false;
+    }
+    std::memcpy(&header, in.data(), sizeof(header));
+
+    bool layoutMatches = std::memcmp(header.magic, magic, sizeof(magic)) == 0 && header.version == version &&
+                         header.byteOrder == byteOrderMark;
+    for (int s = 0; s < SectionCount && layoutMatches; s++) {
+        layoutMatches = header.elementSizes[s] == elementSizes[s];
+    }
+    if (!layoutMatches) {
+        Log::write(LogError, fileName + " is not a mesh cache of version " + std::to_string(version) +
+                                 " for this platform");
+        return false;
+    }
+
+    size_t offsets[SectionCount], fileSize = 0;
+    if (!computeLayout(header.counts, in.size(), offsets, fileSize) || fileSize != in.size() ||
+        header.fileSize != in.size()) {
+        Log::write(LogError, "mesh cache " + fileName + " is truncated");
+        return false;
+    }
+
+    const char* sections[SectionCount];
+    for (int s = 0; s < SectionCount; s++) {
+        sections[s] = in.data() + offsets[s];
+    }
+
+    const uint64_t* counts = header.counts;
+    size_t nV = counts[Vertices], nH = counts[HalfEdges], nUv = counts[Uvs], nN = counts[Normals];
+    size_t nE = counts[Edges], nF = counts[Faces];
+    std::vector<uint64_t> blockHashes;
+    std::vector<uint64_t>* hashes = verify ? &blockHashes : nullptr;
+
+    // the position buffer is the only array not stored, it is gathered from the vertices as they are copied
+    Mesh loaded;
+    PositionBuffer& positions = loaded.positions;
+    reserveArray(positions.x, nV);
+    reserveArray(positions.y, nV);
+    reserveArray(positions.z, nV);
+
+    // every stored index must point into its array, so a consistent but hand-edited file cannot send the
+    // traversals out of bounds
+    bool valid = copySection(sections[Vertices], nV, loaded.vertices, hashes, [&](const Vertex& v) {
+        positions.x.push_back(v.position.x());
+        positions.y.push_back(v.position.y());
+        positions.z.push_back(v.position.z());
+        return inRange(v.he, nH, true);
+    });
+    valid &= copySection(sections[HalfEdges], nH, loaded.halfEdges, hashes, [&](const HalfEdge& h) {
+        return inRange(h.next, nH) & inRange(h.flip, nH) & inRange(h.vertex, nV) & inRange(h.edge, nE) &
+               inRange(h.face, nF) & inRange(h.uv, nUv, true) & inRange(h.normal, nN, true);
+    });
+    valid &= copySection(sections[Uvs], nUv, loaded.uvs, hashes, [](const Eigen::Vector3d&) { return true; });
+    valid &= copySection(sections[Normals], nN, loaded.normals, hashes, [](const Eigen::Vector3d&) { return true; });
+    valid &= copySection(sections[Edges], nE, loaded.edges, hashes, [&](const Edge& e) { return inRange(e.he, nH); });
+    valid &= copySection(sections[Faces], nF, loaded.faces, hashes, [&](const Face& f) { return inRange(f.he, nH); });
+    valid &= copySection(sections[Boundaries], counts[Boundaries], loaded.boundaries, hashes,
+                         [&](HalfEdgeId he) { return inRange(he, nH); });
+    valid &= copySection(sections[Triangles], counts[Triangles], loaded.triangles, hashes,
+                         [&](uint32_t v) { return inRange(v, nV); });
+    valid &= counts[Triangles] % 3 == 0;
+
+    if (verify && combineChecksum(header, blockHashes) != header.checksum) {
+        Log::write(LogError, "mesh cache " + fileName + " is corrupt, checksum mismatch");
+        return false;
+    }
+    if (!valid) {
+        Log::write(LogError, "mesh cache " + fileName + " has indices out of range");
+        return false;
+    }
+
+    // loaded has no edge buffer, vertex normals or diagnostics, so those of the old mesh are dropped
+    mesh.swap(loaded);
+
+    if (axisAlignedBox) {
+        axisAlignedBox->type = "Axis Aligned";
+        axisAlignedBox->min = Eigen::Vector3d(header.boxes[0], header.boxes[1], header.boxes[2]);
+        axisAlignedBox->max = Eigen::Vector3d(header.boxes[3], header.boxes[4], header.boxes[5]);
+        axisAlignedBox->extent = axisAlignedBox->max - axisAlignedBox->min;
+    }
+    if (orientedBox) {
+        orientedBox->type = "Oriented";
+        orientedBox->orientedPoints.clear();
+        for (int p = 0; p < 6; p++) {
+            const double* point = header.boxes + 6 + 3 * p;
+            orientedBox->orientedPoints.push_back(Eigen::Vector3d(point[0], point[1], point[2]));
+        }
+    }
+
+    return true;
+}
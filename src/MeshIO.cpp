@@ -1,96 +1,71 @@
 #include "MeshIO.h"
+#include "Diagnostics.h"
 #include "Mesh.h"
-#include <set>
-#include <map>
-
-class Index {
+#include "MeshData.h"
+#include "MeshValidator.h"
+#include "ObjParser.h"
+#include "ObjWriter.h"
+#include "Profiler.h"
+#include <cstdint>
+
+// open addressing hash table mapping undirected vertex pairs to edge ids
+class EdgeTable {
 public:
-    Index() {}
-
-    Index(int v, int vt, int vn): position(v), uv(vt), normal(vn) {}
+    EdgeTable(size_t expected) {
+        size_t capacity = 16;
+        while (capacity < 2*expected) capacity *= 2;
 
-    bool operator<(const Index& i) const {
-        if (position < i.position) return true;
-        if (position > i.position) return false;
-        if (uv < i.uv) return true;
-        if (uv > i.uv) return false;
-        if (normal < i.normal) return true;
-        if (normal > i.normal) return false;
-
-        return false;
+        keys.assign(capacity, empty);
+        values.resize(capacity);
+        mask = capacity - 1;
     }
 
-    int position;
-    int uv;
-    int normal;
-};
-
-class MeshData {
-public:
-    std::vector<Eigen::Vector3d> positions;
-    std::vector<Eigen::Vector3d> uvs;
-    std::vector<Eigen::Vector3d> normals;
-    std::vector<std::vector<Index>> indices;
-};
-
-Index parseFaceIndex(const std::string& token)
-{
-    std::stringstream in(token);
-    std::string indexString;
-    int indices[3] = {-1, -1, -1};
-
-    int i = 0;
-    while(getline(in,indexString,'/')) {
-        if (indexString != "\\") {
-            std::stringstream ss(indexString);
-            ss >> indices[i++];
+    // returns the id of the edge between a and b, inserting it with the given id if it is new
+    int insert(int a, int b, int id) {
+        if (a > b) std::swap(a, b);
+        uint64_t key = ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+
+        size_t slot = (key * 0x9e3779b97f4a7c15ull) >> 32 & mask;
+        while (keys[slot] != key) {
+            if (keys[slot] == empty) {
+                keys[slot] = key;
+                values[slot] = id;
+                break;
+            }
+            slot = (slot + 1) & mask;
         }
+
+        return values[slot];
     }
 
-    // decrement since indices in OBJ files are 1-based
-    return Index(indices[0]-1,
-                 indices[1]-1,
-                 indices[2]-1);
-}
+private:
+    static constexpr uint64_t empty = ~0ull;
 
-std::string stringRep(const Eigen::Vector3d& v)
-{
-    return std::to_string(v.x()) + " " + std::to_string(v.y()) + " " + std::to_string(v.z());
-}
+    std::vector<uint64_t> keys;
+    std::vector<int> values;
+    size_t mask;
+};
 
-void MeshIO::preallocateMeshElements(const MeshData& data, Mesh& mesh)
+void MeshIO::preallocateMeshElements(const MeshData& data, int nEdges, int nBoundaryEdges, Mesh& mesh)
 {
-    // count the number of edges
-    std::set<std::pair<int,int>> edges;
-    for (std::vector<std::vector<Index>>::const_iterator f  = data.indices.begin();
-                                                         f != data.indices.end();
-                                                         f ++) {
-        for (unsigned int I = 0; I < f->size(); I++) {
-            int J = (I+1) % f->size();
-            int i = (*f)[I].position;
-            int j = (*f)[J].position;
-
-            if (i > j) std::swap(i, j);
-
-            edges.insert(std::pair<int,int>(i, j));
-        }
-    }
-
     size_t nV = data.positions.size();
-    size_t nE = edges.size();
-    size_t nF = data.indices.size();
+    size_t nE = nEdges;
+    size_t nF = data.faceCount();
     size_t nHE = 2*nE;
-    size_t chi = nV - nE + nF;
-    int nB = std::max(0, 2 - (int)chi); // conservative approximation of number of boundary cycles
+    size_t nB = nBoundaryEdges; // every boundary cycle contains at least one boundary edge
 
     mesh.halfEdges.clear();
     mesh.vertices.clear();
+    mesh.uvs.clear();
+    mesh.normals.clear();
     mesh.edges.clear();
     mesh.faces.clear();
     mesh.boundaries.clear();
 
     mesh.halfEdges.reserve(nHE);
     mesh.vertices.reserve(nV);
+    mesh.uvs.reserve(data.uvs.size());
+    mesh.normals.reserve(data.normals.size());
     mesh.edges.reserve(nE);
     mesh.faces.reserve(nF + nB);
 }
@@ -104,202 +79,191 @@ void MeshIO::indexVertices(Mesh& mesh)
     }
 }
 
-void MeshIO::checkIsolatedVertices(const Mesh& mesh)
+bool MeshIO::buildMesh(const MeshData& data, Mesh& mesh, DiagnosticsReport& report)
 {
-    for (VertexCIter v = mesh.vertices.begin(); v != mesh.vertices.end(); v++) {
-        if (v->isIsolated()) {
-            std::cerr << "Warning: vertex " << v->index
-                      << " is isolated (not contained in any face)."
-                      << std::endl;
-        }
-    }
-}
+    ScopedTimer timer("MeshIO::buildMesh");
 
-void MeshIO::checkNonManifoldVertices(const Mesh& mesh)
-{
-    std::unordered_map<std::string, int> vertexFaceMap;
+    int nV = (int)data.positions.size();
+    int nF = data.faceCount();
 
-    for (FaceCIter f = mesh.faces.begin(); f != mesh.faces.end(); f++) {
-        HalfEdgeCIter he = f->he;
-        do {
-            vertexFaceMap[stringRep(he->vertex->position)] ++;
-            he = he->next;
+    // check for degenerate faces and faces referencing vertices that do not exist
+    bool invalidFaces = false;
+    for (int f = 0; f < nF; f++) {
+        const Index* face = &data.indices[data.faceOffsets[f]];
+        int n = data.faceSize(f);
 
-        } while (he != f->he);
+        if (n < 3) {
+            report.add("degenerate_face", LogError, f);
+            invalidFaces = true;
+            continue;
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (face[i].position < 0 || face[i].position >= nV) {
+                report.add("out_of_range_face", LogError, f);
+                invalidFaces = true;
+                break;
+            }
+        }
     }
 
-    for (VertexCIter v = mesh.vertices.begin(); v != mesh.vertices.end(); v++) {
-        int valence = 0;
-        HalfEdgeCIter he = v->he;
-        do {
-            valence ++;
-            he = he->flip->next;
+    if (invalidFaces) {
+        return false;
+    }
 
-        } while (he != v->he);
+    // assign an id to every undirected edge in order of first appearance and count its faces
+    std::vector<int> cornerEdge(data.indices.size());
+    std::vector<unsigned char> edgeCount;
+    bool nonManifoldEdges = false;
+    {
+        EdgeTable table(data.indices.size());
+        for (int f = 0; f < nF; f++) {
+            const Index* face = &data.indices[data.faceOffsets[f]];
+            int n = data.faceSize(f);
 
-        if (vertexFaceMap[stringRep(v->position)] != valence) {
-            std::cerr << "Warning: vertex " << v->index
-                      << " is nonmanifold." << std::endl;
+            for (int i = 0; i < n; i++) {
+                int a = face[i].position;
+                int b = face[(i+1)%n].position;
+
+                int e = table.insert(a, b, (int)edgeCount.size());
+                if (e == (int)edgeCount.size()) edgeCount.push_back(0);
+                cornerEdge[data.faceOffsets[f] + i] = e;
+
+                // check for nonmanifold edges, the face that adds a third face to an edge is reported
+                if (edgeCount[e] == 2) {
+                    report.add("excess_face", LogError, f);
+                    nonManifoldEdges = true;
+                } else {
+                    edgeCount[e]++;
+                }
+            }
         }
     }
-}
-
-extern std::vector<HalfEdge> isolated;
 
-bool MeshIO::buildMesh(const MeshData& data, Mesh& mesh)
-{
-    std::map<std::pair<int, int>, int> edgeCount;
-    std::map<std::pair<int, int>, HalfEdgeIter> existingHalfEdges;
-    std::map<int, VertexIter> indexToVertex;
-    std::map<HalfEdgeIter, bool> hasFlipEdge;
-
-    preallocateMeshElements(data, mesh);
-
-    // insert vertices into mesh and map vertex indices to vertex pointers
-    for (unsigned int i = 0; i < data.positions.size(); i++) {
-        VertexIter vertex = mesh.vertices.insert(mesh.vertices.end(), Vertex());
-        vertex->position = data.positions[i];
-        vertex->he = isolated.begin();
-        indexToVertex[i] = vertex;
+    if (nonManifoldEdges) {
+        return false;
     }
 
-    // insert uvs into mesh
-    for (unsigned int i = 0; i < data.uvs.size(); i++) {
-        VectorIter uv = mesh.uvs.insert(mesh.uvs.end(), Eigen::Vector3d());
-        *uv = data.uvs[i];
+    int nE = (int)edgeCount.size();
+    int nBoundaryEdges = 0;
+    for (int e = 0; e < nE; e++) {
+        if (edgeCount[e] == 1) nBoundaryEdges++;
     }
 
-    // insert normals into mesh
-    for (unsigned int i = 0; i < data.normals.size(); i++) {
-        VectorIter normal = mesh.normals.insert(mesh.normals.end(), Eigen::Vector3d());
-        *normal = data.normals[i];
+    preallocateMeshElements(data, nE, nBoundaryEdges, mesh);
+
+    // insert vertices into mesh
+    mesh.vertices.resize(nV);
+    for (int i = 0; i < nV; i++) {
+        mesh.vertices[i].position = data.positions[i];
+        mesh.vertices[i].he = InvalidId;
     }
 
+    // insert uvs and normals into mesh
+    mesh.uvs.insert(mesh.uvs.end(), data.uvs.begin(), data.uvs.end());
+    mesh.normals.insert(mesh.normals.end(), data.normals.begin(), data.normals.end());
+
+    // halfedge created first for each edge, and whether each halfedge has a flip edge (for detecting boundaries)
+    std::vector<HalfEdgeId> edgeHalfEdge(nE, InvalidId);
+    std::vector<unsigned char> hasFlipEdge(2*nE, false);
+
     // insert faces into mesh
-    int faceIndex = 0;
-    bool degenerateFaces = false;
-    for (std::vector<std::vector<Index>>::const_iterator f  = data.indices.begin();
-                                                         f != data.indices.end();
-                                                         f ++) {
-        int n = (int)f->size();
-
-        // check if face is degenerate
-        if (n < 3) {
-            std::cerr << "Error: face " << faceIndex << " is degenerate" << std::endl;
-            degenerateFaces = true;
-            continue;
-        }
+    for (int f = 0; f < nF; f++) {
+        const Index* face = &data.indices[data.faceOffsets[f]];
+        int n = data.faceSize(f);
 
         // create face
-        FaceIter newFace = mesh.faces.insert(mesh.faces.end(), Face());
+        FaceId newFace = (FaceId)mesh.faces.size();
+        mesh.faces.push_back(Face());
 
         // create a halfedge for each edge of the face
-        std::vector<HalfEdgeIter> halfEdges(n);
-        for (int i = 0; i < n; i++) {
-            halfEdges[i] = mesh.halfEdges.insert(mesh.halfEdges.end(), HalfEdge());
-        }
+        HalfEdgeId first = (HalfEdgeId)mesh.halfEdges.size();
+        mesh.halfEdges.resize(first + n);
 
         // initialize the halfedges
         for (int i = 0; i < n; i++) {
-            // vertex indices
-            int a = (*f)[i].position;
-            int b = (*f)[(i+1)%n].position;
+            HalfEdgeId h = first + i;
+            HalfEdge& he = mesh.halfEdges[h];
+            VertexId vertex = face[i].position;
 
             // set halfedge attributes
-            halfEdges[i]->next = halfEdges[(i+1)%n];
-            halfEdges[i]->vertex = indexToVertex[a];
-
-            int uv = (*f)[i].uv;
-            if (uv >= 0) halfEdges[i]->uv = data.uvs[uv];
-            else halfEdges[i]->uv.setZero();
+            he.next = first + (i+1)%n;
+            he.vertex = vertex;
 
-            int normal = (*f)[i].normal;
-            if (normal >= 0) halfEdges[i]->normal = data.normals[normal];
-            else halfEdges[i]->normal.setZero();
+            int uv = face[i].uv;
+            he.uv = uv >= 0 && uv < (int)data.uvs.size() ? uv : InvalidId;
 
-            halfEdges[i]->onBoundary = false;
+            int normal = face[i].normal;
+            he.normal = normal >= 0 && normal < (int)data.normals.size() ? normal : InvalidId;
 
-            // keep track of which halfedges have flip edges defined (for deteting boundaries)
-            hasFlipEdge[halfEdges[i]] = false;
+            he.onBoundary = false;
 
-            // point vertex a at the current halfedge
-            indexToVertex[a]->he = halfEdges[i];
+            // point vertex at the current halfedge
+            mesh.vertices[vertex].he = h;
 
             // point new face and halfedge to each other
-            halfEdges[i]->face = newFace;
-            newFace->he = halfEdges[i];
-
-            // if an edge between a and b has been created in the past, it is the flip edge of the current halfedge
-            if (a > b) std::swap(a, b);
-            if (existingHalfEdges.find(std::pair<int, int>(a, b)) != existingHalfEdges.end()) {
-                halfEdges[i]->flip = existingHalfEdges[std::pair<int, int>(a, b)];
-                halfEdges[i]->flip->flip = halfEdges[i];
-                halfEdges[i]->edge = halfEdges[i]->flip->edge;
-                hasFlipEdge[halfEdges[i]] = true;
-                hasFlipEdge[halfEdges[i]->flip] = true;
+            he.face = newFace;
+            mesh.faces[newFace].he = h;
+
+            // if the edge has been created in the past, its halfedge is the flip edge of the current halfedge
+            int e = cornerEdge[data.faceOffsets[f] + i];
+            if (edgeHalfEdge[e] != InvalidId) {
+                he.flip = edgeHalfEdge[e];
+                mesh.halfEdges[he.flip].flip = h;
+                he.edge = mesh.halfEdges[he.flip].edge;
+                hasFlipEdge[h] = true;
+                hasFlipEdge[he.flip] = true;
 
             } else {
                 // create an edge and set its halfedge
-                halfEdges[i]->edge = mesh.edges.insert(mesh.edges.end(), Edge());
-                halfEdges[i]->edge->he = halfEdges[i];
-                edgeCount[std::pair<int, int>(a, b)] = 0;
-            }
-
-            // record that halfedge has been created from a to b
-            existingHalfEdges[std::pair<int, int>(a, b)] = halfEdges[i];
-
-            // check for nonmanifold edges
-            edgeCount[std::pair<int, int>(a, b)] ++;
-            if (edgeCount[std::pair<int, int>(a, b)] > 2) {
-                std::cerr << "Error: edge " << a << ", " << b << " is non manifold" << std::endl;
-                return false;
+                he.edge = (EdgeId)mesh.edges.size();
+                mesh.edges.push_back(Edge());
+                mesh.edges[he.edge].he = h;
+                edgeHalfEdge[e] = h;
             }
         }
-
-        faceIndex++;
-    }
-
-    if (degenerateFaces) {
-        return false;
     }
 
     // insert extra faces for boundary cycle
-    for (HalfEdgeIter currHe = mesh.halfEdges.begin(); currHe != mesh.halfEdges.end(); currHe++) {
+    HalfEdgeId nInterior = (HalfEdgeId)mesh.halfEdges.size();
+    for (HalfEdgeId currHe = 0; currHe < nInterior; currHe++) {
         // if a halfedge with no flip edge is found, create a new face and link it the corresponding boundary cycle
         if (!hasFlipEdge[currHe]) {
             // create face
-            FaceIter newFace = mesh.faces.insert(mesh.faces.end(), Face());
+            FaceId newFace = (FaceId)mesh.faces.size();
+            mesh.faces.push_back(Face());
 
             // walk along boundary cycle
-            std::vector<HalfEdgeIter> boundaryCycle;
-            HalfEdgeIter he = currHe;
+            HalfEdgeId cycleStart = (HalfEdgeId)mesh.halfEdges.size();
+            HalfEdgeId he = currHe;
             do {
                 // create a new halfedge on the boundary face
-                HalfEdgeIter newHe = mesh.halfEdges.insert(mesh.halfEdges.end(), HalfEdge());
-                newHe->onBoundary = true;
+                HalfEdgeId newHe = (HalfEdgeId)mesh.halfEdges.size();
+                mesh.halfEdges.push_back(HalfEdge());
+                mesh.halfEdges[newHe].onBoundary = true;
 
                 // link the current halfedge in the cycle to its new flip edge
-                he->flip = newHe;
+                mesh.halfEdges[he].flip = newHe;
 
                 // grab the next halfedge along the boundary by finding
                 // the next halfedge around the current vertex that doesn't
                 // have a flip edge defined
-                HalfEdgeIter nextHe = he->next;
+                HalfEdgeId nextHe = mesh.halfEdges[he].next;
                 while (hasFlipEdge[nextHe]) {
-                    nextHe = nextHe->flip->next;
+                    nextHe = mesh.halfEdges[mesh.halfEdges[nextHe].flip].next;
                 }
 
                 // set attritubes for new halfedge
-                newHe->flip = he;
-                newHe->vertex = nextHe->vertex;
-                newHe->edge = he->edge;
-                newHe->face = newFace;
-                newHe->uv = nextHe->uv;
+                HalfEdge& boundaryHe = mesh.halfEdges[newHe];
+                boundaryHe.flip = he;
+                boundaryHe.vertex = mesh.halfEdges[nextHe].vertex;
+                boundaryHe.edge = mesh.halfEdges[he].edge;
+                boundaryHe.face = newFace;
+                boundaryHe.uv = mesh.halfEdges[nextHe].uv;
+                boundaryHe.normal = InvalidId;
 
                 // set face's halfedge to boundary halfedge
-                newFace->he = newHe;
-
-                boundaryCycle.push_back(newHe);
+                mesh.faces[newFace].he = newHe;
 
                 // continue walk along cycle
                 he = nextHe;
@@ -307,142 +271,60 @@ bool MeshIO::buildMesh(const MeshData& data, Mesh& mesh)
             } while (he != currHe);
 
             // link the cycle of boundary halfedges together
-            int n = (int)boundaryCycle.size();
-            for (int i = 0; i < n; i++) {
-                boundaryCycle[i]->next = boundaryCycle[(i+n-1)%n];
-                hasFlipEdge[boundaryCycle[i]] = true;
-                hasFlipEdge[boundaryCycle[i]->flip] = true;
+            HalfEdgeId n = (HalfEdgeId)mesh.halfEdges.size() - cycleStart;
+            for (HalfEdgeId j = 0; j < n; j++) {
+                HalfEdge& boundaryHe = mesh.halfEdges[cycleStart + j];
+                boundaryHe.next = cycleStart + (j+n-1)%n;
+                hasFlipEdge[cycleStart + j] = true;
+                hasFlipEdge[boundaryHe.flip] = true;
             }
-            mesh.boundaries.insert(mesh.boundaries.end(), boundaryCycle[0]);
+            mesh.boundaries.push_back(cycleStart);
         }
     }
 
     indexVertices(mesh);
-    checkIsolatedVertices(mesh);
-    checkNonManifoldVertices(mesh);
+
+    if (timer.isActive()) {
+        timer.addElements(mesh.halfEdges.size());
+        timer.addBytes(mesh.halfEdges.capacity() * sizeof(HalfEdge) + mesh.vertices.capacity() * sizeof(Vertex) +
+                       (mesh.uvs.capacity() + mesh.normals.capacity()) * sizeof(Eigen::Vector3d) +
+                       mesh.edges.capacity() * sizeof(Edge) + mesh.faces.capacity() * sizeof(Face) +
+                       mesh.boundaries.capacity() * sizeof(HalfEdgeId));
+    }
 
     return true;
 }
 
-bool MeshIO::read(std::ifstream& in, Mesh& mesh)
+bool MeshIO::read(const char* buffer, size_t size, Mesh& mesh, int threads, bool validate)
 {
     MeshData data;
 
     // parse obj format
-    std::string line;
-    while(getline(in, line)) {
-        std::stringstream ss(line);
-        std::string token;
-
-        ss >> token;
-
-        if (token == "v") {
-            double x, y, z;
-            ss >> x >> y >> z;
-
-            data.positions.push_back(Eigen::Vector3d(x, y, z));
-
-        } else if (token == "vt") {
-            double u, v;
-            ss >> u >> v;
-
-            data.uvs.push_back(Eigen::Vector3d(u,v,0));
-
-        } else if (token == "vn") {
-            double x, y, z;
-            ss >> x >> y >> z;
-
-            data.normals.push_back(Eigen::Vector3d(x, y, z));
-
-        } else if (token == "f") {
-            std::vector<Index> faceIndices;
-
-            while (ss >> token) {
-                Index index = parseFaceIndex(token);
-                if (index.position < 0) {
-                    getline(in, line);
-                    size_t i = line.find_first_not_of("\t\n\v\f\r ");
-                    index = parseFaceIndex(line.substr(i));
-                }
-
-                faceIndices.push_back(index);
-            }
-
-            data.indices.push_back(faceIndices);
+    {
+        ScopedTimer timer("ObjParser::parse");
+        if (threads == 1) ObjParser::parse(buffer, buffer + size, data);
+        else ObjParser::parse(buffer, buffer + size, data, threads);
+
+        if (timer.isActive()) {
+            timer.addElements(data.faceCount());
+            timer.addBytes((data.positions.capacity() + data.uvs.capacity() + data.normals.capacity()) *
+                               sizeof(Eigen::Vector3d) +
+                           data.indices.capacity() * sizeof(Index) + data.faceOffsets.capacity() * sizeof(int));
         }
     }
 
-    return buildMesh(data, mesh);
-}
-
-void MeshIO::write(std::ofstream& out, Mesh& mesh)
-{
-    Eigen::Matrix3d rot;
-    rot << cos(45), -sin(45), 0,
-           sin(45), cos(45), 0,
-           0, 0, 1;
-
-    for (VertexIter v = mesh.vertices.begin(); v != mesh.vertices.end(); v++) {
-        v->position = rot * v->position;
-    }
-
-    std::unordered_map<std::string, int> vertexMap;
-    std::unordered_map<std::string, int> uvMap;
-    std::unordered_map<std::string, int> normalMap;
-
-    // write vertices
-    int index = 1;
-    for (VertexCIter v = mesh.vertices.begin(); v != mesh.vertices.end(); v++) {
-        out << "v " << v->position.x() << " "
-                    << v->position.y() << " "
-                    << v->position.z() << std::endl;
-
-        vertexMap[stringRep(v->position)] = index;
-        index++;
-    }
-
-    // write uvs
-    index = 1;
-    for (VectorCIter uv = mesh.uvs.begin(); uv != mesh.uvs.end(); uv++) {
-        out << "vt " << uv->x() << " "
-                     << uv->y() << std::endl;
-
-        uvMap[stringRep(*uv)] = index;
-        index++;
-    }
-
-    // write normals
-    index = 1;
-    for (VectorCIter n = mesh.uvs.begin(); n != mesh.normals.end(); n++) {
-        out << "vn " << n->x() << " "
-                     << n->y() << " "
-                     << n->z() << std::endl;
+    mesh.diagnostics.clear();
+    if (!buildMesh(data, mesh, mesh.diagnostics)) return false;
 
-        normalMap[stringRep(*n)] = index;
-        index++;
+    if (validate) {
+        data = MeshData();
+        MeshValidator::addToReport(MeshValidator::validate(mesh, threads), mesh.diagnostics);
     }
 
-    // write faces
-    index = 0;
-    for (FaceCIter f = mesh.faces.begin(); f != mesh.faces.end(); f++) {
-        HalfEdgeIter he = mesh.faces[index].he;
-
-        if (he->onBoundary) {
-            continue;
-        }
-
-        out << "f ";
-        int j = 0;
-        do {
-            out << vertexMap[stringRep(he->vertex->position)] << "/"
-                << uvMap[stringRep(he->uv)] << "/"
-                << normalMap[stringRep(he->normal)] << " ";
-            j++;
-
-            he = he->next;
-        } while (he != mesh.faces[index].he);
-        out << std::endl;
+    return true;
+}
 
-        index ++;
-    }
-}
\ No newline at end of file
+bool MeshIO::write(std::ostream& out, const Mesh& mesh, int threads)
+{
+    return ObjWriter::write(out, mesh, threads);
+}
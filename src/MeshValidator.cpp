@@ -0,0 +1,115 @@
+#include "MeshValidator.h"
+
+#include "Diagnostics.h"
+#include "Mesh.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace {
+
+// runs visit(i, found) for i in [0, n) in blocks on the thread pool and joins the indices each block
+// found in block order
+template <typename Visit>
+std::vector<uint32_t> collect(size_t n, int threads, Visit visit) {
+    size_t blocks = (n + MeshValidator::blockSize - 1) / MeshValidator::blockSize;
+    std::vector<std::vector<uint32_t>> found(blocks);
+
+    ThreadPool::global().parallelFor(blocks, [&](size_t b) {
+        size_t end = std::min(n, (b + 1) * MeshValidator::blockSize);
+        for (size_t i = b * MeshValidator::blockSize; i < end; i++) {
+            visit(i, found[b]);
+        }
+    }, threads);
+
+    std::vector<uint32_t> indices;
+    for (const std::vector<uint32_t>& block : found) {
+        indices.insert(indices.end(), block.begin(), block.end());
+    }
+
+    return indices;
+}
+
+} // namespace
+
+/**
+ * Functionality: Checks the connectivity of a mesh by element index. A vertex is non-manifold if the
+ * walk around it from its halfedge misses one of its outgoing halfedges or leaves the vertex, so the
+ * vertices first mark the halfedges of their fans and the unmarked halfedges are then looked up. Each
+ * halfedge is marked by its own vertex only, so the blocks never write the same element.
+ * Parameter:
+ *     mesh: const Mesh&, the mesh, built by MeshIO::buildMesh or read from a mesh cache.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Returns:
+ *     ValidationResult: The problems found, the same for every thread count.
+ */
+ValidationResult MeshValidator::validate(const Mesh& mesh, int threads) {
+    ScopedTimer timer("MeshValidator::validate");
+    timer.addElements(mesh.halfEdges.size());
+
+    threads = ThreadPool::resolveThreadCount(threads);
+    const std::vector<HalfEdge>& halfEdges = mesh.halfEdges;
+    const std::vector<Vertex>& vertices = mesh.vertices;
+
+    ValidationResult result;
+    result.boundaryLoops = mesh.boundaries.size();
+
+    // mark the fan of every vertex, a walk that leaves its vertex makes the vertex non-manifold
+    std::vector<unsigned char> inFan(halfEdges.size(), false);
+    auto walkFan = [&](size_t v, std::vector<uint32_t>& found) {
+        HalfEdgeId start = vertices[v].he;
+        if (start == InvalidId) return;
+
+        HalfEdgeId he = start;
+        do {
+            if (halfEdges[he].vertex != v) {
+                found.push_back((uint32_t)v);
+                return;
+            }
+            inFan[he] = true;
+            he = halfEdges[halfEdges[he].flip].next;
+
+        } while (he != start);
+    };
+    std::vector<VertexId> brokenFans = collect(vertices.size(), threads, walkFan);
+    timer.addBytes(inFan.capacity());
+
+    result.isolatedVertices = collect(vertices.size(), threads, [&](size_t v, std::vector<uint32_t>& found) {
+        if (vertices[v].he == InvalidId) found.push_back((uint32_t)v);
+    });
+
+    // outgoing halfedges missed by the walks belong to a second fan
+    result.nonManifoldVertices = collect(halfEdges.size(), threads, [&](size_t h, std::vector<uint32_t>& found) {
+        if (!inFan[h]) found.push_back(halfEdges[h].vertex);
+    });
+    result.nonManifoldVertices.insert(result.nonManifoldVertices.end(), brokenFans.begin(), brokenFans.end());
+    std::sort(result.nonManifoldVertices.begin(), result.nonManifoldVertices.end());
+    result.nonManifoldVertices.erase(std::unique(result.nonManifoldVertices.begin(),
+                                                 result.nonManifoldVertices.end()),
+                                     result.nonManifoldVertices.end());
+
+    // the halfedges of an edge start at different vertices, and neither at both ends
+    result.nonManifoldEdges = collect(mesh.edges.size(), threads, [&](size_t e, std::vector<uint32_t>& found) {
+        const HalfEdge& he = halfEdges[mesh.edges[e].he];
+        VertexId tail = he.vertex;
+        if (halfEdges[he.flip].vertex == tail || halfEdges[he.next].vertex == tail) {
+            found.push_back((uint32_t)e);
+        }
+    });
+
+    return result;
+}
+
+/**
+ * Functionality: Adds the problems of a validation to a report as warnings, under the codes
+ * isolated_vertex, nonmanifold_vertex and nonmanifold_edge.
+ * Parameter:
+ *     result: const ValidationResult&, the problems.
+ *     report: DiagnosticsReport&, the report to add them to.
+ */
+void MeshValidator::addToReport(const ValidationResult& result, DiagnosticsReport& report) {
+    for (VertexId v : result.isolatedVertices) report.add("isolated_vertex", LogWarning, (int)v);
+    for (VertexId v : result.nonManifoldVertices) report.add("nonmanifold_vertex", LogWarning, (int)v);
+    for (EdgeId e : result.nonManifoldEdges) report.add("nonmanifold_edge", LogWarning, (int)e);
+}
@@ -0,0 +1,349 @@
+#include "OBBTree.h"
+
+#include "BoundingBox.h"
+#include "Diagnostics.h"
+#include "Mesh.h"
+#include "PointReduction.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+// number of nodes of a subtree over count triangles, fixed by the median split
+uint32_t subtreeSize(uint32_t count) {
+    if (count <= OBBTree::leafSize) return 1;
+    return 1 + subtreeSize(count / 2) + subtreeSize(count - count / 2);
+}
+
+// buffers reused by the node fits of one thread
+struct FitScratch {
+    PositionBuffer corners;
+    std::vector<uint32_t> triangles;
+};
+
+// subtree whose build is left to a worker
+struct BuildTask {
+    uint32_t node;
+    uint32_t begin;
+    uint32_t end;
+};
+
+class TreeBuilder {
+public:
+    TreeBuilder(const PositionBuffer& positions, const std::vector<uint32_t>& triangles,
+                std::vector<uint32_t>& order, std::vector<OBBNode>& nodes);
+
+    // builds the nodes above the given depth on threads threads and collects the subtrees below
+    void buildTop(uint32_t node, uint32_t begin, uint32_t end, int depth, int threads, std::vector<BuildTask>& tasks);
+
+    // builds a subtree on the calling thread
+    void buildSubtree(uint32_t node, uint32_t begin, uint32_t end, FitScratch& scratch);
+
+private:
+    // fits the box of a node around the triangles order[begin, end)
+    void fit(OBBNode& node, uint32_t begin, uint32_t end, int threads, FitScratch& scratch) const;
+
+    // splits order[begin, end) at the median along the longest axis of the node box, returns the split index
+    uint32_t split(const OBBNode& node, uint32_t begin, uint32_t end);
+
+    const PositionBuffer& positions;
+    const std::vector<uint32_t>& triangles;
+    std::vector<uint32_t>& order;
+    std::vector<OBBNode>& nodes;
+    std::vector<Eigen::Vector3d> centroids;
+};
+
+TreeBuilder::TreeBuilder(const PositionBuffer& positions, const std::vector<uint32_t>& triangles,
+                         std::vector<uint32_t>& order, std::vector<OBBNode>& nodes)
+    : positions(positions), triangles(triangles), order(order), nodes(nodes), centroids(triangles.size() / 3) {
+    for (size_t t = 0; t < centroids.size(); t++) {
+        centroids[t] = (positions.get(triangles[3*t]) + positions.get(triangles[3*t + 1]) +
+                        positions.get(triangles[3*t + 2])) / 3;
+    }
+}
+
+void TreeBuilder::fit(OBBNode& node, uint32_t begin, uint32_t end, int threads, FitScratch& scratch) const {
+    uint32_t count = 3 * (end - begin);
+    scratch.corners.resize(count);
+    scratch.triangles.resize(count);
+    std::iota(scratch.triangles.begin(), scratch.triangles.end(), 0);
+    for (uint32_t i = 0; i < count; i++) {
+        scratch.corners.set(i, positions.get(triangles[3*order[begin + i / 3] + i % 3]));
+    }
+
+    // area weighted principal axes, so that dense regions do not tilt the box
+    BoundingBox boundingBox;
+    boundingBox.computeOrientedBox(scratch.corners, scratch.triangles, threads);
+    node.box = OrientedBox(boundingBox);
+
+    // a box flat in two directions does not fix its axes, fit the range to the completed axes
+    if ((node.box.halfExtents.array() > 0).count() < 2) {
+        Eigen::Vector3d minVals, maxVals;
+        PointReduction::projectMinMax(PositionBufferSource(scratch.corners), Eigen::Vector3d::Zero(), node.box.axes,
+                                      minVals, maxVals, threads);
+        node.box.center = node.box.axes * (minVals + maxVals) / 2;
+        node.box.halfExtents = (maxVals - minVals) / 2;
+    }
+}
+
+uint32_t TreeBuilder::split(const OBBNode& node, uint32_t begin, uint32_t end) {
+    int axis;
+    node.box.halfExtents.maxCoeff(&axis);
+    Eigen::Vector3d direction = node.box.axes.col(axis);
+
+    // ties are broken by index so that the layout does not depend on the input order of equal keys
+    uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(order.begin() + begin, order.begin() + middle, order.begin() + end, [&](uint32_t a, uint32_t b) {
+        double ka = direction.dot(centroids[a]), kb = direction.dot(centroids[b]);
+        return ka < kb || (ka == kb && a < b);
+    });
+
+    return middle;
+}
+
+void TreeBuilder::buildTop(uint32_t node, uint32_t begin, uint32_t end, int depth, int threads,
+                           std::vector<BuildTask>& tasks) {
+    if (depth == 0 || end - begin <= OBBTree::leafSize) {
+        tasks.push_back(BuildTask{node, begin, end});
+        return;
+    }
+
+    FitScratch scratch;
+    OBBNode& n = nodes[node];
+    fit(n, begin, end, threads, scratch);
+    uint32_t middle = split(n, begin, end);
+    n.first = begin;
+    n.count = 0;
+    n.right = node + 1 + subtreeSize(middle - begin);
+
+    buildTop(node + 1, begin, middle, depth - 1, threads, tasks);
+    buildTop(n.right, middle, end, depth - 1, threads, tasks);
+}
+
+void TreeBuilder::buildSubtree(uint32_t node, uint32_t begin, uint32_t end, FitScratch& scratch) {
+    OBBNode& n = nodes[node];
+    fit(n, begin, end, 1, scratch);
+    n.first = begin;
+
+    if (end - begin <= OBBTree::leafSize) {
+        n.count = end - begin;
+        n.right = 0;
+        return;
+    }
+
+    uint32_t middle = split(n, begin, end);
+    n.count = 0;
+    n.right = node + 1 + subtreeSize(middle - begin);
+
+    buildSubtree(node + 1, begin, middle, scratch);
+    buildSubtree(n.right, middle, end, scratch);
+}
+
+// separating axis test of two triangles, over the two normals, the nine edge cross products and
+// the in-plane edge normals that separate coplanar triangles
+bool trianglesIntersect(const Eigen::Vector3d p[3], const Eigen::Vector3d q[3]) {
+    Eigen::Vector3d e[3] = {p[1] - p[0], p[2] - p[1], p[0] - p[2]};
+    Eigen::Vector3d f[3] = {q[1] - q[0], q[2] - q[1], q[0] - q[2]};
+    Eigen::Vector3d n = e[0].cross(e[1]), m = f[0].cross(f[1]);
+
+    Eigen::Vector3d axes[17];
+    axes[0] = n;
+    axes[1] = m;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) axes[2 + 3*i + j] = e[i].cross(f[j]);
+        axes[11 + i] = n.cross(e[i]);
+        axes[14 + i] = m.cross(f[i]);
+    }
+
+    for (const Eigen::Vector3d& axis : axes) {
+        if (axis.squaredNorm() == 0) continue;
+
+        double p0 = axis.dot(p[0]), p1 = axis.dot(p[1]), p2 = axis.dot(p[2]);
+        double q0 = axis.dot(q[0]), q1 = axis.dot(q[1]), q2 = axis.dot(q[2]);
+        if (std::max({p0, p1, p2}) < std::min({q0, q1, q2}) || std::max({q0, q1, q2}) < std::min({p0, p1, p2})) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// corners of triangle t of a tree
+void triangleCorners(const OBBTree& tree, uint32_t t, Eigen::Vector3d corners[3]) {
+    for (int k = 0; k < 3; k++) corners[k] = tree.vertices.get(tree.triangles[3*t + k]);
+}
+
+// tests every triangle of leaf na against every triangle of leaf nb moved by transform
+bool leavesIntersect(const OBBTree& a, const OBBNode& na, const OBBTree& b, const OBBNode& nb,
+                     const Eigen::Isometry3d& transform) {
+    Eigen::Vector3d moved[OBBTree::leafSize][3];
+    for (uint32_t j = 0; j < nb.count; j++) {
+        triangleCorners(b, nb.first + j, moved[j]);
+        for (int k = 0; k < 3; k++) moved[j][k] = transform * moved[j][k];
+    }
+
+    Eigen::Vector3d corners[3];
+    for (uint32_t i = 0; i < na.count; i++) {
+        triangleCorners(a, na.first + i, corners);
+        for (uint32_t j = 0; j < nb.count; j++) {
+            if (trianglesIntersect(corners, moved[j])) return true;
+        }
+    }
+
+    return false;
+}
+
+} // namespace
+
+/**
+ * Functionality: Creates an empty tree.
+ */
+OBBTree::OBBTree() {}
+
+/**
+ * Functionality: Builds the tree over the triangles of a mesh, faces with more than three sides
+ * are split into fans as in Mesh::triangles.
+ * Parameter:
+ *     mesh: const Mesh&, the mesh.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Returns:
+ *     bool: Returns true if the tree was built, false if the mesh has no triangles.
+ */
+bool OBBTree::build(const Mesh& mesh, int threads) {
+    return build(mesh.positions, mesh.triangles, threads);
+}
+
+/**
+ * Functionality: Builds the tree top down. Each node gets the area weighted principal component box
+ * of its triangles, then the triangles are split at the median of their centroids along the longest
+ * box axis until at most leafSize are left. The split fixes the size of every subtree, so the nodes
+ * are placed in depth first order without a second pass. The top levels fit their boxes with all
+ * threads, the subtrees below are built in parallel, one per task. The tree does not depend on the
+ * thread count.
+ * Parameter:
+ *     positions: const PositionBuffer&, the triangle corners.
+ *     triangles: const std::vector<uint32_t>&, three indices into positions per triangle.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Returns:
+ *     bool: Returns true if the tree was built, false if there are no triangles or an index is out
+ *           of range, in which case the tree is left empty.
+ */
+bool OBBTree::build(const PositionBuffer& positions, const std::vector<uint32_t>& triangles, int threads) {
+    clear();
+
+    uint32_t count = (uint32_t)(triangles.size() / 3);
+    if (count == 0) return false;
+
+    for (uint32_t index : triangles) {
+        if (index >= positions.size()) {
+            Log::write(LogError, "triangle index " + std::to_string(index) + " is out of range");
+            return false;
+        }
+    }
+
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0);
+    nodes.resize(subtreeSize(count));
+
+    // enough subtrees for the workers to balance their load
+    int threadCount = ThreadPool::resolveThreadCount(threads);
+    int depth = 0;
+    while (threadCount > 1 && (1 << depth) < 4 * threadCount) depth++;
+
+    TreeBuilder builder(positions, triangles, order, nodes);
+    std::vector<BuildTask> tasks;
+    builder.buildTop(0, 0, count, depth, threadCount, tasks);
+
+    ThreadPool::global().parallelFor(tasks.size(), [&](size_t i) {
+        thread_local FitScratch scratch;
+        builder.buildSubtree(tasks[i].node, tasks[i].begin, tasks[i].end, scratch);
+    }, threadCount);
+
+    vertices = positions;
+    triangleIndices = order;
+    this->triangles.resize(3 * (size_t)count);
+    for (uint32_t t = 0; t < count; t++) {
+        for (int k = 0; k < 3; k++) this->triangles[3*t + k] = triangles[3*order[t] + k];
+    }
+
+    return true;
+}
+
+/**
+ * Functionality: Computes the depth of the tree.
+ * Returns:
+ *     int: The number of nodes on the longest path from the root to a leaf, 0 for an empty tree.
+ */
+int OBBTree::depth() const {
+    int result = 0;
+    std::vector<std::pair<uint32_t, int>> stack;
+    if (!nodes.empty()) stack.push_back({0, 1});
+
+    while (!stack.empty()) {
+        std::pair<uint32_t, int> top = stack.back();
+        stack.pop_back();
+
+        const OBBNode& node = nodes[top.first];
+        result = std::max(result, top.second);
+        if (!node.isLeaf()) {
+            stack.push_back({top.first + 1, top.second + 1});
+            stack.push_back({node.right, top.second + 1});
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Functionality: Removes the tree.
+ */
+void OBBTree::clear() {
+    nodes.clear();
+    vertices.clear();
+    triangles.clear();
+    triangleIndices.clear();
+}
+
+/**
+ * Functionality: Checks if the triangles of two trees intersect. Pairs of nodes are visited from the
+ * roots down, a pair is dropped as soon as its boxes are separated, and the larger box of an
+ * overlapping pair is split. Only pairs of overlapping leaves test their triangles.
+ * Parameter:
+ *     a: const OBBTree&, the first tree.
+ *     b: const OBBTree&, the second tree.
+ *     transform: const Eigen::Isometry3d&, the rigid transform that moves b into the space of a.
+ * Returns:
+ *     bool: Returns true if a triangle of a intersects or touches a triangle of b.
+ */
+bool OBBTree::intersects(const OBBTree& a, const OBBTree& b, const Eigen::Isometry3d& transform) {
+    if (a.nodes.empty() || b.nodes.empty()) return false;
+
+    std::vector<std::pair<uint32_t, uint32_t>> stack;
+    stack.push_back({0, 0});
+
+    while (!stack.empty()) {
+        std::pair<uint32_t, uint32_t> top = stack.back();
+        stack.pop_back();
+
+        const OBBNode& na = a.nodes[top.first];
+        const OBBNode& nb = b.nodes[top.second];
+        if (!na.box.overlaps(nb.box.transformed(transform))) continue;
+
+        if (na.isLeaf() && nb.isLeaf()) {
+            if (leavesIntersect(a, na, b, nb, transform)) return true;
+            continue;
+        }
+
+        if (nb.isLeaf() || (!na.isLeaf() && na.box.volume() >= nb.box.volume())) {
+            stack.push_back({na.right, top.second});
+            stack.push_back({top.first + 1, top.second});
+        } else {
+            stack.push_back({top.first, nb.right});
+            stack.push_back({top.first, top.second + 1});
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,372 @@
+#include "ObjParser.h"
+#include "MeshData.h"
+#include "PositionBuffer.h"
+#include "ThreadPool.h"
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// returns the end of a line continuation ('\' followed by a newline) starting at p, or p if there is none
+inline const char* skipContinuation(const char* p, const char* end)
+{
+    const char* q = p + 1;
+    while (q < end && *q == '\r') q++;
+
+    if (q == end) return q;
+    if (*q == '\n') return q + 1;
+
+    return p;
+}
+
+// skips blanks and line continuations, stops at the end of the record
+inline const char* skipBlanks(const char* p, const char* end)
+{
+    while (p < end) {
+        if (isBlank(*p)) {
+            p++;
+
+        } else if (*p == '\\') {
+            const char* q = skipContinuation(p, end);
+            if (q == p) break;
+            p = q;
+
+        } else {
+            break;
+        }
+    }
+
+    return p;
+}
+
+// checks if p is at the end of the record
+inline bool atRecordEnd(const char* p, const char* end)
+{
+    return p == end || *p == '\n' || *p == '#';
+}
+
+// moves p past the end of the current logical line
+inline const char* skipLine(const char* p, const char* end, bool continuations)
+{
+    while (p < end && *p != '\n') {
+        if (continuations && *p == '\\') {
+            const char* q = skipContinuation(p, end);
+            if (q != p) {
+                p = q;
+                continue;
+            }
+        }
+        p++;
+    }
+
+    return p < end ? p + 1 : p;
+}
+
+// moves p past the current token
+inline const char* skipToken(const char* p, const char* end)
+{
+    while (p < end && !isBlank(*p) && *p != '\n') p++;
+
+    return p;
+}
+
+// parses a floating point field, missing or malformed fields read as 0
+inline const char* parseDouble(const char* p, const char* end, double& value)
+{
+    value = 0.0;
+    p = skipBlanks(p, end);
+    if (atRecordEnd(p, end)) return p;
+
+    const char* start = p;
+    if (*start == '+') start++;
+
+    std::from_chars_result result = std::from_chars(start, end, value);
+    if (result.ec != std::errc()) {
+        value = 0.0;
+        if (result.ec == std::errc::invalid_argument) return skipToken(p, end);
+    }
+
+    return result.ptr;
+}
+
+// converts a 1-based or negative (relative) obj index to a 0-based index, -1 if missing
+inline int resolveIndex(int i, size_t count)
+{
+    if (i > 0) return i - 1;
+    if (i < 0) return (int)count + i;
+
+    return -1;
+}
+
+// a corner whose indices were relative, mask bits 0, 1, 2 flag position, uv and normal
+struct RelativeCorner {
+    int corner;
+    int mask;
+};
+
+// parses a v, v/vt, v//vn or v/vt/vn token, returns a mask of the relative indices
+inline const char* parseCorner(const char* p, const char* end, const MeshData& data, Index& index, int& mask)
+{
+    int values[3] = {0, 0, 0};
+
+    for (int i = 0; i < 3 && p < end; i++) {
+        const char* start = p;
+        if (*start == '+') start++;
+
+        std::from_chars_result result = std::from_chars(start, end, values[i]);
+        if (result.ec == std::errc()) p = result.ptr;
+
+        if (p < end && *p == '/') p++;
+        else break;
+    }
+
+    index.position = resolveIndex(values[0], data.positions.size());
+    index.uv = resolveIndex(values[1], data.uvs.size());
+    index.normal = resolveIndex(values[2], data.normals.size());
+    mask = (values[0] < 0 ? 1 : 0) | (values[1] < 0 ? 2 : 0) | (values[2] < 0 ? 4 : 0);
+
+    return skipToken(p, end);
+}
+
+// parses records into data, relative indices are resolved against the counts in data and
+// recorded in relative when it is given so that they can be rebased later
+void parseRecords(const char* begin, const char* end, MeshData& data, std::vector<RelativeCorner>* relative)
+{
+    const char* p = begin;
+    while (p < end) {
+        p = skipBlanks(p, end);
+        if (p == end) break;
+
+        // isolate the record keyword
+        const char* keyword = p;
+        p = skipToken(p, end);
+        size_t length = p - keyword;
+
+        if (length == 1 && keyword[0] == 'v') {
+            double x, y, z;
+            p = parseDouble(p, end, x);
+            p = parseDouble(p, end, y);
+            p = parseDouble(p, end, z);
+
+            data.positions.emplace_back(x, y, z);
+
+        } else if (length == 2 && keyword[0] == 'v' && keyword[1] == 't') {
+            double u, v;
+            p = parseDouble(p, end, u);
+            p = parseDouble(p, end, v);
+
+            data.uvs.emplace_back(u, v, 0);
+
+        } else if (length == 2 && keyword[0] == 'v' && keyword[1] == 'n') {
+            double x, y, z;
+            p = parseDouble(p, end, x);
+            p = parseDouble(p, end, y);
+            p = parseDouble(p, end, z);
+
+            data.normals.emplace_back(x, y, z);
+
+        } else if (length == 1 && keyword[0] == 'f') {
+            while (true) {
+                p = skipBlanks(p, end);
+                if (atRecordEnd(p, end)) break;
+
+                // a lone backslash not followed by a newline carries no index
+                if (*p == '\\') {
+                    p = skipToken(p, end);
+                    continue;
+                }
+
+                Index index;
+                int mask;
+                p = parseCorner(p, end, data, index, mask);
+                if (mask && relative) relative->push_back(RelativeCorner{(int)data.indices.size(), mask});
+                data.indices.push_back(index);
+            }
+
+            data.faceOffsets.push_back((int)data.indices.size());
+        }
+
+        // comments and unknown records end at the next newline
+        bool continuations = keyword[0] != '#';
+        p = skipLine(p, end, continuations);
+    }
+}
+
+// records parsed from one chunk of the buffer
+struct Fragment {
+    MeshData data;
+    std::vector<RelativeCorner> relative;
+};
+
+} // namespace
+
+
+/**
+ * Functionality: Parses an obj buffer without copying it. Handles v, vt, vn and f records,
+ * 1-based and negative (relative) face indices, comments and '\' line continuations.
+ * Parameter:
+ *     begin: const char*, the first byte of the buffer.
+ *     end: const char*, one past the last byte of the buffer.
+ *     data: MeshData&, receives positions, uvs, normals and face corners.
+ * Returns:
+ *     bool: Returns true once the buffer has been consumed.
+ */
+bool ObjParser::parse(const char* begin, const char* end, MeshData& data)
+{
+    parseRecords(begin, end, data, nullptr);
+
+    return true;
+}
+
+/**
+ * Functionality: Parses an obj buffer on several threads. The buffer is split at newlines that do not
+ * continue a record, each chunk is parsed into its own fragment, and the fragments are merged in file
+ * order with their indices rebased, so the result is identical to the serial parse.
+ * Parameter:
+ *     begin: const char*, the first byte of the buffer.
+ *     end: const char*, one past the last byte of the buffer.
+ *     data: MeshData&, receives positions, uvs, normals and face corners.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Returns:
+ *     bool: Returns true once the buffer has been consumed.
+ */
+bool ObjParser::parse(const char* begin, const char* end, MeshData& data, int threads)
+{
+    const size_t minChunkSize = 1 << 20;
+    threads = ThreadPool::resolveThreadCount(threads);
+
+    // a few chunks per thread balance uneven record densities
+    size_t size = end - begin;
+    size_t chunks = std::min<size_t>(4 * threads, size / minChunkSize);
+    if (threads == 1 || chunks < 2) {
+        return parse(begin, end, data);
+    }
+
+    std::vector<const char*> bounds(1, begin);
+    for (size_t i = 1; i < chunks; i++) {
+        const char* p = ObjParser::nextRecordStart(begin + i * size / chunks, begin, end);
+        if (p > bounds.back() && p < end) bounds.push_back(p);
+    }
+    bounds.push_back(end);
+
+    // parse chunks into fragments
+    std::vector<Fragment> fragments(bounds.size() - 1);
+    ThreadPool::global().parallelFor(fragments.size(), [&](size_t i) {
+        parseRecords(bounds[i], bounds[i+1], fragments[i].data, &fragments[i].relative);
+    }, threads);
+
+    // offsets of each fragment in the merged arrays
+    std::vector<size_t> positionBase(fragments.size()), uvBase(fragments.size()), normalBase(fragments.size());
+    std::vector<size_t> cornerBase(fragments.size()), faceBase(fragments.size());
+    size_t nP = data.positions.size(), nT = data.uvs.size(), nN = data.normals.size();
+    size_t nC = data.indices.size(), nF = data.faceCount();
+    for (size_t i = 0; i < fragments.size(); i++) {
+        const MeshData& fragment = fragments[i].data;
+        positionBase[i] = nP; nP += fragment.positions.size();
+        uvBase[i] = nT; nT += fragment.uvs.size();
+        normalBase[i] = nN; nN += fragment.normals.size();
+        cornerBase[i] = nC; nC += fragment.indices.size();
+        faceBase[i] = nF; nF += fragment.faceCount();
+    }
+
+    data.positions.resize(nP);
+    data.uvs.resize(nT);
+    data.normals.resize(nN);
+    data.indices.resize(nC);
+    data.faceOffsets.resize(nF + 1);
+
+    // copy fragments into place, relative indices are rebased onto the elements preceding the fragment
+    ThreadPool::global().parallelFor(fragments.size(), [&](size_t i) {
+        MeshData& fragment = fragments[i].data;
+        std::copy(fragment.positions.begin(), fragment.positions.end(), data.positions.begin() + positionBase[i]);
+        std::copy(fragment.uvs.begin(), fragment.uvs.end(), data.uvs.begin() + uvBase[i]);
+        std::copy(fragment.normals.begin(), fragment.normals.end(), data.normals.begin() + normalBase[i]);
+
+        for (const RelativeCorner& r : fragments[i].relative) {
+            Index& index = fragment.indices[r.corner];
+            if (r.mask & 1) index.position += (int)positionBase[i];
+            if (r.mask & 2) index.uv += (int)uvBase[i];
+            if (r.mask & 4) index.normal += (int)normalBase[i];
+        }
+        std::copy(fragment.indices.begin(), fragment.indices.end(), data.indices.begin() + cornerBase[i]);
+
+        for (int f = 1; f <= fragment.faceCount(); f++) {
+            data.faceOffsets[faceBase[i] + f] = fragment.faceOffsets[f] + (int)cornerBase[i];
+        }
+
+        fragment = MeshData();
+    }, threads);
+
+    return true;
+}
+
+/**
+ * Functionality: Parses the v records of an obj buffer into a position buffer, at most maxCount at a time,
+ * so that a large file can be streamed through a small buffer. Other records are skipped with the same
+ * rules as the full parse, so the positions are those the full parse reads.
+ * Parameter:
+ *     begin: const char*, the start of a record.
+ *     end: const char*, one past the last byte of the buffer.
+ *     positions: PositionBuffer&, receives the positions.
+ *     maxCount: size_t, the number of positions after which parsing stops.
+ * Returns:
+ *     const char*: The start of the record after the last one parsed, end once the buffer is consumed.
+ */
+const char* ObjParser::parsePositions(const char* begin, const char* end, PositionBuffer& positions, size_t maxCount)
+{
+    const char* p = begin;
+    size_t count = 0;
+    while (p < end && count < maxCount) {
+        p = skipBlanks(p, end);
+        if (p == end) break;
+
+        const char* keyword = p;
+        p = skipToken(p, end);
+
+        if (p - keyword == 1 && keyword[0] == 'v') {
+            Eigen::Vector3d position;
+            p = parseDouble(p, end, position.x());
+            p = parseDouble(p, end, position.y());
+            p = parseDouble(p, end, position.z());
+
+            positions.push_back(position);
+            count++;
+        }
+
+        bool continuations = keyword[0] != '#';
+        p = skipLine(p, end, continuations);
+    }
+
+    return p;
+}
+
+/**
+ * Functionality: Finds a point at which an obj buffer can be split: the byte after a newline that does
+ * not end in a '\' line continuation.
+ * Parameter:
+ *     p: const char*, where to start looking.
+ *     begin: const char*, the first byte of the buffer.
+ *     end: const char*, one past the last byte of the buffer.
+ * Returns:
+ *     const char*: The start of the next record, or end if there is none.
+ */
+const char* ObjParser::nextRecordStart(const char* p, const char* begin, const char* end)
+{
+    while (p < end) {
+        const char* newline = static_cast<const char*>(memchr(p, '\n', end - p));
+        if (!newline) return end;
+
+        const char* q = newline;
+        while (q > begin && q[-1] == '\r') q--;
+        if (q == begin || q[-1] != '\\') return newline + 1;
+
+        p = newline + 1;
+    }
+
+    return end;
+}
@@ -0,0 +1,166 @@
+#include "ObjWriter.h"
+
+#include "Mesh.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+// a growing character buffer that numbers are formatted into with std::to_chars
+class TextBuffer {
+public:
+    // drops the text, keeping the memory
+    void clear() { size = 0; }
+
+    // appends characters
+    void append(const char* s, size_t n) {
+        std::memcpy(reserve(n), s, n);
+        size += n;
+    }
+
+    // appends a character
+    void append(char c) {
+        *reserve(1) = c;
+        size++;
+    }
+
+    // appends the shortest text that reads back as the same double
+    void append(double x) {
+        char* p = reserve(maxNumberLength);
+        size = std::to_chars(p, p + maxNumberLength, x).ptr - buffer.data();
+    }
+
+    // appends an unsigned integer
+    void append(uint32_t x) {
+        char* p = reserve(maxNumberLength);
+        size = std::to_chars(p, p + maxNumberLength, x).ptr - buffer.data();
+    }
+
+    const char* data() const { return buffer.data(); }
+    size_t length() const { return size; }
+
+private:
+    // returns room for n more characters
+    char* reserve(size_t n) {
+        if (buffer.size() < size + n) buffer.resize(std::max(2 * buffer.size(), size + n));
+        return buffer.data() + size;
+    }
+
+    // longer than any double or 32-bit integer std::to_chars produces
+    static constexpr size_t maxNumberLength = 32;
+
+    std::vector<char> buffer;
+    size_t size = 0;
+};
+
+// formats records [0, count) with format(i, buffer) in blocks on the thread pool and writes the blocks in
+// order, a few blocks per thread at a time so that memory stays bounded
+template <typename Format>
+void writeRecords(std::ostream& out, size_t count, int threads, std::vector<TextBuffer>& buffers, Format format) {
+    size_t blocks = (count + ObjWriter::blockSize - 1) / ObjWriter::blockSize;
+
+    for (size_t first = 0; first < blocks && out; first += buffers.size()) {
+        size_t group = std::min(buffers.size(), blocks - first);
+
+        ThreadPool::global().parallelFor(group, [&](size_t i) {
+            size_t begin = (first + i) * ObjWriter::blockSize;
+            size_t end = std::min(count, begin + ObjWriter::blockSize);
+
+            buffers[i].clear();
+            for (size_t r = begin; r < end; r++) {
+                format(r, buffers[i]);
+            }
+        }, threads);
+
+        for (size_t i = 0; i < group; i++) {
+            out.write(buffers[i].data(), buffers[i].length());
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * Functionality: Writes a mesh as obj text: a v record per vertex, a vt record per uv, a vn record per
+ * normal and an f record per face, skipping the faces that close boundary loops. Corners are written
+ * as v, v/vt, v//vn or v/vt/vn depending on which indices the halfedge has. Numbers are written with
+ * the fewest digits that read back as the same double. The output is the same for every thread count.
+ * Parameter:
+ *     out: std::ostream&, the stream to write to.
+ *     mesh: const Mesh&, the mesh, which is not modified.
+ *     threads: int, the number of threads to format on, 0 for all hardware threads.
+ * Returns:
+ *     bool: Returns false if the stream fails.
+ */
+bool ObjWriter::write(std::ostream& out, const Mesh& mesh, int threads) {
+    ScopedTimer timer("ObjWriter::write");
+    timer.addElements(mesh.faces.size());
+
+    threads = ThreadPool::resolveThreadCount(threads);
+    std::vector<TextBuffer> buffers(threads == 1 ? 1 : 2 * threads);
+
+    writeRecords(out, mesh.vertices.size(), threads, buffers, [&](size_t i, TextBuffer& text) {
+        const Eigen::Vector3d& p = mesh.vertices[i].position;
+        text.append("v ", 2);
+        text.append(p.x());
+        text.append(' ');
+        text.append(p.y());
+        text.append(' ');
+        text.append(p.z());
+        text.append('\n');
+    });
+
+    writeRecords(out, mesh.uvs.size(), threads, buffers, [&](size_t i, TextBuffer& text) {
+        const Eigen::Vector3d& uv = mesh.uvs[i];
+        text.append("vt ", 3);
+        text.append(uv.x());
+        text.append(' ');
+        text.append(uv.y());
+        text.append('\n');
+    });
+
+    writeRecords(out, mesh.normals.size(), threads, buffers, [&](size_t i, TextBuffer& text) {
+        const Eigen::Vector3d& n = mesh.normals[i];
+        text.append("vn ", 3);
+        text.append(n.x());
+        text.append(' ');
+        text.append(n.y());
+        text.append(' ');
+        text.append(n.z());
+        text.append('\n');
+    });
+
+    writeRecords(out, mesh.faces.size(), threads, buffers, [&](size_t i, TextBuffer& text) {
+        // buildMesh points a face at its last halfedge, starting after it keeps the corner order of the file
+        HalfEdgeId start = mesh.faces[i].he;
+        if (mesh.halfEdges[start].onBoundary) return;
+        start = mesh.halfEdges[start].next;
+
+        text.append('f');
+        HalfEdgeId he = start;
+        do {
+            const HalfEdge& h = mesh.halfEdges[he];
+            text.append(' ');
+            text.append(h.vertex + 1);
+            if (h.uv != InvalidId) {
+                text.append('/');
+                text.append(h.uv + 1);
+            }
+            if (h.normal != InvalidId) {
+                if (h.uv == InvalidId) text.append('/');
+                text.append('/');
+                text.append(h.normal + 1);
+            }
+
+            he = h.next;
+        } while (he != start);
+        text.append('\n');
+    });
+
+    out.flush();
+    return !out.fail();
+}
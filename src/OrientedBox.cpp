@@ -0,0 +1,117 @@
+#include "OrientedBox.h"
+
+#include "BoundingBox.h"
+
+#include <algorithm>
+
+/**
+ * Functionality: Creates an empty box at the origin.
+ */
+OrientedBox::OrientedBox()
+    : center(Eigen::Vector3d::Zero()), axes(Eigen::Matrix3d::Identity()), halfExtents(Eigen::Vector3d::Zero()) {}
+
+/**
+ * Functionality: Creates a box from its center, axes and half side lengths.
+ * Parameter:
+ *     center: const Eigen::Vector3d&, the center of the box.
+ *     axes: const Eigen::Matrix3d&, the unit axes of the box as columns.
+ *     halfExtents: const Eigen::Vector3d&, half the side length along each axis.
+ */
+OrientedBox::OrientedBox(const Eigen::Vector3d& center, const Eigen::Matrix3d& axes, const Eigen::Vector3d& halfExtents)
+    : center(center), axes(axes), halfExtents(halfExtents) {}
+
+/**
+ * Functionality: Takes the box of a bounding box. An oriented bounding box stores the two ends of
+ * its range along each axis in orientedPoints, the axes are the directions between the ends. Axes
+ * along which the box is flat are completed to an orthonormal frame. Any other bounding box is read
+ * from its min and max corners.
+ * Parameter:
+ *     boundingBox: const BoundingBox&, the bounding box.
+ */
+OrientedBox::OrientedBox(const BoundingBox& boundingBox) {
+    const std::vector<Eigen::Vector3d>& points = boundingBox.orientedPoints;
+    if (points.size() != 6) {
+        center = (boundingBox.min + boundingBox.max) / 2;
+        axes = Eigen::Matrix3d::Identity();
+        halfExtents = (boundingBox.max - boundingBox.min) / 2;
+        return;
+    }
+
+    Eigen::Vector3d sides[3], mids[3];
+    for (int i = 0; i < 3; i++) {
+        sides[i] = points[2*i + 1] - points[2*i];
+        mids[i] = (points[2*i] + points[2*i + 1]) / 2;
+        halfExtents[i] = sides[i].norm() / 2;
+    }
+
+    // fill the axes from the longest side down
+    int order[3] = {0, 1, 2};
+    std::sort(order, order + 3, [&](int a, int b) { return halfExtents[a] > halfExtents[b]; });
+
+    axes = Eigen::Matrix3d::Identity();
+    if (halfExtents[order[0]] > 0) {
+        Eigen::Vector3d first = sides[order[0]].normalized();
+        Eigen::Vector3d second = sides[order[1]] - first * first.dot(sides[order[1]]);
+        second = second.squaredNorm() > 0 ? second.normalized() : first.unitOrthogonal();
+
+        axes.col(order[0]) = first;
+        axes.col(order[1]) = second;
+        axes.col(order[2]) = first.cross(second);
+    }
+
+    // the midpoint of the range along axis i has the center's coordinate along that axis
+    center = Eigen::Vector3d::Zero();
+    for (int i = 0; i < 3; i++) {
+        center += axes.col(i) * axes.col(i).dot(mids[i]);
+    }
+}
+
+/**
+ * Functionality: Moves the box by a rigid transform.
+ * Parameter:
+ *     transform: const Eigen::Isometry3d&, a rotation followed by a translation.
+ * Returns:
+ *     OrientedBox: The moved box.
+ */
+OrientedBox OrientedBox::transformed(const Eigen::Isometry3d& transform) const {
+    return OrientedBox(transform * center, transform.linear() * axes, halfExtents);
+}
+
+/**
+ * Functionality: Checks if two boxes overlap. The boxes are disjoint exactly if their projections
+ * are disjoint on one of 15 axes: the 3 axes of each box and the 9 cross products of an axis of
+ * one box with an axis of the other.
+ * Parameter:
+ *     other: const OrientedBox&, the other box.
+ * Returns:
+ *     bool: Returns true if the boxes overlap or touch.
+ */
+bool OrientedBox::overlaps(const OrientedBox& other) const {
+    // the other box in the frame of this box, the small epsilon keeps near parallel edges
+    // from producing a cross product axis that separates by rounding alone
+    Eigen::Matrix3d r = axes.transpose() * other.axes;
+    Eigen::Matrix3d absR = r.cwiseAbs().array() + 1e-12;
+    Eigen::Vector3d t = axes.transpose() * (other.center - center);
+    const Eigen::Vector3d& a = halfExtents;
+    const Eigen::Vector3d& b = other.halfExtents;
+
+    for (int i = 0; i < 3; i++) {
+        if (std::abs(t[i]) > a[i] + b.dot(absR.row(i))) return false;
+    }
+
+    for (int j = 0; j < 3; j++) {
+        if (std::abs(t.dot(r.col(j))) > a.dot(absR.col(j)) + b[j]) return false;
+    }
+
+    for (int i = 0; i < 3; i++) {
+        int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; j++) {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            double ra = a[i1] * absR(i2, j) + a[i2] * absR(i1, j);
+            double rb = b[j1] * absR(i, j2) + b[j2] * absR(i, j1);
+            if (std::abs(t[i2] * r(i1, j) - t[i1] * r(i2, j)) > ra + rb) return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,84 @@
+#include "OrientedBoxBuffer.h"
+
+#include "BoundingBox.h"
+
+/**
+ * Functionality: Resizes the buffer.
+ * Parameter:
+ *     n: size_t, the new number of boxes.
+ */
+void OrientedBoxBuffer::resize(size_t n) {
+    for (std::vector<double>& v : values) v.resize(n);
+}
+
+/**
+ * Functionality: Removes all boxes.
+ */
+void OrientedBoxBuffer::clear() {
+    for (std::vector<double>& v : values) v.clear();
+}
+
+/**
+ * Functionality: Packs a set of bounding boxes, oriented boxes are read from their orientedPoints.
+ * Parameter:
+ *     boxes: const std::vector<BoundingBox>&, the boxes.
+ */
+void OrientedBoxBuffer::assign(const std::vector<BoundingBox>& boxes) {
+    resize(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) set(i, OrientedBox(boxes[i]));
+}
+
+/**
+ * Functionality: Appends a box.
+ * Parameter:
+ *     box: const OrientedBox&, the box.
+ */
+void OrientedBoxBuffer::push_back(const OrientedBox& box) {
+    resize(size() + 1);
+    set(size() - 1, box);
+}
+
+/**
+ * Functionality: Stores a box.
+ * Parameter:
+ *     i: size_t, the index of the box.
+ *     box: const OrientedBox&, the box.
+ */
+void OrientedBoxBuffer::set(size_t i, const OrientedBox& box) {
+    for (int k = 0; k < 3; k++) {
+        values[k][i] = box.center[k];
+        values[12 + k][i] = box.halfExtents[k];
+    }
+    for (int k = 0; k < 9; k++) {
+        values[3 + k][i] = box.axes.data()[k];
+    }
+}
+
+/**
+ * Functionality: Unpacks a box.
+ * Parameter:
+ *     i: size_t, the index of the box.
+ * Returns:
+ *     OrientedBox: The box.
+ */
+OrientedBox OrientedBoxBuffer::get(size_t i) const {
+    OrientedBox box;
+    for (int k = 0; k < 3; k++) {
+        box.center[k] = values[k][i];
+        box.halfExtents[k] = values[12 + k][i];
+    }
+    for (int k = 0; k < 9; k++) {
+        box.axes.data()[k] = values[3 + k][i];
+    }
+
+    return box;
+}
+
+/**
+ * Functionality: Collects the value arrays for the overlap kernels.
+ * Parameter:
+ *     result: const double*[15], receives a pointer to each value array.
+ */
+void OrientedBoxBuffer::arrays(const double* result[15]) const {
+    for (int k = 0; k < 15; k++) result[k] = values[k].data();
+}
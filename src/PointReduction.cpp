@@ -0,0 +1,225 @@
+#include "PointReduction.h"
+
+#include "SimdKernels.h"
+#include "ThreadPool.h"
+
+/**
+ * Functionality: Hands out the coordinates of a range of points of the buffer.
+ * Parameter:
+ *     begin, end: size_t, the range of points.
+ *     scratch: PositionBuffer&, unused, the points are read in place.
+ *     x, y, z: const double*&, receive pointers to the coordinates of point begin.
+ */
+void PositionBufferSource::block(size_t begin, size_t end, PositionBuffer& scratch,
+                                 const double*& x, const double*& y, const double*& z) const {
+    x = positions.x.data() + begin;
+    y = positions.y.data() + begin;
+    z = positions.z.data() + begin;
+}
+
+/**
+ * Default constructor for PointMoments.
+ * Initializes the moments of an empty set of points.
+ */
+PointMoments::PointMoments() : count(0),
+                               mean(Eigen::Vector3d::Zero()),
+                               scatter(Eigen::Matrix3d::Zero()) {
+}
+
+/**
+ * Functionality: Merges the moments of another set of points into these, as if both sets had been
+ * accumulated together. The scatter matrices are combined about the shifted mean, which stays
+ * accurate for points far from the origin.
+ * Parameter:
+ *     other: const PointMoments&, the moments of the other set.
+ */
+void PointMoments::merge(const PointMoments& other) {
+    if (other.count == 0) return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+
+    double total = count + other.count;
+    Eigen::Vector3d delta = other.mean - mean;
+
+    mean += delta * (other.count / total);
+    scatter += other.scatter + delta * delta.transpose() * (count * other.count / total);
+    count = total;
+}
+
+namespace {
+
+// number of blocks covering n points
+size_t blockCount(size_t n) {
+    return (n + PointReduction::blockSize - 1) / PointReduction::blockSize;
+}
+
+// runs body(begin, end, x, y, z) for every block of the source, blocks are processed in parallel
+template <typename Body>
+void forEachBlock(const PointSource& points, int threads, const Body& body) {
+    size_t n = points.size();
+
+    ThreadPool::global().parallelFor(blockCount(n), [&](size_t b) {
+        size_t begin = b * PointReduction::blockSize;
+        size_t end = std::min(n, begin + PointReduction::blockSize);
+
+        thread_local PositionBuffer scratch;
+        const double* x;
+        const double* y;
+        const double* z;
+        points.block(begin, end, scratch, x, y, z);
+
+        body(b, end - begin, x, y, z);
+    }, ThreadPool::resolveThreadCount(threads));
+}
+
+} // namespace
+
+/**
+ * Functionality: Computes the moments of a set of points. Each block is reduced while it is in
+ * cache, its mean first and then its scatter about that mean, and the blocks are merged in order.
+ * Parameter:
+ *     points: const PointSource&, the points.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Returns:
+ *     PointMoments: The count, mean and scatter matrix of the points.
+ */
+PointMoments PointReduction::moments(const PointSource& points, int threads) {
+    std::vector<PointMoments> blocks(blockCount(points.size()));
+
+    forEachBlock(points, threads, [&blocks](size_t b, size_t n, const double* x, const double* y, const double* z) {
+        PointMoments& m = blocks[b];
+        m.count = (double)n;
+
+        SimdKernels::sum(x, y, z, n, m.mean.data());
+        m.mean /= m.count;
+
+        double s[6];
+        SimdKernels::scatter(x, y, z, n, m.mean.data(), s);
+        m.scatter << s[0], s[1], s[2],
+                     s[1], s[3], s[4],
+                     s[2], s[4], s[5];
+    });
+
+    PointMoments result;
+    for (const PointMoments& m : blocks) {
+        result.merge(m);
+    }
+
+    return result;
+}
+
+/**
+ * Functionality: Computes the moments of a triangulated surface with uniform density, so that the
+ * result does not depend on how finely the surface is tessellated. Each block of triangles is
+ * integrated in one pass about its first corner, then the blocks are merged in order.
+ * Parameter:
+ *     positions: const PositionBuffer&, the triangle corners.
+ *     triangles: const std::vector<uint32_t>&, three indices into positions per triangle.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Returns:
+ *     PointMoments: The total area as count, the area-weighted centroid as mean and the second
+ *                   moment of the surface about the centroid as scatter.
+ */
+PointMoments PointReduction::surfaceMoments(const PositionBuffer& positions, const std::vector<uint32_t>& triangles,
+                                            int threads) {
+    size_t count = triangles.size() / 3;
+    std::vector<PointMoments> blocks(blockCount(count));
+
+    ThreadPool::global().parallelFor(blocks.size(), [&](size_t b) {
+        size_t begin = b * blockSize;
+        size_t end = std::min(count, begin + blockSize);
+        const uint32_t* corners = triangles.data() + 3 * begin;
+
+        Eigen::Vector3d reference = positions.get(corners[0]);
+        double s[10];
+        SimdKernels::surfaceMoments(positions.x.data(), positions.y.data(), positions.z.data(), corners,
+                                    end - begin, reference.data(), s);
+        if (s[0] <= 0) return;
+
+        // shift the second moment from the reference point to the centroid
+        PointMoments& m = blocks[b];
+        Eigen::Vector3d centroid = Eigen::Vector3d(s[1], s[2], s[3]) / s[0];
+        m.count = s[0];
+        m.mean = reference + centroid;
+        m.scatter << s[4], s[5], s[6],
+                     s[5], s[7], s[8],
+                     s[6], s[8], s[9];
+        m.scatter -= s[0] * centroid * centroid.transpose();
+    }, ThreadPool::resolveThreadCount(threads));
+
+    PointMoments result;
+    for (const PointMoments& m : blocks) {
+        result.merge(m);
+    }
+
+    return result;
+}
+
+/**
+ * Functionality: Copies the points of a source into a position buffer, block by block.
+ * Parameter:
+ *     points: const PointSource&, the points.
+ *     positions: PositionBuffer&, receives the points.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ */
+void PointReduction::copy(const PointSource& points, PositionBuffer& positions, int threads) {
+    positions.resize(points.size());
+
+    forEachBlock(points, threads, [&](size_t b, size_t n, const double* x, const double* y, const double* z) {
+        size_t begin = b * blockSize;
+        std::copy(x, x + n, positions.x.begin() + begin);
+        std::copy(y, y + n, positions.y.begin() + begin);
+        std::copy(z, z + n, positions.z.begin() + begin);
+    });
+}
+
+/**
+ * Functionality: Computes the per-axis range of a set of points.
+ * Parameter:
+ *     points: const PointSource&, the points.
+ *     min, max: Eigen::Vector3d&, receive the range, +/-infinity if there are no points.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ */
+void PointReduction::minMax(const PointSource& points, Eigen::Vector3d& min, Eigen::Vector3d& max, int threads) {
+    std::vector<Eigen::Vector3d> mins(blockCount(points.size())), maxs(mins.size());
+
+    forEachBlock(points, threads, [&](size_t b, size_t n, const double* x, const double* y, const double* z) {
+        SimdKernels::minMax(x, y, z, n, mins[b].data(), maxs[b].data());
+    });
+
+    min = Eigen::Vector3d::Constant(INFINITY);
+    max = Eigen::Vector3d::Constant(-INFINITY);
+    for (size_t b = 0; b < mins.size(); b++) {
+        min = min.cwiseMin(mins[b]);
+        max = max.cwiseMax(maxs[b]);
+    }
+}
+
+/**
+ * Functionality: Projects a set of points relative to center on three axes and computes the range
+ * of the projections.
+ * Parameter:
+ *     points: const PointSource&, the points.
+ *     center: const Eigen::Vector3d&, the origin of the projection.
+ *     axes: const Eigen::Matrix3d&, the axes stored as columns.
+ *     min, max: Eigen::Vector3d&, receive the range along each axis, +/-infinity if there are no points.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ */
+void PointReduction::projectMinMax(const PointSource& points, const Eigen::Vector3d& center, const Eigen::Matrix3d& axes,
+                                   Eigen::Vector3d& min, Eigen::Vector3d& max, int threads) {
+    std::vector<Eigen::Vector3d> mins(blockCount(points.size())), maxs(mins.size());
+
+    // the column-major matrix stores the axes one after another
+    forEachBlock(points, threads, [&](size_t b, size_t n, const double* x, const double* y, const double* z) {
+        SimdKernels::projectMinMax(x, y, z, n, center.data(), axes.data(), mins[b].data(), maxs[b].data());
+    });
+
+    min = Eigen::Vector3d::Constant(INFINITY);
+    max = Eigen::Vector3d::Constant(-INFINITY);
+    for (size_t b = 0; b < mins.size(); b++) {
+        min = min.cwiseMin(mins[b]);
+        max = max.cwiseMax(maxs[b]);
+    }
+}
@@ -0,0 +1,46 @@
+#include "PositionBuffer.h"
+#include "Vertex.h"
+
+/**
+ * Functionality: Resizes the buffer.
+ * Parameter:
+ *     n: size_t, the new number of points.
+ */
+void PositionBuffer::resize(size_t n) {
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+}
+
+/**
+ * Functionality: Removes all points from the buffer.
+ */
+void PositionBuffer::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+}
+
+/**
+ * Functionality: Copies vertex positions into the buffer, replacing its contents.
+ * Parameter:
+ *     vertices: const std::vector<Vertex>&, the vertices whose positions are copied.
+ */
+void PositionBuffer::assign(const std::vector<Vertex>& vertices) {
+    resize(vertices.size());
+
+    for (size_t i = 0; i < vertices.size(); i++) {
+        set(i, vertices[i].position);
+    }
+}
+
+/**
+ * Functionality: Appends a point to the buffer.
+ * Parameter:
+ *     p: const Eigen::Vector3d&, the point to append.
+ */
+void PositionBuffer::push_back(const Eigen::Vector3d& p) {
+    x.push_back(p.x());
+    y.push_back(p.y());
+    z.push_back(p.z());
+}
@@ -0,0 +1,145 @@
+#include "Profiler.h"
+
+#include "Diagnostics.h"
+#include "Json.h"
+
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <unistd.h>
+
+std::atomic<bool> Profiler::active(false);
+
+namespace {
+
+// one finished stage, as shown in the trace
+struct TraceEvent {
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+    std::chrono::steady_clock::time_point end;
+    int thread;
+    size_t elements;
+    size_t bytes;
+};
+
+// everything the profiler collected, behind one lock as stages finish rarely
+struct ProfileData {
+    std::mutex mutex;
+    ProfileStats stats;
+    std::vector<TraceEvent> events;
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+};
+
+ProfileData& profileData() {
+    static ProfileData* data = new ProfileData();
+    return *data;
+}
+
+// returns a small number naming the calling thread in the trace
+int threadNumber() {
+    static std::atomic<int> next(0);
+    thread_local int number = next++;
+    return number;
+}
+
+} // namespace
+
+/**
+ * Functionality: Starts or stops collecting stages. Stages entered while the profiler is off are not
+ * recorded, stages that are running when it is switched off still are.
+ * Parameter:
+ *     enabled: bool, true to collect.
+ */
+void Profiler::setEnabled(bool enabled) {
+    active.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * Functionality: Returns a copy of the stage totals.
+ * Returns:
+ *     ProfileStats: The totals of every stage that ran since the last reset.
+ */
+ProfileStats Profiler::stats() {
+    ProfileData& data = profileData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    ProfileStats stats = data.stats;
+    stats.traceEvents = data.events.size();
+    return stats;
+}
+
+/**
+ * Functionality: Drops the totals and the trace events and restarts the trace clock.
+ */
+void Profiler::reset() {
+    ProfileData& data = profileData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    data.stats = ProfileStats();
+    data.events.clear();
+    data.origin = std::chrono::steady_clock::now();
+}
+
+/**
+ * Functionality: Adds a finished stage to the totals and, while there is room, to the trace.
+ * Parameter:
+ *     name: const char*, the stage name, a string literal.
+ *     start: std::chrono::steady_clock::time_point, when the stage started.
+ *     end: std::chrono::steady_clock::time_point, when the stage finished.
+ *     elements: size_t, the number of elements processed.
+ *     bytes: size_t, the number of bytes allocated.
+ */
+void Profiler::record(const char* name, std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point end, size_t elements, size_t bytes) {
+    int thread = threadNumber();
+    ProfileData& data = profileData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    StageStats& stage = data.stats.stages[name];
+    stage.calls++;
+    stage.seconds += std::chrono::duration<double>(end - start).count();
+    stage.elements += elements;
+    stage.bytes += bytes;
+
+    if (data.events.size() < maxTraceEvents) {
+        data.events.push_back(TraceEvent{name, start, end, thread, elements, bytes});
+    } else {
+        data.stats.droppedEvents++;
+    }
+}
+
+/**
+ * Functionality: Writes the trace events as complete ("X") events of the Chrome trace-event format,
+ * one track per thread. Nested stages show as nested slices.
+ * Parameter:
+ *     fileName: const std::string&, the JSON file.
+ * Returns:
+ *     bool: Returns false if the file cannot be written.
+ */
+bool Profiler::writeChromeTrace(const std::string& fileName) {
+    std::ofstream out(fileName.c_str());
+    if (!out.is_open()) {
+        Log::write(LogError, "Could not open " + fileName + " for writing");
+        return false;
+    }
+
+    ProfileData& data = profileData();
+    std::lock_guard<std::mutex> lock(data.mutex);
+
+    int process = (int)::getpid();
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < data.events.size(); i++) {
+        const TraceEvent& event = data.events[i];
+        double start = std::chrono::duration<double, std::micro>(event.start - data.origin).count();
+        double duration = std::chrono::duration<double, std::micro>(event.end - event.start).count();
+
+        out << (i > 0 ? ",\n" : "\n") << "{\"name\":" << Json::quote(event.name)
+            << ",\"cat\":\"meshlib\",\"ph\":\"X\",\"ts\":" << start << ",\"dur\":" << duration
+            << ",\"pid\":" << process << ",\"tid\":" << event.thread << ",\"args\":{\"elements\":" << event.elements
+            << ",\"bytes\":" << event.bytes << "}}";
+    }
+    out << "\n]}\n";
+
+    return (bool)out;
+}
@@ -0,0 +1,296 @@
+#include "ResultCache.h"
+
+#include "Diagnostics.h"
+#include "Hash.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+const char entryMagic[8] = {'O', 'M', 'R', 'E', 'S', 'U', 'L', 'T'};
+
+const char* const entryExtension = ".box";
+
+// contents of an entry file
+struct EntryRecord {
+    char magic[8];
+    uint32_t version;
+    uint32_t hasOrientedBox;
+    uint64_t key;
+    // axis-aligned min and max, then the six oriented points
+    double boxes[24];
+    uint64_t vertexCount;
+    uint64_t triangleCount;
+    // hash of the record with this field zeroed
+    uint64_t checksum;
+};
+
+uint64_t recordChecksum(const EntryRecord& record) {
+    EntryRecord blank = record;
+    blank.checksum = 0;
+
+    return Hash::compute(&blank, sizeof(blank));
+}
+
+// reads the key from an entry file name, 16 hex digits and the extension
+bool parseEntryName(const std::string& name, uint64_t& key) {
+    if (name.size() != 16 + std::strlen(entryExtension) || name.compare(16, std::string::npos, entryExtension) != 0) {
+        return false;
+    }
+    if (name.find_first_not_of("0123456789abcdef") < 16) return false;
+
+    key = std::stoull(name.substr(0, 16), nullptr, 16);
+    return true;
+}
+
+} // namespace
+
+/**
+ * Constructor for ResultCache.
+ * Creates the cache directory if needed and orders the entries already in it by their modification
+ * time, which is updated whenever an entry is used. Entries beyond maxEntries are evicted.
+ * Parameter:
+ *     directory: const std::string&, the cache directory.
+ *     maxEntries: size_t, the number of entries kept, at least 1.
+ */
+ResultCache::ResultCache(const std::string& directory, size_t maxEntries)
+    : root(directory), capacity(std::max<size_t>(1, maxEntries)), hitCount(0), missCount(0), evictionCount(0) {
+    std::error_code error;
+    std::filesystem::create_directories(root, error);
+    if (error) {
+        Log::write(LogError, "Could not create cache directory " + root);
+    }
+
+    std::vector<std::pair<std::filesystem::file_time_type, uint64_t>> found;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(root, error)) {
+        uint64_t key;
+        if (entry.is_regular_file(error) && parseEntryName(entry.path().filename().string(), key)) {
+            found.push_back(std::make_pair(entry.last_write_time(error), key));
+        }
+    }
+
+    // oldest first, so that the most recently used entry ends up at the front
+    std::sort(found.begin(), found.end());
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const auto& entry : found) {
+        markUsed(entry.second);
+    }
+    evictExcess();
+}
+
+/**
+ * Functionality: Computes the cache key of a computation on a file. The contents are hashed, not the
+ * name or modification time, so renamed or touched files still hit and edited files miss.
+ * Parameter:
+ *     fileName: const std::string&, the mesh file.
+ *     parameters: const std::string&, everything else the result depends on, e.g. the method.
+ *     key: uint64_t&, receives the key.
+ * Returns:
+ *     bool: Returns false if the file cannot be mapped.
+ */
+bool ResultCache::computeKey(const std::string& fileName, const std::string& parameters, uint64_t& key) {
+    MappedFile in;
+    if (!in.open(fileName)) return false;
+
+    uint64_t seed = Hash::compute(parameters.data(), parameters.size(), version);
+    key = Hash::compute(in.data(), in.size(), seed);
+
+    return true;
+}
+
+/**
+ * Functionality: Reads the entry of a key. A damaged entry is removed and counted as a miss.
+ * Parameter:
+ *     key: uint64_t, the key.
+ *     result: CachedResult&, receives the stored boxes and counts on a hit.
+ * Returns:
+ *     bool: Returns true on a hit.
+ */
+bool ResultCache::lookup(uint64_t key, CachedResult& result) {
+    std::string path = entryPath(key);
+    EntryRecord record;
+
+    std::ifstream in(path.c_str(), std::ios::binary);
+    bool found = in.is_open();
+    bool valid = found && in.read(reinterpret_cast<char*>(&record), sizeof(record)) &&
+                 in.peek() == std::char_traits<char>::eof() &&
+                 std::memcmp(record.magic, entryMagic, sizeof(entryMagic)) == 0 && record.version == version &&
+                 record.key == key && record.checksum == recordChecksum(record);
+    in.close();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!valid) {
+        if (found) {
+            Log::write(LogWarning, "removing damaged cache entry " + path);
+            std::remove(path.c_str());
+        }
+        forget(key);
+        missCount++;
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), error);
+    markUsed(key);
+    hitCount++;
+
+    result.axisAlignedBox.type = "Axis Aligned";
+    result.axisAlignedBox.min = Eigen::Vector3d(record.boxes[0], record.boxes[1], record.boxes[2]);
+    result.axisAlignedBox.max = Eigen::Vector3d(record.boxes[3], record.boxes[4], record.boxes[5]);
+    result.axisAlignedBox.extent = result.axisAlignedBox.max - result.axisAlignedBox.min;
+    result.orientedBox.orientedPoints.clear();
+    if (record.hasOrientedBox) {
+        result.orientedBox.type = "Oriented";
+        for (int p = 0; p < 6; p++) {
+            const double* point = record.boxes + 6 + 3 * p;
+            result.orientedBox.orientedPoints.push_back(Eigen::Vector3d(point[0], point[1], point[2]));
+        }
+    }
+    result.vertexCount = record.vertexCount;
+    result.triangleCount = record.triangleCount;
+
+    return true;
+}
+
+/**
+ * Functionality: Writes the entry of a key to a temporary file and renames it into place, then evicts
+ * the least recently used entries beyond the limit.
+ * Parameter:
+ *     key: uint64_t, the key.
+ *     result: const CachedResult&, the boxes and counts. The oriented box is stored if it has its six
+ *             oriented points.
+ * Returns:
+ *     bool: Returns false if the entry cannot be written.
+ */
+bool ResultCache::store(uint64_t key, const CachedResult& result) {
+    EntryRecord record;
+    std::memset(&record, 0, sizeof(record));
+    std::memcpy(record.magic, entryMagic, sizeof(entryMagic));
+    record.version = version;
+    record.key = key;
+    for (int i = 0; i < 3; i++) {
+        record.boxes[i] = result.axisAlignedBox.min[i];
+        record.boxes[3 + i] = result.axisAlignedBox.max[i];
+    }
+    const std::vector<Eigen::Vector3d>& points = result.orientedBox.orientedPoints;
+    record.hasOrientedBox = points.size() == 6;
+    for (size_t p = 0; p < points.size() && record.hasOrientedBox; p++) {
+        for (int i = 0; i < 3; i++) record.boxes[6 + 3 * p + i] = points[p][i];
+    }
+    record.vertexCount = result.vertexCount;
+    record.triangleCount = result.triangleCount;
+    record.checksum = recordChecksum(record);
+
+    // the temporary name is unique to the process and thread, so concurrent writers do not collide
+    std::string path = entryPath(key);
+    std::string tempName = path + "." + std::to_string(::getpid()) + "-" +
+                           std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    std::ofstream out(tempName.c_str(), std::ios::binary);
+    out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    out.close();
+
+    if (!out || std::rename(tempName.c_str(), path.c_str()) != 0) {
+        Log::write(LogError, "Could not write cache entry " + path);
+        std::remove(tempName.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    markUsed(key);
+    evictExcess();
+
+    return true;
+}
+
+/**
+ * Functionality: Removes every entry in the cache directory, including those written by other
+ * processes, and resets the counters.
+ */
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::error_code error;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(root, error)) {
+        uint64_t key;
+        if (parseEntryName(entry.path().filename().string(), key)) {
+            std::filesystem::remove(entry.path(), error);
+        }
+    }
+
+    useOrder.clear();
+    entries.clear();
+    hitCount = 0;
+    missCount = 0;
+    evictionCount = 0;
+}
+
+/**
+ * Functionality: Returns the number of entries in the index.
+ * Returns:
+ *     size_t: The number of entries.
+ */
+size_t ResultCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
+
+/**
+ * Functionality: Returns the file of an entry, its key in hex in the cache directory.
+ * Parameter:
+ *     key: uint64_t, the key.
+ * Returns:
+ *     std::string: The path.
+ */
+std::string ResultCache::entryPath(uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx%s", (unsigned long long)key, entryExtension);
+
+    return (std::filesystem::path(root) / name).string();
+}
+
+/**
+ * Functionality: Moves a key to the front of the use order, adding it if it is not indexed yet.
+ * Parameter:
+ *     key: uint64_t, the key.
+ */
+void ResultCache::markUsed(uint64_t key) {
+    auto it = entries.find(key);
+    if (it != entries.end()) {
+        useOrder.splice(useOrder.begin(), useOrder, it->second);
+    } else {
+        useOrder.push_front(key);
+        entries[key] = useOrder.begin();
+    }
+}
+
+/**
+ * Functionality: Drops a key from the index if it is there.
+ * Parameter:
+ *     key: uint64_t, the key.
+ */
+void ResultCache::forget(uint64_t key) {
+    auto it = entries.find(key);
+    if (it == entries.end()) return;
+
+    useOrder.erase(it->second);
+    entries.erase(it);
+}
+
+/**
+ * Functionality: Removes the entries at the back of the use order until there are at most capacity.
+ */
+void ResultCache::evictExcess() {
+    while (entries.size() > capacity) {
+        uint64_t key = useOrder.back();
+        forget(key);
+        std::remove(entryPath(key).c_str());
+        evictionCount++;
+    }
+}
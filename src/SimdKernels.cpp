@@ -0,0 +1,951 @@
+#include "SimdKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SIMD_KERNELS_X86 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+typedef void (*MinMaxKernel)(const double*, const double*, const double*, size_t, double*, double*);
+typedef void (*SumKernel)(const double*, const double*, const double*, size_t, double*);
+typedef void (*ScatterKernel)(const double*, const double*, const double*, size_t, const double*, double*);
+typedef void (*ProjectKernel)(const double*, const double*, const double*, size_t,
+                              const double*, const double*, double*, double*);
+typedef void (*ExtremalKernel)(const double*, const double*, const double*, size_t, int, size_t, size_t*, size_t*);
+typedef void (*SurfaceKernel)(const double*, const double*, const double*, const uint32_t*, size_t,
+                              const double*, double*);
+typedef void (*BoxKernel)(const double*, const double* const*, size_t, uint8_t*);
+typedef void (*BoxPairKernel)(const double* const*, const double* const*, const uint32_t*, size_t, uint8_t*);
+
+// keeps near parallel edges from producing a cross product axis that separates by rounding alone
+const double boxEpsilon = 1e-12;
+
+// scalar kernels, also used for the tails of the vector kernels
+
+void minMaxScalar(const double* x, const double* y, const double* z, size_t n, double* min, double* max)
+{
+    for (size_t i = 0; i < n; i++) {
+        min[0] = std::min(min[0], x[i]); max[0] = std::max(max[0], x[i]);
+        min[1] = std::min(min[1], y[i]); max[1] = std::max(max[1], y[i]);
+        min[2] = std::min(min[2], z[i]); max[2] = std::max(max[2], z[i]);
+    }
+}
+
+void sumScalar(const double* x, const double* y, const double* z, size_t n, double* sum)
+{
+    for (size_t i = 0; i < n; i++) {
+        sum[0] += x[i];
+        sum[1] += y[i];
+        sum[2] += z[i];
+    }
+}
+
+void scatterScalar(const double* x, const double* y, const double* z, size_t n,
+                   const double* c, double* s)
+{
+    for (size_t i = 0; i < n; i++) {
+        double dx = x[i] - c[0], dy = y[i] - c[1], dz = z[i] - c[2];
+        s[0] += dx*dx; s[1] += dx*dy; s[2] += dx*dz;
+        s[3] += dy*dy; s[4] += dy*dz; s[5] += dz*dz;
+    }
+}
+
+void projectMinMaxScalar(const double* x, const double* y, const double* z, size_t n,
+                         const double* c, const double* a, double* min, double* max)
+{
+    for (size_t i = 0; i < n; i++) {
+        double dx = x[i] - c[0], dy = y[i] - c[1], dz = z[i] - c[2];
+        for (int k = 0; k < 3; k++) {
+            double d = a[3*k]*dx + a[3*k+1]*dy + a[3*k+2]*dz;
+            min[k] = std::min(min[k], d);
+            max[k] = std::max(max[k], d);
+        }
+    }
+}
+
+// the area of a triangle, its centroid m and corners p, q, r contribute area * m to the first moment
+// and area / 12 * (9 m m^T + p p^T + q q^T + r r^T) to the second moment
+void surfaceMomentsScalar(const double* x, const double* y, const double* z, const uint32_t* t, size_t count,
+                          const double* c, double* s)
+{
+    for (size_t i = 0; i < count; i++, t += 3) {
+        double px = x[t[0]] - c[0], py = y[t[0]] - c[1], pz = z[t[0]] - c[2];
+        double qx = x[t[1]] - c[0], qy = y[t[1]] - c[1], qz = z[t[1]] - c[2];
+        double rx = x[t[2]] - c[0], ry = y[t[2]] - c[1], rz = z[t[2]] - c[2];
+
+        double ux = qx - px, uy = qy - py, uz = qz - pz;
+        double vx = rx - px, vy = ry - py, vz = rz - pz;
+        double nx = uy*vz - uz*vy, ny = uz*vx - ux*vz, nz = ux*vy - uy*vx;
+        double area = 0.5 * std::sqrt(nx*nx + ny*ny + nz*nz);
+
+        double mx = (px + qx + rx) / 3, my = (py + qy + ry) / 3, mz = (pz + qz + rz) / 3;
+        double w = area / 12;
+
+        s[0] += area;
+        s[1] += area*mx; s[2] += area*my; s[3] += area*mz;
+        s[4] += w*(9*mx*mx + px*px + qx*qx + rx*rx);
+        s[5] += w*(9*mx*my + px*py + qx*qy + rx*ry);
+        s[6] += w*(9*mx*mz + px*pz + qx*qz + rx*rz);
+        s[7] += w*(9*my*my + py*py + qy*qy + ry*ry);
+        s[8] += w*(9*my*mz + py*pz + qy*qz + ry*rz);
+        s[9] += w*(9*mz*mz + pz*pz + qz*qz + rz*rz);
+    }
+}
+
+// projection of a point on DiTO direction k: the coordinate axes, the cube diagonals (1, 1, 1), (1, 1, -1),
+// (1, -1, 1), (1, -1, -1), then the face diagonals (1, 1, 0), (1, -1, 0), (1, 0, 1), (1, 0, -1), (0, 1, 1),
+// (0, 1, -1); only additions, in the same order as the vector kernels, so both find the same points
+inline double ditoProjection(int k, double x, double y, double z)
+{
+    switch (k) {
+    case 0: return x;
+    case 1: return y;
+    case 2: return z;
+    case 3: return (x + y) + z;
+    case 4: return (x + y) - z;
+    case 5: return (x - y) + z;
+    case 6: return (x - y) - z;
+    case 7: return x + y;
+    case 8: return x - y;
+    case 9: return x + z;
+    case 10: return x - z;
+    case 11: return y + z;
+    default: return y - z;
+    }
+}
+
+// updates the extremal points of direction k with the points begin to end, ties keep the earlier point
+inline void extremalRangeScalar(const double* x, const double* y, const double* z, size_t begin, size_t end, int k,
+                                double& lo, double& hi, size_t& minIndex, size_t& maxIndex)
+{
+    for (size_t i = begin; i < end; i++) {
+        double p = ditoProjection(k, x[i], y[i], z[i]);
+        if (p < lo) { lo = p; minIndex = i; }
+        if (p > hi) { hi = p; maxIndex = i; }
+    }
+}
+
+void extremalIndicesScalar(const double* x, const double* y, const double* z, size_t n, int count, size_t step,
+                           size_t* minIndex, size_t* maxIndex)
+{
+    for (int k = 0; k < count; k++) {
+        double lo = INFINITY, hi = -INFINITY;
+        for (size_t g = 0; g + 8 <= n; g += 8 * step) extremalRangeScalar(x, y, z, g, g + 8, k, lo, hi, minIndex[k], maxIndex[k]);
+        extremalRangeScalar(x, y, z, n & ~(size_t)7, n, k, lo, hi, minIndex[k], maxIndex[k]);
+    }
+}
+
+// separating axis test of two packed boxes over the 3 axes of each and their 9 cross products
+bool boxOverlapScalar(const double* a, const double* b)
+{
+    const double* ea = a + 12;
+    const double* eb = b + 12;
+    double d[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+
+    // b's axes and center in the frame of a
+    double r[3][3], absR[3][3], t[3];
+    for (int i = 0; i < 3; i++) {
+        const double* ai = a + 3 + 3*i;
+        t[i] = ai[0]*d[0] + ai[1]*d[1] + ai[2]*d[2];
+        for (int j = 0; j < 3; j++) {
+            const double* bj = b + 3 + 3*j;
+            r[i][j] = ai[0]*bj[0] + ai[1]*bj[1] + ai[2]*bj[2];
+            absR[i][j] = std::abs(r[i][j]) + boxEpsilon;
+        }
+    }
+
+    for (int i = 0; i < 3; i++) {
+        if (std::abs(t[i]) > ea[i] + eb[0]*absR[i][0] + eb[1]*absR[i][1] + eb[2]*absR[i][2]) return false;
+    }
+    for (int j = 0; j < 3; j++) {
+        double tj = t[0]*r[0][j] + t[1]*r[1][j] + t[2]*r[2][j];
+        if (std::abs(tj) > ea[0]*absR[0][j] + ea[1]*absR[1][j] + ea[2]*absR[2][j] + eb[j]) return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; j++) {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            double ra = ea[i1]*absR[i2][j] + ea[i2]*absR[i1][j];
+            double rb = eb[j1]*absR[i][j2] + eb[j2]*absR[i][j1];
+            if (std::abs(t[i2]*r[i1][j] - t[i1]*r[i2][j]) > ra + rb) return false;
+        }
+    }
+
+    return true;
+}
+
+void boxOverlapsScalar(const double* box, const double* const* boxes, size_t n, uint8_t* result)
+{
+    double b[15];
+    for (size_t i = 0; i < n; i++) {
+        for (int k = 0; k < 15; k++) b[k] = boxes[k][i];
+        result[i] = boxOverlapScalar(box, b);
+    }
+}
+
+void boxPairOverlapsScalar(const double* const* a, const double* const* b, const uint32_t* pairs, size_t n,
+                           uint8_t* result)
+{
+    double p[15], q[15];
+    for (size_t i = 0; i < n; i++) {
+        for (int k = 0; k < 15; k++) {
+            p[k] = a[k][pairs[2*i]];
+            q[k] = b[k][pairs[2*i + 1]];
+        }
+        result[i] = boxOverlapScalar(p, q);
+    }
+}
+
+#ifdef SIMD_KERNELS_X86
+
+// SSE2 kernels, part of the x86-64 baseline
+
+inline double hmin(__m128d v) { return std::min(_mm_cvtsd_f64(v), _mm_cvtsd_f64(_mm_unpackhi_pd(v, v))); }
+inline double hmax(__m128d v) { return std::max(_mm_cvtsd_f64(v), _mm_cvtsd_f64(_mm_unpackhi_pd(v, v))); }
+inline double hsum(__m128d v) { return _mm_cvtsd_f64(v) + _mm_cvtsd_f64(_mm_unpackhi_pd(v, v)); }
+
+void minMaxSse2(const double* x, const double* y, const double* z, size_t n, double* min, double* max)
+{
+    __m128d mnx = _mm_set1_pd(min[0]), mny = _mm_set1_pd(min[1]), mnz = _mm_set1_pd(min[2]);
+    __m128d mxx = _mm_set1_pd(max[0]), mxy = _mm_set1_pd(max[1]), mxz = _mm_set1_pd(max[2]);
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d vx = _mm_loadu_pd(x + i), vy = _mm_loadu_pd(y + i), vz = _mm_loadu_pd(z + i);
+        mnx = _mm_min_pd(mnx, vx); mxx = _mm_max_pd(mxx, vx);
+        mny = _mm_min_pd(mny, vy); mxy = _mm_max_pd(mxy, vy);
+        mnz = _mm_min_pd(mnz, vz); mxz = _mm_max_pd(mxz, vz);
+    }
+
+    min[0] = hmin(mnx); min[1] = hmin(mny); min[2] = hmin(mnz);
+    max[0] = hmax(mxx); max[1] = hmax(mxy); max[2] = hmax(mxz);
+    minMaxScalar(x + i, y + i, z + i, n - i, min, max);
+}
+
+void sumSse2(const double* x, const double* y, const double* z, size_t n, double* sum)
+{
+    __m128d sx = _mm_setzero_pd(), sy = _mm_setzero_pd(), sz = _mm_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        sx = _mm_add_pd(sx, _mm_loadu_pd(x + i));
+        sy = _mm_add_pd(sy, _mm_loadu_pd(y + i));
+        sz = _mm_add_pd(sz, _mm_loadu_pd(z + i));
+    }
+
+    sum[0] += hsum(sx); sum[1] += hsum(sy); sum[2] += hsum(sz);
+    sumScalar(x + i, y + i, z + i, n - i, sum);
+}
+
+void scatterSse2(const double* x, const double* y, const double* z, size_t n,
+                 const double* c, double* s)
+{
+    __m128d cx = _mm_set1_pd(c[0]), cy = _mm_set1_pd(c[1]), cz = _mm_set1_pd(c[2]);
+    __m128d sxx = _mm_setzero_pd(), sxy = _mm_setzero_pd(), sxz = _mm_setzero_pd();
+    __m128d syy = _mm_setzero_pd(), syz = _mm_setzero_pd(), szz = _mm_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + i), cx);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + i), cy);
+        __m128d dz = _mm_sub_pd(_mm_loadu_pd(z + i), cz);
+        sxx = _mm_add_pd(sxx, _mm_mul_pd(dx, dx));
+        sxy = _mm_add_pd(sxy, _mm_mul_pd(dx, dy));
+        sxz = _mm_add_pd(sxz, _mm_mul_pd(dx, dz));
+        syy = _mm_add_pd(syy, _mm_mul_pd(dy, dy));
+        syz = _mm_add_pd(syz, _mm_mul_pd(dy, dz));
+        szz = _mm_add_pd(szz, _mm_mul_pd(dz, dz));
+    }
+
+    s[0] += hsum(sxx); s[1] += hsum(sxy); s[2] += hsum(sxz);
+    s[3] += hsum(syy); s[4] += hsum(syz); s[5] += hsum(szz);
+    scatterScalar(x + i, y + i, z + i, n - i, c, s);
+}
+
+void projectMinMaxSse2(const double* x, const double* y, const double* z, size_t n,
+                       const double* c, const double* a, double* min, double* max)
+{
+    __m128d cx = _mm_set1_pd(c[0]), cy = _mm_set1_pd(c[1]), cz = _mm_set1_pd(c[2]);
+    __m128d ax[3], ay[3], az[3], mn[3], mx[3];
+    for (int k = 0; k < 3; k++) {
+        ax[k] = _mm_set1_pd(a[3*k]); ay[k] = _mm_set1_pd(a[3*k+1]); az[k] = _mm_set1_pd(a[3*k+2]);
+        mn[k] = _mm_set1_pd(min[k]); mx[k] = _mm_set1_pd(max[k]);
+    }
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d dx = _mm_sub_pd(_mm_loadu_pd(x + i), cx);
+        __m128d dy = _mm_sub_pd(_mm_loadu_pd(y + i), cy);
+        __m128d dz = _mm_sub_pd(_mm_loadu_pd(z + i), cz);
+        for (int k = 0; k < 3; k++) {
+            __m128d d = _mm_add_pd(_mm_add_pd(_mm_mul_pd(ax[k], dx), _mm_mul_pd(ay[k], dy)), _mm_mul_pd(az[k], dz));
+            mn[k] = _mm_min_pd(mn[k], d);
+            mx[k] = _mm_max_pd(mx[k], d);
+        }
+    }
+
+    for (int k = 0; k < 3; k++) {
+        min[k] = hmin(mn[k]);
+        max[k] = hmax(mx[k]);
+    }
+    projectMinMaxScalar(x + i, y + i, z + i, n - i, c, a, min, max);
+}
+
+// AVX2 kernels, compiled for avx2 regardless of the build flags and only called when the cpu supports it.
+// The scalar tails they hand over to are compiled without VEX encoding, and gcc does not clear the upper
+// register halves before calling them, so the kernels do it themselves: the state transition otherwise
+// costs a few hundred cycles per call, more than a short input takes
+
+#define AVX2_TARGET __attribute__((target("avx2")))
+
+AVX2_TARGET inline __m128d foldMin(__m256d v) { return _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)); }
+AVX2_TARGET inline __m128d foldMax(__m256d v) { return _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)); }
+AVX2_TARGET inline __m128d foldAdd(__m256d v) { return _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1)); }
+
+AVX2_TARGET void minMaxAvx2(const double* x, const double* y, const double* z, size_t n, double* min, double* max)
+{
+    __m256d mnx = _mm256_set1_pd(min[0]), mny = _mm256_set1_pd(min[1]), mnz = _mm256_set1_pd(min[2]);
+    __m256d mxx = _mm256_set1_pd(max[0]), mxy = _mm256_set1_pd(max[1]), mxz = _mm256_set1_pd(max[2]);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d vx = _mm256_loadu_pd(x + i), vy = _mm256_loadu_pd(y + i), vz = _mm256_loadu_pd(z + i);
+        mnx = _mm256_min_pd(mnx, vx); mxx = _mm256_max_pd(mxx, vx);
+        mny = _mm256_min_pd(mny, vy); mxy = _mm256_max_pd(mxy, vy);
+        mnz = _mm256_min_pd(mnz, vz); mxz = _mm256_max_pd(mxz, vz);
+    }
+
+    min[0] = hmin(foldMin(mnx)); min[1] = hmin(foldMin(mny)); min[2] = hmin(foldMin(mnz));
+    max[0] = hmax(foldMax(mxx)); max[1] = hmax(foldMax(mxy)); max[2] = hmax(foldMax(mxz));
+    _mm256_zeroupper();
+    minMaxScalar(x + i, y + i, z + i, n - i, min, max);
+}
+
+AVX2_TARGET void sumAvx2(const double* x, const double* y, const double* z, size_t n, double* sum)
+{
+    __m256d sx = _mm256_setzero_pd(), sy = _mm256_setzero_pd(), sz = _mm256_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        sx = _mm256_add_pd(sx, _mm256_loadu_pd(x + i));
+        sy = _mm256_add_pd(sy, _mm256_loadu_pd(y + i));
+        sz = _mm256_add_pd(sz, _mm256_loadu_pd(z + i));
+    }
+
+    sum[0] += hsum(foldAdd(sx)); sum[1] += hsum(foldAdd(sy)); sum[2] += hsum(foldAdd(sz));
+    _mm256_zeroupper();
+    sumScalar(x + i, y + i, z + i, n - i, sum);
+}
+
+AVX2_TARGET void scatterAvx2(const double* x, const double* y, const double* z, size_t n,
+                             const double* c, double* s)
+{
+    __m256d cx = _mm256_set1_pd(c[0]), cy = _mm256_set1_pd(c[1]), cz = _mm256_set1_pd(c[2]);
+    __m256d sxx = _mm256_setzero_pd(), sxy = _mm256_setzero_pd(), sxz = _mm256_setzero_pd();
+    __m256d syy = _mm256_setzero_pd(), syz = _mm256_setzero_pd(), szz = _mm256_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i), cx);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i), cy);
+        __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + i), cz);
+        sxx = _mm256_add_pd(sxx, _mm256_mul_pd(dx, dx));
+        sxy = _mm256_add_pd(sxy, _mm256_mul_pd(dx, dy));
+        sxz = _mm256_add_pd(sxz, _mm256_mul_pd(dx, dz));
+        syy = _mm256_add_pd(syy, _mm256_mul_pd(dy, dy));
+        syz = _mm256_add_pd(syz, _mm256_mul_pd(dy, dz));
+        szz = _mm256_add_pd(szz, _mm256_mul_pd(dz, dz));
+    }
+
+    s[0] += hsum(foldAdd(sxx)); s[1] += hsum(foldAdd(sxy)); s[2] += hsum(foldAdd(sxz));
+    s[3] += hsum(foldAdd(syy)); s[4] += hsum(foldAdd(syz)); s[5] += hsum(foldAdd(szz));
+    _mm256_zeroupper();
+    scatterScalar(x + i, y + i, z + i, n - i, c, s);
+}
+
+AVX2_TARGET void projectMinMaxAvx2(const double* x, const double* y, const double* z, size_t n,
+                                   const double* c, const double* a, double* min, double* max)
+{
+    __m256d cx = _mm256_set1_pd(c[0]), cy = _mm256_set1_pd(c[1]), cz = _mm256_set1_pd(c[2]);
+    __m256d ax[3], ay[3], az[3], mn[3], mx[3];
+    for (int k = 0; k < 3; k++) {
+        ax[k] = _mm256_set1_pd(a[3*k]); ay[k] = _mm256_set1_pd(a[3*k+1]); az[k] = _mm256_set1_pd(a[3*k+2]);
+        mn[k] = _mm256_set1_pd(min[k]); mx[k] = _mm256_set1_pd(max[k]);
+    }
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(x + i), cx);
+        __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(y + i), cy);
+        __m256d dz = _mm256_sub_pd(_mm256_loadu_pd(z + i), cz);
+        for (int k = 0; k < 3; k++) {
+            __m256d d = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ax[k], dx), _mm256_mul_pd(ay[k], dy)),
+                                      _mm256_mul_pd(az[k], dz));
+            mn[k] = _mm256_min_pd(mn[k], d);
+            mx[k] = _mm256_max_pd(mx[k], d);
+        }
+    }
+
+    for (int k = 0; k < 3; k++) {
+        min[k] = hmin(foldMin(mn[k]));
+        max[k] = hmax(foldMax(mx[k]));
+    }
+    _mm256_zeroupper();
+    projectMinMaxScalar(x + i, y + i, z + i, n - i, c, a, min, max);
+}
+
+// gathers with an explicit zero source and full mask, which keeps gcc's uninitialized warnings quiet
+AVX2_TARGET inline __m128i gatherIndices(const int* base, __m128i stride)
+{
+    return _mm_mask_i32gather_epi32(_mm_setzero_si128(), base, stride, _mm_set1_epi32(-1), 4);
+}
+
+AVX2_TARGET inline __m256d gather(const double* base, __m128i index)
+{
+    return _mm256_mask_i32gather_pd(_mm256_setzero_pd(), base, index, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)), 8);
+}
+
+AVX2_TARGET void surfaceMomentsAvx2(const double* x, const double* y, const double* z, const uint32_t* t,
+                                    size_t count, const double* c, double* s)
+{
+    const __m128i stride = _mm_setr_epi32(0, 3, 6, 9);
+    const __m256d third = _mm256_set1_pd(1.0 / 3), half = _mm256_set1_pd(0.5);
+    const __m256d twelfth = _mm256_set1_pd(1.0 / 12), nine = _mm256_set1_pd(9);
+    __m256d cx = _mm256_set1_pd(c[0]), cy = _mm256_set1_pd(c[1]), cz = _mm256_set1_pd(c[2]);
+    __m256d acc[10];
+    for (int k = 0; k < 10; k++) acc[k] = _mm256_setzero_pd();
+
+    // four triangles at a time, their corners are gathered from the coordinate arrays
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const int* corners = (const int*)(t + 3*i);
+        __m128i a = gatherIndices(corners, stride);
+        __m128i b = gatherIndices(corners + 1, stride);
+        __m128i d = gatherIndices(corners + 2, stride);
+
+        __m256d px = _mm256_sub_pd(gather(x, a), cx);
+        __m256d py = _mm256_sub_pd(gather(y, a), cy);
+        __m256d pz = _mm256_sub_pd(gather(z, a), cz);
+        __m256d qx = _mm256_sub_pd(gather(x, b), cx);
+        __m256d qy = _mm256_sub_pd(gather(y, b), cy);
+        __m256d qz = _mm256_sub_pd(gather(z, b), cz);
+        __m256d rx = _mm256_sub_pd(gather(x, d), cx);
+        __m256d ry = _mm256_sub_pd(gather(y, d), cy);
+        __m256d rz = _mm256_sub_pd(gather(z, d), cz);
+
+        __m256d ux = _mm256_sub_pd(qx, px), uy = _mm256_sub_pd(qy, py), uz = _mm256_sub_pd(qz, pz);
+        __m256d vx = _mm256_sub_pd(rx, px), vy = _mm256_sub_pd(ry, py), vz = _mm256_sub_pd(rz, pz);
+        __m256d nx = _mm256_sub_pd(_mm256_mul_pd(uy, vz), _mm256_mul_pd(uz, vy));
+        __m256d ny = _mm256_sub_pd(_mm256_mul_pd(uz, vx), _mm256_mul_pd(ux, vz));
+        __m256d nz = _mm256_sub_pd(_mm256_mul_pd(ux, vy), _mm256_mul_pd(uy, vx));
+        __m256d area = _mm256_mul_pd(half, _mm256_sqrt_pd(_mm256_add_pd(_mm256_add_pd(
+            _mm256_mul_pd(nx, nx), _mm256_mul_pd(ny, ny)), _mm256_mul_pd(nz, nz))));
+
+        __m256d mx = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(px, qx), rx), third);
+        __m256d my = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(py, qy), ry), third);
+        __m256d mz = _mm256_mul_pd(_mm256_add_pd(_mm256_add_pd(pz, qz), rz), third);
+        __m256d w = _mm256_mul_pd(area, twelfth);
+
+        acc[0] = _mm256_add_pd(acc[0], area);
+        acc[1] = _mm256_add_pd(acc[1], _mm256_mul_pd(area, mx));
+        acc[2] = _mm256_add_pd(acc[2], _mm256_mul_pd(area, my));
+        acc[3] = _mm256_add_pd(acc[3], _mm256_mul_pd(area, mz));
+
+        __m256d m[3] = {mx, my, mz}, p[3] = {px, py, pz}, q[3] = {qx, qy, qz}, r[3] = {rx, ry, rz};
+        int k = 4;
+        for (int j = 0; j < 3; j++) {
+            for (int l = j; l < 3; l++, k++) {
+                __m256d sum = _mm256_mul_pd(nine, _mm256_mul_pd(m[j], m[l]));
+                sum = _mm256_add_pd(sum, _mm256_mul_pd(p[j], p[l]));
+                sum = _mm256_add_pd(sum, _mm256_mul_pd(q[j], q[l]));
+                sum = _mm256_add_pd(sum, _mm256_mul_pd(r[j], r[l]));
+                acc[k] = _mm256_add_pd(acc[k], _mm256_mul_pd(w, sum));
+            }
+        }
+    }
+
+    for (int k = 0; k < 10; k++) {
+        s[k] += hsum(foldAdd(acc[k]));
+    }
+    _mm256_zeroupper();
+    surfaceMomentsScalar(x, y, z, t + 3*i, count - i, c, s);
+}
+
+// groups of eight points in one chunk of the extremal point search, small enough to stay in the L1 cache
+// while every group of directions reads it; the search keeps the chunk of each extremum and finds its
+// index there
+const size_t extremalChunkGroups = 16;
+
+AVX2_TARGET inline __m256d ditoProjection4(int k, __m256d x, __m256d y, __m256d z)
+{
+    switch (k) {
+    case 0: return x;
+    case 1: return y;
+    case 2: return z;
+    case 3: return _mm256_add_pd(_mm256_add_pd(x, y), z);
+    case 4: return _mm256_sub_pd(_mm256_add_pd(x, y), z);
+    case 5: return _mm256_add_pd(_mm256_sub_pd(x, y), z);
+    case 6: return _mm256_sub_pd(_mm256_sub_pd(x, y), z);
+    case 7: return _mm256_add_pd(x, y);
+    case 8: return _mm256_sub_pd(x, y);
+    case 9: return _mm256_add_pd(x, z);
+    case 10: return _mm256_sub_pd(x, z);
+    case 11: return _mm256_add_pd(y, z);
+    default: return _mm256_sub_pd(y, z);
+    }
+}
+
+// projections of four points on the coordinate axes, the cube diagonals and the face diagonals, in groups
+// small enough to keep their running minima and maxima in registers
+struct AxisProjections {
+    static const int count = 3;
+    AVX2_TARGET void operator()(__m256d x, __m256d y, __m256d z, __m256d* p) const { p[0] = x; p[1] = y; p[2] = z; }
+};
+
+struct CubeDiagonalProjections {
+    static const int count = 4;
+    AVX2_TARGET void operator()(__m256d x, __m256d y, __m256d z, __m256d* p) const {
+        __m256d s = _mm256_add_pd(x, y), t = _mm256_sub_pd(x, y);
+        p[0] = _mm256_add_pd(s, z); p[1] = _mm256_sub_pd(s, z);
+        p[2] = _mm256_add_pd(t, z); p[3] = _mm256_sub_pd(t, z);
+    }
+};
+
+struct FaceDiagonalProjections {
+    static const int count = 3;
+    AVX2_TARGET void operator()(__m256d x, __m256d y, __m256d z, __m256d* p) const {
+        p[0] = _mm256_add_pd(x, y); p[1] = _mm256_sub_pd(x, y); p[2] = _mm256_add_pd(x, z);
+    }
+};
+
+struct OtherFaceDiagonalProjections {
+    static const int count = 3;
+    AVX2_TARGET void operator()(__m256d x, __m256d y, __m256d z, __m256d* p) const {
+        p[0] = _mm256_sub_pd(x, z); p[1] = _mm256_add_pd(y, z); p[2] = _mm256_sub_pd(y, z);
+    }
+};
+
+// first pass over the groups of eight points from begin to end, step groups apart, for one group of
+// directions: only the least and greatest projections. Unroll sets of running values hide the latency of
+// small groups. Each lane of lo and hi keeps its extremum over all chunks so far and loChunk and hiChunk
+// the chunk it was first reached in: a later chunk only replaces a strictly better value, so ties keep
+// the lowest index
+template <typename Projections, int Unroll>
+AVX2_TARGET inline void extremalChunkAvx2(const double* x, const double* y, const double* z, size_t begin, size_t end,
+                                          size_t step, __m256d* lo, __m256d* hi, __m256d* loChunk, __m256d* hiChunk)
+{
+    const int D = Projections::count;
+    __m256d mn[Unroll][D], mx[Unroll][D], p[D];
+    for (int u = 0; u < Unroll; u++) {
+        for (int k = 0; k < D; k++) {
+            mn[u][k] = _mm256_set1_pd(INFINITY);
+            mx[u][k] = _mm256_set1_pd(-INFINITY);
+        }
+    }
+
+    for (size_t i = begin; i < end; i += 8 * step) {
+        for (int h = 0; h < 2; h++) {
+            const int u = h % Unroll;
+            Projections()(_mm256_loadu_pd(x + i + 4*h), _mm256_loadu_pd(y + i + 4*h), _mm256_loadu_pd(z + i + 4*h), p);
+            for (int k = 0; k < D; k++) {
+                mn[u][k] = _mm256_min_pd(mn[u][k], p[k]);
+                mx[u][k] = _mm256_max_pd(mx[u][k], p[k]);
+            }
+        }
+    }
+
+    const __m256d chunk = _mm256_set1_pd((double)begin);
+    for (int k = 0; k < D; k++) {
+        for (int u = 1; u < Unroll; u++) {
+            mn[0][k] = _mm256_min_pd(mn[0][k], mn[u][k]);
+            mx[0][k] = _mm256_max_pd(mx[0][k], mx[u][k]);
+        }
+        __m256d less = _mm256_cmp_pd(mn[0][k], lo[k], _CMP_LT_OQ);
+        __m256d greater = _mm256_cmp_pd(mx[0][k], hi[k], _CMP_GT_OQ);
+        lo[k] = _mm256_blendv_pd(lo[k], mn[0][k], less);
+        hi[k] = _mm256_blendv_pd(hi[k], mx[0][k], greater);
+        loChunk[k] = _mm256_blendv_pd(loChunk[k], chunk, less);
+        hiChunk[k] = _mm256_blendv_pd(hiChunk[k], chunk, greater);
+    }
+}
+
+// the first chunk whose lane reached value, the extremum over the lanes of extremum
+AVX2_TARGET inline size_t extremalChunk(__m256d extremum, __m256d chunk, double value)
+{
+    __m256d reached = _mm256_cmp_pd(extremum, _mm256_set1_pd(value), _CMP_EQ_OQ);
+    return (size_t)hmin(foldMin(_mm256_blendv_pd(_mm256_set1_pd(INFINITY), chunk, reached)));
+}
+
+// second pass: the first point in the groups of eight from begin to end, step groups apart, whose
+// projection on direction k is value
+AVX2_TARGET size_t firstProjectionAvx2(const double* x, const double* y, const double* z, size_t begin, size_t end,
+                                       size_t step, int k, double value)
+{
+    __m256d v = _mm256_set1_pd(value);
+    for (size_t i = begin; i < end; i += 8 * step) {
+        for (size_t j = i; j < i + 8; j += 4) {
+            __m256d p = ditoProjection4(k, _mm256_loadu_pd(x + j), _mm256_loadu_pd(y + j), _mm256_loadu_pd(z + j));
+            int mask = _mm256_movemask_pd(_mm256_cmp_pd(p, v, _CMP_EQ_OQ));
+            if (mask) return j + __builtin_ctz(mask);
+        }
+    }
+    return begin;
+}
+
+AVX2_TARGET void extremalIndicesAvx2(const double* x, const double* y, const double* z, size_t n, int count,
+                                     size_t step, size_t* minIndex, size_t* maxIndex)
+{
+    __m256d lo[13], hi[13], loChunk[13], hiChunk[13];
+    for (int k = 0; k < 13; k++) {
+        lo[k] = _mm256_set1_pd(INFINITY);
+        hi[k] = _mm256_set1_pd(-INFINITY);
+        loChunk[k] = hiChunk[k] = _mm256_setzero_pd();
+    }
+
+    // the groups that start in [begin, end) and fit in n
+    size_t m = n < 8 ? 0 : n - 7, span = 8 * step * extremalChunkGroups;
+    for (size_t begin = 0; begin < m; begin += span) {
+        size_t end = std::min(m, begin + span);
+        extremalChunkAvx2<AxisProjections, 2>(x, y, z, begin, end, step, lo, hi, loChunk, hiChunk);
+        if (count > 3) {
+            extremalChunkAvx2<CubeDiagonalProjections, 1>(x, y, z, begin, end, step, lo + 3, hi + 3,
+                                                          loChunk + 3, hiChunk + 3);
+        }
+        if (count > 7) {
+            extremalChunkAvx2<FaceDiagonalProjections, 1>(x, y, z, begin, end, step, lo + 7, hi + 7,
+                                                          loChunk + 7, hiChunk + 7);
+            extremalChunkAvx2<OtherFaceDiagonalProjections, 1>(x, y, z, begin, end, step, lo + 10, hi + 10,
+                                                               loChunk + 10, hiChunk + 10);
+        }
+    }
+
+    double least[13], greatest[13];
+    for (int k = 0; k < count; k++) {
+        least[k] = hmin(foldMin(lo[k]));
+        greatest[k] = hmax(foldMax(hi[k]));
+        if (m > 0) {
+            size_t first = extremalChunk(lo[k], loChunk[k], least[k]);
+            minIndex[k] = firstProjectionAvx2(x, y, z, first, std::min(m, first + span), step, k, least[k]);
+            first = extremalChunk(hi[k], hiChunk[k], greatest[k]);
+            maxIndex[k] = firstProjectionAvx2(x, y, z, first, std::min(m, first + span), step, k, greatest[k]);
+        }
+    }
+
+    _mm256_zeroupper();
+    for (int k = 0; k < count; k++) {
+        extremalRangeScalar(x, y, z, n & ~(size_t)7, n, k, least[k], greatest[k], minIndex[k], maxIndex[k]);
+    }
+}
+
+// separating axis test of four box pairs, one pair per lane, returns the lane mask of the pairs that
+// overlap; the 9 cross product axes are skipped once every pair is separated by a face axis
+AVX2_TARGET inline int boxOverlap4(const __m256d* a, const __m256d* b)
+{
+    const __m256d sign = _mm256_set1_pd(-0.0), epsilon = _mm256_set1_pd(boxEpsilon);
+    const __m256d* ea = a + 12;
+    const __m256d* eb = b + 12;
+    __m256d d[3] = {_mm256_sub_pd(b[0], a[0]), _mm256_sub_pd(b[1], a[1]), _mm256_sub_pd(b[2], a[2])};
+
+    __m256d r[3][3], absR[3][3], t[3];
+    for (int i = 0; i < 3; i++) {
+        const __m256d* ai = a + 3 + 3*i;
+        t[i] = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ai[0], d[0]), _mm256_mul_pd(ai[1], d[1])),
+                             _mm256_mul_pd(ai[2], d[2]));
+        for (int j = 0; j < 3; j++) {
+            const __m256d* bj = b + 3 + 3*j;
+            r[i][j] = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ai[0], bj[0]), _mm256_mul_pd(ai[1], bj[1])),
+                                    _mm256_mul_pd(ai[2], bj[2]));
+            absR[i][j] = _mm256_add_pd(_mm256_andnot_pd(sign, r[i][j]), epsilon);
+        }
+    }
+
+    __m256d separated = _mm256_setzero_pd();
+    for (int i = 0; i < 3; i++) {
+        __m256d rb = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(eb[0], absR[i][0]), _mm256_mul_pd(eb[1], absR[i][1])),
+                                   _mm256_mul_pd(eb[2], absR[i][2]));
+        __m256d test = _mm256_cmp_pd(_mm256_andnot_pd(sign, t[i]), _mm256_add_pd(ea[i], rb), _CMP_GT_OQ);
+        separated = _mm256_or_pd(separated, test);
+    }
+    for (int j = 0; j < 3; j++) {
+        __m256d tj = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(t[0], r[0][j]), _mm256_mul_pd(t[1], r[1][j])),
+                                   _mm256_mul_pd(t[2], r[2][j]));
+        __m256d ra = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(ea[0], absR[0][j]), _mm256_mul_pd(ea[1], absR[1][j])),
+                                   _mm256_mul_pd(ea[2], absR[2][j]));
+        __m256d test = _mm256_cmp_pd(_mm256_andnot_pd(sign, tj), _mm256_add_pd(ra, eb[j]), _CMP_GT_OQ);
+        separated = _mm256_or_pd(separated, test);
+    }
+    if (_mm256_movemask_pd(separated) == 0xf) return 0;
+
+    for (int i = 0; i < 3; i++) {
+        int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j = 0; j < 3; j++) {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            __m256d ra = _mm256_add_pd(_mm256_mul_pd(ea[i1], absR[i2][j]), _mm256_mul_pd(ea[i2], absR[i1][j]));
+            __m256d rb = _mm256_add_pd(_mm256_mul_pd(eb[j1], absR[i][j2]), _mm256_mul_pd(eb[j2], absR[i][j1]));
+            __m256d dist = _mm256_sub_pd(_mm256_mul_pd(t[i2], r[i1][j]), _mm256_mul_pd(t[i1], r[i2][j]));
+            __m256d test = _mm256_cmp_pd(_mm256_andnot_pd(sign, dist), _mm256_add_pd(ra, rb), _CMP_GT_OQ);
+            separated = _mm256_or_pd(separated, test);
+        }
+    }
+
+    return ~_mm256_movemask_pd(separated) & 0xf;
+}
+
+AVX2_TARGET void boxOverlapsAvx2(const double* box, const double* const* boxes, size_t n, uint8_t* result)
+{
+    __m256d a[15], b[15];
+    for (int k = 0; k < 15; k++) a[k] = _mm256_broadcast_sd(box + k);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (int k = 0; k < 15; k++) b[k] = _mm256_loadu_pd(boxes[k] + i);
+
+        int mask = boxOverlap4(a, b);
+        for (int l = 0; l < 4; l++) result[i + l] = (mask >> l) & 1;
+    }
+
+    const double* tail[15];
+    for (int k = 0; k < 15; k++) tail[k] = boxes[k] + i;
+    _mm256_zeroupper();
+    boxOverlapsScalar(box, tail, n - i, result + i);
+}
+
+AVX2_TARGET void boxPairOverlapsAvx2(const double* const* a, const double* const* b, const uint32_t* pairs, size_t n,
+                                     uint8_t* result)
+{
+    const __m128i stride = _mm_setr_epi32(0, 2, 4, 6);
+    __m256d p[15], q[15];
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i first = gatherIndices((const int*)pairs + 2*i, stride);
+        __m128i second = gatherIndices((const int*)pairs + 2*i + 1, stride);
+        for (int k = 0; k < 15; k++) {
+            p[k] = gather(a[k], first);
+            q[k] = gather(b[k], second);
+        }
+
+        int mask = boxOverlap4(p, q);
+        for (int l = 0; l < 4; l++) result[i + l] = (mask >> l) & 1;
+    }
+
+    _mm256_zeroupper();
+    boxPairOverlapsScalar(a, b, pairs + 2*i, n - i, result + i);
+}
+
+#endif // SIMD_KERNELS_X86
+
+// kernels in use
+struct KernelTable {
+    std::string name;
+    MinMaxKernel minMax;
+    SumKernel sum;
+    ScatterKernel scatter;
+    ProjectKernel projectMinMax;
+    SurfaceKernel surfaceMoments;
+    ExtremalKernel extremalIndices;
+    BoxKernel boxOverlaps;
+    BoxPairKernel boxPairOverlaps;
+};
+
+const KernelTable scalarKernels = {"scalar", minMaxScalar, sumScalar, scatterScalar, projectMinMaxScalar,
+                                   surfaceMomentsScalar, extremalIndicesScalar, boxOverlapsScalar,
+                                   boxPairOverlapsScalar};
+#ifdef SIMD_KERNELS_X86
+// SSE2 has no gathers or blends and two lanes do not pay off for the box tests, these use the scalar kernels
+const KernelTable sse2Kernels = {"sse2", minMaxSse2, sumSse2, scatterSse2, projectMinMaxSse2, surfaceMomentsScalar,
+                                 extremalIndicesScalar, boxOverlapsScalar, boxPairOverlapsScalar};
+const KernelTable avx2Kernels = {"avx2", minMaxAvx2, sumAvx2, scatterAvx2, projectMinMaxAvx2, surfaceMomentsAvx2,
+                                 extremalIndicesAvx2, boxOverlapsAvx2, boxPairOverlapsAvx2};
+#endif
+
+bool supported(const std::string& name)
+{
+    if (name == "scalar") return true;
+#ifdef SIMD_KERNELS_X86
+    if (name == "sse2") return true;
+    if (name == "avx2") return __builtin_cpu_supports("avx2");
+#endif
+    return false;
+}
+
+const KernelTable* kernelsFor(const std::string& name)
+{
+#ifdef SIMD_KERNELS_X86
+    if (name == "avx2") return &avx2Kernels;
+    if (name == "sse2") return &sse2Kernels;
+#endif
+    return &scalarKernels;
+}
+
+const KernelTable*& activeKernels()
+{
+    static const KernelTable* kernels = kernelsFor(supported("avx2") ? "avx2" : supported("sse2") ? "sse2" : "scalar");
+
+    return kernels;
+}
+
+} // namespace
+
+/**
+ * Functionality: Computes the per-axis minimum and maximum of a set of points.
+ * Parameter:
+ *     x, y, z: const double*, the coordinates of the points.
+ *     n: size_t, the number of points.
+ *     min, max: double[3], receive the minimum and maximum, +/-infinity if n is 0.
+ */
+void SimdKernels::minMax(const double* x, const double* y, const double* z, size_t n,
+                         double min[3], double max[3]) {
+    for (int k = 0; k < 3; k++) {
+        min[k] = INFINITY;
+        max[k] = -INFINITY;
+    }
+
+    activeKernels()->minMax(x, y, z, n, min, max);
+}
+
+/**
+ * Functionality: Computes the per-axis sum of a set of points.
+ * Parameter:
+ *     x, y, z: const double*, the coordinates of the points.
+ *     n: size_t, the number of points.
+ *     sum: double[3], receives the sum.
+ */
+void SimdKernels::sum(const double* x, const double* y, const double* z, size_t n, double sum[3]) {
+    sum[0] = sum[1] = sum[2] = 0.0;
+
+    activeKernels()->sum(x, y, z, n, sum);
+}
+
+/**
+ * Functionality: Computes the scatter matrix sum((p - center)(p - center)^T) of a set of points.
+ * Parameter:
+ *     x, y, z: const double*, the coordinates of the points.
+ *     n: size_t, the number of points.
+ *     center: const double[3], the point the scatter is taken about.
+ *     scatter: double[6], receives the upper triangle xx, xy, xz, yy, yz, zz.
+ */
+void SimdKernels::scatter(const double* x, const double* y, const double* z, size_t n,
+                          const double center[3], double scatter[6]) {
+    std::fill(scatter, scatter + 6, 0.0);
+
+    activeKernels()->scatter(x, y, z, n, center, scatter);
+}
+
+/**
+ * Functionality: Projects a set of points relative to center on three axes and computes the range
+ * of the projections.
+ * Parameter:
+ *     x, y, z: const double*, the coordinates of the points.
+ *     n: size_t, the number of points.
+ *     center: const double[3], the origin of the projection.
+ *     axes: const double[9], the three axes stored one after another.
+ *     min, max: double[3], receive the range along each axis, +/-infinity if n is 0.
+ */
+void SimdKernels::projectMinMax(const double* x, const double* y, const double* z, size_t n,
+                                const double center[3], const double axes[9], double min[3], double max[3]) {
+    for (int k = 0; k < 3; k++) {
+        min[k] = INFINITY;
+        max[k] = -INFINITY;
+    }
+
+    activeKernels()->projectMinMax(x, y, z, n, center, axes, min, max);
+}
+
+/**
+ * Functionality: Integrates the area and the first and second moments over a set of triangles,
+ * treating each triangle as a uniform surface density.
+ * Parameter:
+ *     x, y, z: const double*, the coordinates of the points.
+ *     triangles: const uint32_t*, three point indices per triangle.
+ *     count: size_t, the number of triangles.
+ *     reference: const double[3], the moments are taken about this point.
+ *     moments: double[10], receives the total area, the first moments x, y, z and the upper triangle
+ *              xx, xy, xz, yy, yz, zz of the second moments.
+ */
+void SimdKernels::surfaceMoments(const double* x, const double* y, const double* z, const uint32_t* triangles,
+                                 size_t count, const double reference[3], double moments[10]) {
+    std::fill(moments, moments + 10, 0.0);
+
+    activeKernels()->surfaceMoments(x, y, z, triangles, count, reference, moments);
+}
+
+/**
+ * Functionality: Finds the extremal points of a set of points along the DiTO directions: the coordinate
+ * axes, the cube diagonals (1, 1, 1), (1, 1, -1), (1, -1, 1), (1, -1, -1), then the face diagonals
+ * (1, 1, 0), (1, -1, 0), (1, 0, 1), (1, 0, -1), (0, 1, 1), (0, 1, -1). The directions are not normalized,
+ * so the projections take additions only. The vector kernel keeps only the running extremes of each lane
+ * in a first pass, with the chunk of 16 groups that reached them, and finds their indices in a second
+ * pass over that chunk.
+ * Parameter:
+ *     x, y, z: const double*, the coordinates of the points.
+ *     n: size_t, the number of points, at least 1.
+ *     count: int, the number of leading directions to search, 3, 7 or 13.
+ *     step: size_t, reads the group of eight points at every step groups, and the last n % 8 points;
+ *           1 reads every point. Every kernel reads the same points.
+ *     minIndex, maxIndex: size_t*, receive for each direction the first point read with the least and
+ *                         the greatest projection.
+ */
+void SimdKernels::extremalIndices(const double* x, const double* y, const double* z, size_t n,
+                                  int count, size_t step, size_t* minIndex, size_t* maxIndex) {
+    std::fill(minIndex, minIndex + count, 0);
+    std::fill(maxIndex, maxIndex + count, 0);
+
+    activeKernels()->extremalIndices(x, y, z, n, count, std::max<size_t>(step, 1), minIndex, maxIndex);
+}
+
+/**
+ * Functionality: Tests one box against a set of boxes with the separating axis test. Touching boxes
+ * overlap.
+ * Parameter:
+ *     box: const double[15], the box packed as center, the three unit axes and the half extents.
+ *     boxes: const double* const[15], one array per packed value of the other boxes.
+ *     n: size_t, the number of other boxes.
+ *     result: uint8_t*, receives 1 for each box that overlaps box and 0 otherwise.
+ */
+void SimdKernels::boxOverlaps(const double box[15], const double* const boxes[15], size_t n, uint8_t* result) {
+    activeKernels()->boxOverlaps(box, boxes, n, result);
+}
+
+/**
+ * Functionality: Tests pairs of boxes from two sets with the separating axis test.
+ * Parameter:
+ *     a, b: const double* const[15], one array per packed value of each set.
+ *     pairs: const uint32_t*, an index into a followed by an index into b for each pair.
+ *     n: size_t, the number of pairs.
+ *     result: uint8_t*, receives 1 for each pair that overlaps and 0 otherwise.
+ */
+void SimdKernels::boxPairOverlaps(const double* const a[15], const double* const b[15], const uint32_t* pairs,
+                                  size_t n, uint8_t* result) {
+    activeKernels()->boxPairOverlaps(a, b, pairs, n, result);
+}
+
+/**
+ * Functionality: Reports the instruction set used by the kernels.
+ * Returns:
+ *     std::string: "avx2", "sse2" or "scalar".
+ */
+std::string SimdKernels::instructionSet() {
+    return activeKernels()->name;
+}
+
+/**
+ * Functionality: Selects the instruction set used by the kernels, e.g. to compare them in benchmarks.
+ * Parameter:
+ *     name: const std::string&, "avx2", "sse2" or "scalar".
+ * Returns:
+ *     bool: Returns true if the instruction set is supported and now in use, false otherwise.
+ */
+bool SimdKernels::setInstructionSet(const std::string& name) {
+    if (!supported(name)) {
+        return false;
+    }
+
+    activeKernels() = kernelsFor(name);
+
+    return true;
+}
@@ -0,0 +1,187 @@
+#include "StreamingBounds.h"
+
+#include "BoundingBox.h"
+#include "Diagnostics.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "PointReduction.h"
+#include "ThreadPool.h"
+
+namespace {
+
+// what the first pass learns about the positions of one chunk
+struct ChunkSummary {
+    PointMoments moments;
+    Eigen::Vector3d min = Eigen::Vector3d::Constant(std::numeric_limits<double>::infinity());
+    Eigen::Vector3d max = Eigen::Vector3d::Constant(-std::numeric_limits<double>::infinity());
+};
+
+// what the second pass learns about the positions of one chunk relative to the center of mass
+struct ChunkExtent {
+    double radius = 0;
+    Eigen::Vector3d min = Eigen::Vector3d::Constant(std::numeric_limits<double>::infinity());
+    Eigen::Vector3d max = Eigen::Vector3d::Constant(-std::numeric_limits<double>::infinity());
+};
+
+// splits a buffer into chunks of about chunkSize bytes at record starts
+std::vector<const char*> chunkBounds(const char* begin, const char* end) {
+    std::vector<const char*> bounds(1, begin);
+    for (const char* p = begin + StreamingBounds::chunkSize; p < end; p += StreamingBounds::chunkSize) {
+        const char* start = ObjParser::nextRecordStart(p, begin, end);
+        if (start > bounds.back() && start < end) bounds.push_back(start);
+    }
+    bounds.push_back(end);
+
+    return bounds;
+}
+
+// runs visit on every block of positions in [begin, end), reusing one buffer
+template <typename Visit>
+void forEachBlock(const char* begin, const char* end, PositionBuffer& block, Visit visit) {
+    const char* p = begin;
+    while (p < end) {
+        block.clear();
+        p = ObjParser::parsePositions(p, end, block, StreamingBounds::blockSize);
+        if (!block.empty()) visit(block);
+    }
+}
+
+} // namespace
+
+/**
+ * Functionality: Streams the positions of an obj file twice. The first pass accumulates the count, mean,
+ * scatter matrix and range, the second the radius about the mean and, for the oriented box, the range
+ * along the principal axes. Chunks are scanned in parallel and combined in file order.
+ * Parameter:
+ *     fileName: const std::string&, the obj file.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ *     axisAlignedBox: BoundingBox*, receives the axis-aligned box if not null.
+ *     orientedBox: BoundingBox*, receives the oriented box if not null.
+ * Returns:
+ *     bool: Returns false if the file cannot be opened or has no positions.
+ */
+bool StreamingBounds::streamBoxes(const std::string& fileName, int threads, BoundingBox* axisAlignedBox,
+                                  BoundingBox* orientedBox) {
+    MappedFile in;
+    if (!in.open(fileName)) {
+        Log::write(LogError, "Could not open " + fileName + " for reading");
+        return false;
+    }
+
+    threads = ThreadPool::resolveThreadCount(threads);
+    std::vector<const char*> bounds = chunkBounds(in.data(), in.data() + in.size());
+    size_t chunks = bounds.size() - 1;
+
+    std::vector<ChunkSummary> summaries(chunks);
+    ThreadPool::global().parallelFor(chunks, [&](size_t c) {
+        PositionBuffer block;
+        forEachBlock(bounds[c], bounds[c + 1], block, [&](const PositionBuffer& positions) {
+            Eigen::Vector3d min, max;
+            PointReduction::minMax(PositionBufferSource(positions), min, max, 1);
+            summaries[c].min = summaries[c].min.cwiseMin(min);
+            summaries[c].max = summaries[c].max.cwiseMax(max);
+            summaries[c].moments.merge(PointReduction::moments(PositionBufferSource(positions), 1));
+        });
+    }, threads);
+
+    ChunkSummary total;
+    for (const ChunkSummary& summary : summaries) {
+        total.moments.merge(summary.moments);
+        total.min = total.min.cwiseMin(summary.min);
+        total.max = total.max.cwiseMax(summary.max);
+    }
+    if (total.moments.count == 0) {
+        Log::write(LogError, fileName + " has no vertex positions");
+        return false;
+    }
+
+    // the principal axes do not change when the points are scaled, so they are found before the scale is known
+    const Eigen::Vector3d& center = total.moments.mean;
+    Eigen::Matrix3d axes = Eigen::Matrix3d::Identity();
+    if (orientedBox) {
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigenSolver(total.moments.covariance());
+        axes = eigenSolver.eigenvectors();
+    }
+
+    std::vector<ChunkExtent> extents(chunks);
+    ThreadPool::global().parallelFor(chunks, [&](size_t c) {
+        PositionBuffer block;
+        forEachBlock(bounds[c], bounds[c + 1], block, [&](const PositionBuffer& positions) {
+            for (size_t i = 0; i < positions.size(); i++) {
+                extents[c].radius = std::max(extents[c].radius, (positions.get(i) - center).norm());
+            }
+            if (orientedBox) {
+                Eigen::Vector3d min, max;
+                PointReduction::projectMinMax(PositionBufferSource(positions), center, axes, min, max, 1);
+                extents[c].min = extents[c].min.cwiseMin(min);
+                extents[c].max = extents[c].max.cwiseMax(max);
+            }
+        });
+    }, threads);
+
+    ChunkExtent extent;
+    for (const ChunkExtent& e : extents) {
+        extent.radius = std::max(extent.radius, e.radius);
+        extent.min = extent.min.cwiseMin(e.min);
+        extent.max = extent.max.cwiseMax(e.max);
+    }
+
+    // move the center of mass to the origin and scale to the unit sphere, as Mesh::normalize does
+    double scale = extent.radius > 0 ? 1.0 / extent.radius : 1.0;
+    if (axisAlignedBox) {
+        axisAlignedBox->type = "Axis Aligned";
+        axisAlignedBox->min = (total.min - center) * scale;
+        axisAlignedBox->max = (total.max - center) * scale;
+        axisAlignedBox->extent = axisAlignedBox->max - axisAlignedBox->min;
+    }
+    if (orientedBox) {
+        orientedBox->type = "Oriented";
+        orientedBox->setOrientedBox(Eigen::Vector3d::Zero(), axes, extent.min * scale, extent.max * scale);
+    }
+
+    return true;
+}
+
+/**
+ * Functionality: Computes the axis-aligned box of the positions of an obj file without loading the mesh.
+ * Memory use is a block buffer per thread, whatever the size of the file.
+ * Parameter:
+ *     fileName: const std::string&, the obj file.
+ *     box: BoundingBox&, receives the box of the positions normalized to the unit sphere.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Returns:
+ *     bool: Returns false if the file cannot be opened or has no positions.
+ */
+bool StreamingBounds::computeAxisAlignedBox(const std::string& fileName, BoundingBox& box, int threads) {
+    return streamBoxes(fileName, threads, &box, nullptr);
+}
+
+/**
+ * Functionality: Computes the principal component box of the positions of an obj file without loading
+ * the mesh.
+ * Parameter:
+ *     fileName: const std::string&, the obj file.
+ *     box: BoundingBox&, receives the box of the positions normalized to the unit sphere.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Returns:
+ *     bool: Returns false if the file cannot be opened or has no positions.
+ */
+bool StreamingBounds::computeOrientedBox(const std::string& fileName, BoundingBox& box, int threads) {
+    return streamBoxes(fileName, threads, nullptr, &box);
+}
+
+/**
+ * Functionality: Computes the axis-aligned and principal component boxes of the positions of an obj
+ * file in the same two passes.
+ * Parameter:
+ *     fileName: const std::string&, the obj file.
+ *     axisAlignedBox: BoundingBox&, receives the axis-aligned box.
+ *     orientedBox: BoundingBox&, receives the oriented box.
+ *     threads: int, the number of threads to use, 0 for all hardware threads.
+ * Returns:
+ *     bool: Returns false if the file cannot be opened or has no positions.
+ */
+bool StreamingBounds::computeBoxes(const std::string& fileName, BoundingBox& axisAlignedBox, BoundingBox& orientedBox,
+                                   int threads) {
+    return streamBoxes(fileName, threads, &axisAlignedBox, &orientedBox);
+}
@@ -0,0 +1,155 @@
+#include "ThreadPool.h"
+
+#include <atomic>
+#include <exception>
+
+/**
+ * Functionality: Constructor for ThreadPool, starts the worker threads.
+ * Parameter:
+ *     numThreads: int, the number of workers, 0 uses the hardware concurrency.
+ */
+ThreadPool::ThreadPool(int numThreads) : stopping(false) {
+    numThreads = resolveThreadCount(numThreads);
+
+    for (int i = 0; i < numThreads; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+/**
+ * Destructor for ThreadPool.
+ * Lets the workers drain the queue and joins them.
+ */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    condition.notify_all();
+
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Functionality: Runs body(i) for every i in [0, n). Indices are handed out dynamically and the
+ * calling thread works through them as well, so nested calls from inside a task cannot deadlock.
+ * If body throws, the indices not yet started are skipped and the first exception is rethrown on the
+ * calling thread once every thread has left body.
+ * Parameter:
+ *     n: size_t, the number of iterations.
+ *     body: const std::function<void(size_t)>&, the loop body.
+ *     maxThreads: int, the maximum number of threads including the caller, 0 for no limit.
+ */
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& body, int maxThreads) {
+    if (n == 0) return;
+
+    int threads = maxThreads > 0 ? std::min(maxThreads, size() + 1) : size() + 1;
+    int helpers = (int)std::min<size_t>(n, threads) - 1;
+    if (helpers <= 0) {
+        for (size_t i = 0; i < n; i++) body(i);
+        return;
+    }
+
+    struct State {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::atomic<bool> failed{false};
+        std::exception_ptr error;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    std::shared_ptr<State> state = std::make_shared<State>();
+    const std::function<void(size_t)>* work = &body;
+
+    // helpers that start after every index is claimed return without touching body, indices claimed
+    // after a failure are counted without running body
+    std::function<void()> run = [state, work, n]() {
+        size_t i;
+        while ((i = state->next.fetch_add(1)) < n) {
+            if (!state->failed.load(std::memory_order_relaxed)) {
+                try {
+                    (*work)(i);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(state->mutex);
+                    if (!state->error) state->error = std::current_exception();
+                    state->failed = true;
+                }
+            }
+            if (state->done.fetch_add(1) + 1 == n) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                state->finished.notify_all();
+            }
+        }
+    };
+
+    for (int i = 0; i < helpers; i++) {
+        enqueue(run);
+    }
+    run();
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->finished.wait(lock, [&state, n]() { return state->done.load() == n; });
+        // a late helper may still hold the state, the exception is released here on the caller
+        std::swap(error, state->error);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+/**
+ * Functionality: Resolves a requested thread count.
+ * Parameter:
+ *     threads: int, the requested number of threads, 0 or less for all hardware threads.
+ * Returns:
+ *     int: The number of threads to use, at least 1.
+ */
+int ThreadPool::resolveThreadCount(int threads) {
+    if (threads > 0) return threads;
+
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+/**
+ * Functionality: Returns the pool shared by the library, created on first use.
+ * Returns:
+ *     ThreadPool&: A pool with one worker per hardware thread.
+ */
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool;
+
+    return pool;
+}
+
+/**
+ * Functionality: Adds a task to the queue and wakes a worker.
+ * Parameter:
+ *     task: std::function<void()>, the task to run.
+ */
+void ThreadPool::enqueue(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    condition.notify_one();
+}
+
+/**
+ * Functionality: Worker thread loop, runs tasks until the pool is stopping and the queue is empty.
+ */
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) return;
+
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
@@ -1,14 +1,11 @@
 #include "Vertex.h"
-#include "HalfEdge.h"
-
-std::vector<HalfEdge> isolated;
 
 /**
- * Functionality: Checks if the vertex is a boundary vertex.
+ * Functionality: Checks if the vertex is isolated.
  * Returns:
- *     bool: Returns true if the vertex is a boundary vertex, false otherwise.
+ *     bool: Returns true if the vertex is not contained in any face, false otherwise.
  */
 bool Vertex::isIsolated() const
 {
-    return he == isolated.begin();
+    return he == InvalidId;
 }
\ No newline at end of file
@@ -4,10 +4,17 @@
 #include <GL/glut.h>
 #endif
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
+#include <fstream>
+#include <memory>
 
+#include "BatchProcessor.h"
 #include "BoundingBox.h"
+#include "Diagnostics.h"
 #include "Mesh.h"
+#include "ResultCache.h"
 
 int gridX = 600;
 int gridY = 600;
@@ -23,13 +30,74 @@ double z = -2.5;
 Mesh mesh;
 bool success = true;
 bool drawAABB = true;
+OrientedBoxMethod obbMethod = PrincipalComponents;
 BoundingBox boundingBox;
 
 std::vector<std::string> paths;
 
+void computeOrientedBox() {
+    boundingBox.computeOrientedBox(mesh.positions, mesh.triangles, obbMethod);
+}
+
+void printUsage() {
+    std::cerr << "Usage: ./bounding-box [options] <path to mesh (.obj) file or folder>...\n"
+              << "  --batch             compute the boxes of every mesh without opening a window\n"
+              << "  --threads N         meshes processed at once in batch mode, 0 for all cores (default)\n"
+              << "  --format jsonl|csv  batch output format (default jsonl)\n"
+              << "  --output FILE       write the batch output to FILE instead of stdout\n"
+              << "  --method NAME       oriented box method: pca (default), hull-pca, min-volume, surface-pca,\n"
+              << "                      hull-surface-pca, dito-14, dito-26\n"
+              << "  --recursive         also read the meshes in subfolders\n"
+              << "  --cache DIR         in batch mode, reuse the boxes of unchanged files stored in DIR\n"
+              << "  --cache-entries N   entries kept in the cache, least recently used first out (default 10000)\n"
+              << "  --log-level LEVEL   print messages at LEVEL and above: debug, info, warning, error, off (default)\n"
+              << std::endl;
+}
+
+// adds an .obj file, or the .obj files in a folder
+template <typename DirectoryIterator>
+void addPaths(const std::filesystem::path& p) {
+    if (std::filesystem::is_directory(p)) {
+        for (const auto& entry : DirectoryIterator(p)) {
+            if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+                paths.push_back(entry.path());
+            }
+        }
+    } else if (std::filesystem::is_regular_file(p) && p.extension() == ".obj") {
+        paths.push_back(p);
+    }
+}
+
+// computes the boxes of all meshes and writes them to the output, returns the exit code
+int runBatch(const BatchOptions& options, const std::string& output) {
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file) {
+            std::cerr << "Error: Could not open " << output << " for writing" << std::endl;
+            return 1;
+        }
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t failures = BatchProcessor::run(paths, options, output.empty() ? std::cout : file);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cerr << "Processed " << paths.size() << " meshes (" << failures << " failed) in " << seconds << " s, "
+              << paths.size() / seconds << " meshes/s" << std::endl;
+    if (options.cache) {
+        std::cerr << "Cache " << options.cache->directory() << ": " << options.cache->hits() << " hits, "
+                  << options.cache->misses() << " misses, " << options.cache->evictions() << " evictions"
+                  << std::endl;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
 void printInstructions() {
     std::cerr << "space: toggle between meshes\n"
-              << "b: toggle between axis aligned and oriented bounding box"
+              << "b: toggle between axis aligned and oriented bounding box\n"
+              << "m: cycle oriented bounding box method (pca, hull pca, minimum volume, surface pca, hull surface pca, dito-14, dito-26)\n"
               << "↑/↓: move in/out\n"
               << "w/s: move up/down\n"
               << "a/d: move left/right\n"
@@ -79,14 +147,15 @@ void drawBox(const Eigen::Vector3d& b1, const Eigen::Vector3d& b2, const Eigen::
 void drawFaces() {
     glColor4f(0.0, 0.0, 1.0, 0.6);
     for (FaceCIter f = mesh.faces.begin(); f != mesh.faces.end(); f++) {
-        if (f->isBoundary()) continue;
+        if (f->isBoundary(mesh)) continue;
 
         glBegin(GL_LINE_LOOP);
-        HalfEdgeCIter he = f->he;
+        HalfEdgeId he = f->he;
         do {
-            glVertex3d(he->vertex->position.x(), he->vertex->position.y(), he->vertex->position.z());
+            const Eigen::Vector3d& p = mesh.vertices[mesh.halfEdges[he].vertex].position;
+            glVertex3d(p.x(), p.y(), p.z());
 
-            he = he->next;
+            he = mesh.halfEdges[he].next;
 
         } while (he != f->he);
 
@@ -130,14 +199,25 @@ void display() {
         } else {
             std::vector<Eigen::Vector3d> orientedPoints = boundingBox.orientedPoints;
 
-            Eigen::Vector3d b1 = orientedPoints[0] + orientedPoints[2] + orientedPoints[4];
-            Eigen::Vector3d b2 = orientedPoints[1] + orientedPoints[2] + orientedPoints[4];
-            Eigen::Vector3d b3 = orientedPoints[1] + orientedPoints[2] + orientedPoints[5];
-            Eigen::Vector3d b4 = orientedPoints[0] + orientedPoints[2] + orientedPoints[5];
-            Eigen::Vector3d b5 = orientedPoints[0] + orientedPoints[3] + orientedPoints[4];
-            Eigen::Vector3d b6 = orientedPoints[1] + orientedPoints[3] + orientedPoints[4];
-            Eigen::Vector3d b8 = orientedPoints[0] + orientedPoints[3] + orientedPoints[5];
-            Eigen::Vector3d b7 = orientedPoints[1] + orientedPoints[3] + orientedPoints[5];
+            // box axes and the range of the box along each of them, independent of the box center
+            Eigen::Vector3d axes[3];
+            Eigen::Vector2d range[3];
+            for (int i = 0; i < 3; i++) {
+                axes[i] = (orientedPoints[2 * i + 1] - orientedPoints[2 * i]).normalized();
+                range[i] = Eigen::Vector2d(axes[i].dot(orientedPoints[2 * i]), axes[i].dot(orientedPoints[2 * i + 1]));
+            }
+            auto corner = [&](int i, int j, int k) {
+                return axes[0] * range[0][i] + axes[1] * range[1][j] + axes[2] * range[2][k];
+            };
+
+            Eigen::Vector3d b1 = corner(0, 0, 0);
+            Eigen::Vector3d b2 = corner(1, 0, 0);
+            Eigen::Vector3d b3 = corner(1, 0, 1);
+            Eigen::Vector3d b4 = corner(0, 0, 1);
+            Eigen::Vector3d b5 = corner(0, 1, 0);
+            Eigen::Vector3d b6 = corner(1, 1, 0);
+            Eigen::Vector3d b8 = corner(0, 1, 1);
+            Eigen::Vector3d b7 = corner(1, 1, 1);
 
             drawBox(b1, b2, b3, b4, b5, b6, b7, b8);
         }
@@ -156,21 +236,26 @@ void keyboard(unsigned char key, int x0, int y0) {
             if (i == 2) i = 0;
             mesh.read(paths[i]);
             if (drawAABB)
-                boundingBox.computeAxisAlignedBox(mesh.vertices);
+                boundingBox.computeAxisAlignedBox(mesh.positions);
             else
-                boundingBox.computeOrientedBox(mesh.vertices);
+                computeOrientedBox();
             break;
         case 'b':
         case 'B':
             drawAABB = !drawAABB;
             if (drawAABB) {
-                boundingBox.computeAxisAlignedBox(mesh.vertices);
+                boundingBox.computeAxisAlignedBox(mesh.positions);
                 glutSetWindowTitle("Bounding Box - Axis Aligned");
             } else {
-                boundingBox.computeOrientedBox(mesh.vertices);
+                computeOrientedBox();
                 glutSetWindowTitle("Bounding Box - Oriented");
             }
             break;
+        case 'm':
+        case 'M':
+            obbMethod = (OrientedBoxMethod)((obbMethod + 1) % 7);
+            if (!drawAABB) computeOrientedBox();
+            break;
         case 'a':
         case 'A':
             x += 0.03;
@@ -206,29 +291,74 @@ void special(int i, int x0, int y0) {
 }
 
 int main(int argc, char** argv) {
+    bool batch = false;
+    bool recursive = false;
+    BatchOptions options;
+    std::string output;
+    std::string cacheDirectory;
+    size_t cacheEntries = 10000;
+    std::vector<std::string> inputs;
+    LogLevel logLevel = LogOff;
+
     for (int i = 1; i < argc; ++i) {
-        std::filesystem::path p(argv[i]);
-
-        if (std::filesystem::is_directory(p)) {
-            // If it is a folder, read all .obj files
-            for (const auto& entry : std::filesystem::directory_iterator(p)) {
-                if (entry.path().extension() == ".obj") {
-                    paths.push_back(entry.path());
-                }
-            }
-        } else if (std::filesystem::is_regular_file(p) && p.extension() == ".obj") {
-            // If it is an .obj file, read it directly
-            paths.push_back(p);
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--batch") {
+            batch = true;
+        } else if (arg == "--recursive") {
+            recursive = true;
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::max(0, atoi(argv[++i]));
+        } else if (arg == "--format" && hasValue && (std::string(argv[i + 1]) == "jsonl" || std::string(argv[i + 1]) == "csv")) {
+            options.format = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            output = argv[++i];
+        } else if (arg == "--cache" && hasValue) {
+            cacheDirectory = argv[++i];
+        } else if (arg == "--cache-entries" && hasValue && atoi(argv[i + 1]) > 0) {
+            cacheEntries = atoi(argv[++i]);
+        } else if (arg == "--method" && hasValue && BatchProcessor::parseMethod(argv[i + 1], options.method)) {
+            i++;
+        } else if (arg == "--log-level" && hasValue && Log::parseLevel(argv[i + 1], logLevel)) {
+            i++;
+        } else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Error: invalid option " << arg << std::endl;
+            printUsage();
+            return 1;
+        } else {
+            inputs.push_back(arg);
         }
     }
 
+    Log::setLevel(logLevel);
+
+    for (const std::string& input : inputs) {
+        if (recursive) addPaths<std::filesystem::recursive_directory_iterator>(input);
+        else addPaths<std::filesystem::directory_iterator>(input);
+    }
+
     if (paths.size() == 0) {
-        std::cerr << "Usage: ./bounding-box <path to mesh (.obj) file or folder>" << std::endl;
+        printUsage();
         return 1;
     }
 
+    if (batch) {
+        // folders are listed in no particular order, sort so that runs are repeatable
+        std::sort(paths.begin(), paths.end());
+
+        std::unique_ptr<ResultCache> cache;
+        if (!cacheDirectory.empty()) {
+            cache.reset(new ResultCache(cacheDirectory, cacheEntries));
+            options.cache = cache.get();
+        }
+        return runBatch(options, output);
+    }
+
+    obbMethod = options.method;
+
     success = mesh.read(paths[0]);
-    if (success) boundingBox.computeAxisAlignedBox(mesh.vertices);
+    if (success) boundingBox.computeAxisAlignedBox(mesh.positions);
 
     printInstructions();
     glutInitWindowSize(gridX, gridY);
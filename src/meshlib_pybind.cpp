@@ -1,28 +1,494 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/eigen.h>
+#include <pybind11/numpy.h>
 #include "Mesh.h"
 #include "BoundingBox.h"
+#include "ConvexHull.h"
+#include "Diagnostics.h"
+#include "OBBTree.h"
+#include "BVH.h"
+#include "BoxOverlap.h"
+#include "StreamingBounds.h"
+#include "MeshCache.h"
+#include "MeshValidator.h"
+#include "ResultCache.h"
+#include "PointReduction.h"
+#include "Profiler.h"
+#include "ThreadPool.h"
 #include "Vertex.h"
 #include "Face.h"
 #include "HalfEdge.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <type_traits>
+#include <unordered_map>
+
 namespace py = pybind11;
 
+// raised when the surface PCA is asked for on points without triangles
+const char* surfaceMethodError = "SurfacePrincipalComponents needs the triangles of a mesh";
+
+// Python view of a mesh element, refers to the element by index and keeps the owning mesh alive
+template <typename T>
+struct ElementRef {
+    std::shared_ptr<Mesh> mesh;
+    uint32_t index;
+};
+
+typedef ElementRef<Vertex> VertexRef;
+typedef ElementRef<Edge> EdgeRef;
+typedef ElementRef<Face> FaceRef;
+typedef ElementRef<HalfEdge> HalfEdgeRef;
+
+// returns the array of a mesh that holds elements of type T
+template <typename T>
+std::vector<T>& elementArray(Mesh& mesh) {
+    if constexpr (std::is_same<T, Vertex>::value) return mesh.vertices;
+    else if constexpr (std::is_same<T, Edge>::value) return mesh.edges;
+    else if constexpr (std::is_same<T, Face>::value) return mesh.faces;
+    else return mesh.halfEdges;
+}
+
+// returns the element a reference points to, raises IndexError if the mesh no longer has it, e.g. after a
+// smaller mesh was read into it
+template <typename T>
+T& element(const ElementRef<T>& ref) {
+    std::vector<T>& array = elementArray<T>(*ref.mesh);
+    if (ref.index >= array.size()) throw py::index_error("the element no longer exists in its mesh");
+
+    return array[ref.index];
+}
+
+// returns a reference to each element of a mesh array
+template <typename T>
+std::vector<ElementRef<T>> elementRefs(const std::shared_ptr<Mesh>& mesh, size_t count) {
+    std::vector<ElementRef<T>> refs(count);
+    for (size_t i = 0; i < count; i++) {
+        refs[i] = ElementRef<T>{mesh, (uint32_t)i};
+    }
+
+    return refs;
+}
+
+// binds equality and hashing so that elements can be compared while walking the mesh
+template <typename T>
+void bindElementRef(py::class_<ElementRef<T>>& cls) {
+    cls.def("__eq__", [](const ElementRef<T>& a, const ElementRef<T>& b) {
+            return a.mesh == b.mesh && a.index == b.index;
+        })
+       .def("__hash__", [](const ElementRef<T>& e) { return std::hash<uint32_t>()(e.index); })
+       .def_property_readonly("id", [](const ElementRef<T>& e) { return e.index; });
+}
+
+// Owner of the arrays that the NumPy views of a mesh read. It holds the mesh itself until the mesh is
+// read again, then the old contents of the mesh, so that views taken before the read stay valid.
+struct MeshArrays {
+    std::shared_ptr<const Mesh> mesh;
+};
+
+// owners of the arrays of the meshes that have views, by mesh
+std::unordered_map<const Mesh*, std::weak_ptr<MeshArrays>> meshArrays;
+std::mutex meshArraysMutex;
+
+// returns the owner of the current arrays of a mesh, created by the first view of them
+std::shared_ptr<MeshArrays> currentMeshArrays(const std::shared_ptr<Mesh>& mesh) {
+    std::lock_guard<std::mutex> lock(meshArraysMutex);
+    std::shared_ptr<MeshArrays> arrays = meshArrays[mesh.get()].lock();
+    if (arrays && arrays->mesh == mesh) return arrays;
+
+    // drop the owners whose views are all gone before adding one
+    for (auto it = meshArrays.begin(); it != meshArrays.end();) {
+        it = it->second.expired() ? meshArrays.erase(it) : std::next(it);
+    }
+    arrays = std::make_shared<MeshArrays>(MeshArrays{mesh});
+    meshArrays[mesh.get()] = arrays;
+
+    return arrays;
+}
+
+// Locks of the meshes, by address. The bindings that read a mesh without the GIL hold its shared lock,
+// and the bindings that change its arrays hold the exclusive lock and the GIL, so that neither the
+// readers nor the element references and views, which run with the GIL, see the arrays change. The
+// exclusive lock is always taken before the GIL.
+std::shared_mutex meshLocks[64];
+
+// returns the lock of a mesh
+std::shared_mutex& meshLock(const Mesh& mesh) {
+    return meshLocks[(reinterpret_cast<uintptr_t>(&mesh) >> 4) % 64];
+}
+
+// takes the exclusive lock of a mesh for a binding that holds the GIL, the GIL is released while waiting
+std::unique_lock<std::shared_mutex> lockMeshForWrite(const Mesh& mesh) {
+    py::gil_scoped_release release;
+    return std::unique_lock<std::shared_mutex>(meshLock(mesh));
+}
+
+// runs read(target) to replace the contents of a mesh, call without the GIL. The new contents are read into
+// a mesh of their own and swapped in under the exclusive lock and the GIL, and the old contents move to the
+// owner of the views of the mesh, if there is one.
+template <typename Read>
+bool readMesh(Mesh& mesh, Read read) {
+    std::shared_ptr<Mesh> loaded = std::make_shared<Mesh>();
+    bool success = read(*loaded);
+
+    std::unique_lock<std::shared_mutex> lock(meshLock(mesh));
+    py::gil_scoped_acquire acquire;
+    if (!success) {
+        // the mesh is left as it was, apart from the problems the failed read found
+        if (!loaded->diagnostics.empty()) mesh.diagnostics = loaded->diagnostics;
+        return false;
+    }
+    mesh.swap(*loaded);
+
+    std::lock_guard<std::mutex> arraysLock(meshArraysMutex);
+    auto it = meshArrays.find(&mesh);
+    std::shared_ptr<MeshArrays> arrays = it != meshArrays.end() ? it->second.lock() : nullptr;
+    if (arrays && arrays->mesh.get() == &mesh) arrays->mesh = loaded;
+    return true;
+}
+
+// returns a read-only NumPy array of rows x columns values of type T starting at data, with rows
+// stride bytes apart, that views the memory of a mesh; its base owns that memory, even after the mesh is
+// read again
+template <typename T>
+py::array meshView(const std::shared_ptr<Mesh>& mesh, const T* data, size_t rows, size_t columns, size_t stride) {
+    py::capsule base(new std::shared_ptr<MeshArrays>(currentMeshArrays(mesh)), [](void* arrays) {
+        delete static_cast<std::shared_ptr<MeshArrays>*>(arrays);
+    });
+    py::array_t<T> view({rows, columns}, {stride, sizeof(T)}, data, base);
+    py::detail::array_proxy(view.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
+
+    return view;
+}
+
+// gathers the positions of a list of vertices
+PositionBuffer positionBuffer(const std::vector<VertexRef>& refs) {
+    PositionBuffer positions;
+    positions.resize(refs.size());
+    for (size_t i = 0; i < refs.size(); i++) {
+        positions.set(i, element(refs[i]).position);
+    }
+
+    return positions;
+}
+
+// (N, 3) arrays of points as passed from NumPy
+typedef Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> PointArray;
+
+// copies the rows of an (N, 3) array into a position buffer
+PositionBuffer positionBuffer(const PointArray& points) {
+    PositionBuffer positions;
+    positions.resize(points.rows());
+    for (Eigen::Index i = 0; i < points.rows(); i++) {
+        positions.set(i, points.row(i).transpose());
+    }
+
+    return positions;
+}
+
+// an (N, 3) NumPy array of points and a source that reads it in place, the array keeps the memory alive
+struct PointArrayView {
+    py::array array;
+    std::shared_ptr<PointSource> source;
+};
+
+// wraps an (N, 3) array without copying it, float32 and float64 arrays are read in place with their
+// strides, anything else is converted to a float64 array first
+PointArrayView pointArrayView(py::object points) {
+    PointArrayView view;
+    view.array = py::array::ensure(points);
+    if (!view.array || view.array.ndim() != 2 || view.array.shape(1) != 3) {
+        throw py::value_error("points must be an (N, 3) array");
+    }
+
+    if (!py::isinstance<py::array_t<float>>(view.array) && !py::isinstance<py::array_t<double>>(view.array)) {
+        view.array = py::array_t<double, py::array::forcecast>::ensure(view.array);
+    }
+
+    size_t count = view.array.shape(0);
+    ptrdiff_t rowStride = view.array.strides(0), columnStride = view.array.strides(1);
+    if (py::isinstance<py::array_t<float>>(view.array)) {
+        view.source = std::make_shared<StridedPointSource<float>>(
+            static_cast<const float*>(view.array.data()), count, rowStride, columnStride);
+    } else {
+        view.source = std::make_shared<StridedPointSource<double>>(
+            static_cast<const double*>(view.array.data()), count, rowStride, columnStride);
+    }
+
+    return view;
+}
+
+// wraps every array of a list, see pointArrayView
+std::vector<PointArrayView> pointArrayViews(const std::vector<py::object>& pointsList) {
+    std::vector<PointArrayView> views;
+    views.reserve(pointsList.size());
+    for (const py::object& points : pointsList) views.push_back(pointArrayView(points));
+
+    return views;
+}
+
+// packs a list of boxes for the batched overlap tests
+OrientedBoxBuffer orientedBoxBuffer(const std::vector<OrientedBox>& boxes) {
+    OrientedBoxBuffer buffer;
+    buffer.resize(boxes.size());
+    for (size_t i = 0; i < boxes.size(); i++) buffer.set(i, boxes[i]);
+
+    return buffer;
+}
+
+// returns index pairs as a (K, 2) array
+Eigen::Matrix<uint32_t, Eigen::Dynamic, 2, Eigen::RowMajor> pairArray(
+        const std::vector<std::pair<uint32_t, uint32_t>>& pairs) {
+    Eigen::Matrix<uint32_t, Eigen::Dynamic, 2, Eigen::RowMajor> result(pairs.size(), 2);
+    for (size_t i = 0; i < pairs.size(); i++) result.row(i) << pairs[i].first, pairs[i].second;
+
+    return result;
+}
+
+// returns a triangle index as seen from Python, -1 for InvalidId
+int64_t triangleIndex(uint32_t triangle) {
+    return triangle == InvalidId ? -1 : (int64_t)triangle;
+}
+
+// Runs the work of the *_async functions on a pool of its own and hands the results to Python futures
+class AsyncRunner {
+public:
+    // returns the runner of the module, which is never destroyed so that no worker outlives its pool
+    static AsyncRunner& instance() {
+        static AsyncRunner* runner = new AsyncRunner();
+        return *runner;
+    }
+
+    // queues task and returns a concurrent.futures.Future that receives its result, or a RuntimeError with
+    // the message of the exception it throws; task runs without the GIL, call with the GIL held
+    template <typename F>
+    py::object submit(F task);
+
+    // blocks until the queued tasks are done, registered at exit so that no task needs the GIL once the
+    // interpreter shuts down
+    void wait() {
+        py::gil_scoped_release release;
+        std::unique_lock<std::mutex> lock(mutex);
+        idle.wait(lock, [this]() { return pending == 0; });
+    }
+
+private:
+    AsyncRunner() : pool(0), pending(0) {}
+
+    // marks a task as done
+    void finish() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--pending == 0) idle.notify_all();
+    }
+
+    ThreadPool pool;
+    std::mutex mutex;
+    std::condition_variable idle;
+    size_t pending;
+};
+
+template <typename F>
+py::object AsyncRunner::submit(F task) {
+    typedef typename std::invoke_result<F>::type Result;
+
+    py::object future = py::module::import("concurrent.futures").attr("Future")();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending++;
+    }
+
+    // the worker owns a reference to the future and drops it with the GIL held
+    py::object* handle = new py::object(future);
+    pool.submit([this, handle, task]() {
+        bool run;
+        {
+            py::gil_scoped_acquire acquire;
+            run = handle->attr("set_running_or_notify_cancel")().cast<bool>();
+        }
+
+        std::optional<Result> result;
+        std::string error;
+        if (run) {
+            try {
+                result = task();
+            } catch (const std::exception& e) {
+                error = e.what();
+            } catch (...) {
+                error = "unknown error";
+            }
+        }
+
+        {
+            py::gil_scoped_acquire acquire;
+            try {
+                if (run && result) {
+                    handle->attr("set_result")(py::cast(std::move(*result)));
+                } else if (run) {
+                    handle->attr("set_exception")(py::reinterpret_borrow<py::object>(PyExc_RuntimeError)(error));
+                }
+            } catch (const py::error_already_set&) {
+                // the future was resolved elsewhere, nobody waits for this result
+            }
+            delete handle;
+        }
+        finish();
+    });
+
+    return future;
+}
+
+// result cache of the file based box helpers, none until enable_result_cache is called
+std::shared_ptr<ResultCache> resultCache;
+std::mutex resultCacheMutex;
+
+// returns the enabled result cache, or null
+std::shared_ptr<ResultCache> currentResultCache() {
+    std::lock_guard<std::mutex> lock(resultCacheMutex);
+    return resultCache;
+}
+
+// streams the axis-aligned or PCA box of a file; with a result cache both boxes are streamed on a miss
+// and stored in one entry, so the other helper hits afterwards
+bool streamBox(const std::string& filename, int threads, bool oriented, BoundingBox& bbox) {
+    std::shared_ptr<ResultCache> cache = currentResultCache();
+    uint64_t key = 0;
+    if (!cache || !ResultCache::computeKey(filename, "streaming pca", key)) {
+        return oriented ? StreamingBounds::computeOrientedBox(filename, bbox, threads)
+                        : StreamingBounds::computeAxisAlignedBox(filename, bbox, threads);
+    }
+
+    CachedResult entry;
+    if (!cache->lookup(key, entry)) {
+        if (!StreamingBounds::computeBoxes(filename, entry.axisAlignedBox, entry.orientedBox, threads)) return false;
+        cache->store(key, entry);
+    }
+    bbox = oriented ? entry.orientedBox : entry.axisAlignedBox;
+
+    return true;
+}
+
 PYBIND11_MODULE(_meshlib, mod) {
     mod.doc() = "Meshlib Python Bindings";
 
-    py::class_<Mesh>(mod, "Mesh")
+    py::class_<Mesh, std::shared_ptr<Mesh>>(mod, "Mesh")
+        .def(py::init<>())
+        .def(py::init([](const Mesh& mesh) {
+            std::shared_lock<std::shared_mutex> lock(meshLock(mesh));
+            return Mesh(mesh);
+        }), py::call_guard<py::gil_scoped_release>())
+        .def("read", [](Mesh& mesh, const std::string& fileName, int threads, bool validate) {
+            return readMesh(mesh, [&](Mesh& target) { return target.read(fileName, threads, validate); });
+        }, py::arg("fileName"), py::arg("threads") = 1, py::arg("validate") = true,
+           py::call_guard<py::gil_scoped_release>())
+        .def("write", [](const Mesh& mesh, const std::string& fileName, int threads) {
+            std::shared_lock<std::shared_mutex> lock(meshLock(mesh));
+            return mesh.write(fileName, threads);
+        }, py::arg("fileName"), py::arg("threads") = 1, py::call_guard<py::gil_scoped_release>())
+        .def("writeCache", [](const Mesh& mesh, const std::string& fileName, int threads) {
+            std::shared_lock<std::shared_mutex> lock(meshLock(mesh));
+            return MeshCache::write(fileName, mesh, threads);
+        }, py::arg("fileName"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+        .def("readCache", [](Mesh& mesh, const std::string& fileName, bool verify) {
+            return readMesh(mesh, [&](Mesh& target) {
+                return MeshCache::read(fileName, target, nullptr, nullptr, verify);
+            });
+        }, py::arg("fileName"), py::arg("verify") = true, py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("halfEdges", [](std::shared_ptr<Mesh> mesh) {
+            return elementRefs<HalfEdge>(mesh, mesh->halfEdges.size());
+        })
+        .def_property_readonly("vertices", [](std::shared_ptr<Mesh> mesh) {
+            return elementRefs<Vertex>(mesh, mesh->vertices.size());
+        })
+        .def_property("uvs", [](const Mesh& mesh) { return mesh.uvs; },
+            [](Mesh& mesh, const std::vector<Eigen::Vector3d>& uvs) {
+                std::unique_lock<std::shared_mutex> lock = lockMeshForWrite(mesh);
+                mesh.uvs = uvs;
+            })
+        .def_property("normals", [](const Mesh& mesh) { return mesh.normals; },
+            [](Mesh& mesh, const std::vector<Eigen::Vector3d>& normals) {
+                std::unique_lock<std::shared_mutex> lock = lockMeshForWrite(mesh);
+                mesh.normals = normals;
+            })
+        .def_property_readonly("edges", [](std::shared_ptr<Mesh> mesh) {
+            return elementRefs<Edge>(mesh, mesh->edges.size());
+        })
+        .def_property_readonly("faces", [](std::shared_ptr<Mesh> mesh) {
+            return elementRefs<Face>(mesh, mesh->faces.size());
+        })
+        .def_property_readonly("boundaries", [](std::shared_ptr<Mesh> mesh) {
+            std::vector<HalfEdgeRef> refs;
+            for (HalfEdgeId he : mesh->boundaries) refs.push_back(HalfEdgeRef{mesh, he});
+            return refs;
+        })
+        // views of the mesh memory, which keep the contents they were taken from when the mesh is read again
+        .def_property_readonly("positions", [](std::shared_ptr<Mesh> mesh) {
+            const double* data = mesh->vertices.empty() ? nullptr : mesh->vertices[0].position.data();
+            return meshView(mesh, data, mesh->vertices.size(), 3, sizeof(Vertex));
+        })
+        .def_property_readonly("triangles", [](std::shared_ptr<Mesh> mesh) {
+            return meshView(mesh, mesh->triangles.data(), mesh->triangles.size() / 3, 3, 3 * sizeof(uint32_t));
+        })
+        .def_property_readonly("edgeVertices", [](std::shared_ptr<Mesh> mesh) {
+            if (mesh->edgeVertices.size() != 2 * mesh->edges.size()) {
+                std::unique_lock<std::shared_mutex> lock = lockMeshForWrite(*mesh);
+                if (mesh->edgeVertices.size() != 2 * mesh->edges.size()) mesh->updateEdgeBuffer();
+            }
+            return meshView(mesh, mesh->edgeVertices.data(), mesh->edges.size(), 2, 2 * sizeof(uint32_t));
+        })
+        .def_property_readonly("vertexNormals", [](std::shared_ptr<Mesh> mesh) {
+            if (mesh->vertexNormals.size() != mesh->vertices.size()) {
+                std::unique_lock<std::shared_mutex> lock = lockMeshForWrite(*mesh);
+                if (mesh->vertexNormals.size() != mesh->vertices.size()) mesh->updateVertexNormals();
+            }
+            const double* data = mesh->vertexNormals.empty() ? nullptr : mesh->vertexNormals[0].data();
+            return meshView(mesh, data, mesh->vertexNormals.size(), 3, sizeof(Eigen::Vector3d));
+        })
+        .def_readonly("diagnostics", &Mesh::diagnostics);
+
+    py::enum_<LogLevel>(mod, "LogLevel")
+        .value("Debug", LogDebug)
+        .value("Info", LogInfo)
+        .value("Warning", LogWarning)
+        .value("Error", LogError)
+        .value("Off", LogOff);
+
+    py::class_<DiagnosticEntry>(mod, "DiagnosticEntry")
+        .def_readonly("code", &DiagnosticEntry::code)
+        .def_readonly("level", &DiagnosticEntry::level)
+        .def_readonly("count", &DiagnosticEntry::count)
+        .def_readonly("indices", &DiagnosticEntry::indices);
+
+    py::class_<ValidationResult>(mod, "ValidationResult")
+        .def_readonly("isolatedVertices", &ValidationResult::isolatedVertices)
+        .def_readonly("nonManifoldVertices", &ValidationResult::nonManifoldVertices)
+        .def_readonly("nonManifoldEdges", &ValidationResult::nonManifoldEdges)
+        .def_readonly("boundaryLoops", &ValidationResult::boundaryLoops)
+        .def("isManifold", &ValidationResult::isManifold);
+
+    py::class_<DiagnosticsReport>(mod, "DiagnosticsReport")
         .def(py::init<>())
-        .def(py::init<const Mesh&>())
-        .def("read", &Mesh::read)
-        .def("write", &Mesh::write)
-        .def_readwrite("halfEdges", &Mesh::halfEdges)
-        .def_readwrite("vertices", &Mesh::vertices)
-        .def_readwrite("uvs", &Mesh::uvs)
-        .def_readwrite("edges", &Mesh::edges)
-        .def_readwrite("faces", &Mesh::faces)
-        .def_readwrite("boundaries", &Mesh::boundaries);
+        .def_readonly("entries", &DiagnosticsReport::entries)
+        .def("empty", &DiagnosticsReport::empty)
+        .def("hasErrors", &DiagnosticsReport::hasErrors)
+        .def("count", &DiagnosticsReport::count, py::arg("code"))
+        .def("summary", &DiagnosticsReport::summary)
+        .def("__repr__", [](const DiagnosticsReport& report) {
+            return "DiagnosticsReport(" + report.summary() + ")";
+        });
+
+    py::enum_<OrientedBoxMethod>(mod, "OrientedBoxMethod")
+        .value("PrincipalComponents", PrincipalComponents)
+        .value("HullPrincipalComponents", HullPrincipalComponents)
+        .value("MinimumVolume", MinimumVolume)
+        .value("SurfacePrincipalComponents", SurfacePrincipalComponents)
+        .value("HullSurfacePrincipalComponents", HullSurfacePrincipalComponents)
+        .value("DiTO14", DiTO14)
+        .value("DiTO26", DiTO26);
 
     py::class_<BoundingBox>(mod, "BoundingBox")
         .def(py::init<>())
@@ -32,57 +498,440 @@ PYBIND11_MODULE(_meshlib, mod) {
         .def("expandToInclude", (void (BoundingBox::*)(const BoundingBox&)) &BoundingBox::expandToInclude)
         .def("maxDimension", &BoundingBox::maxDimension)
         .def("contains", &BoundingBox::contains)
-        .def("computeAxisAlignedBox", &BoundingBox::computeAxisAlignedBox)
-        .def("computeOrientedBox", &BoundingBox::computeOrientedBox)
+        .def("computeAxisAlignedBox", [](BoundingBox& bbox, const Mesh& mesh, int threads) {
+            std::shared_lock<std::shared_mutex> lock(meshLock(mesh));
+            bbox.computeAxisAlignedBox(mesh.positions, threads);
+        }, py::arg("mesh"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+        // the positions of vertex references are gathered with the GIL held, like every element access
+        .def("computeAxisAlignedBox", [](BoundingBox& bbox, const std::vector<VertexRef>& refs, int threads) {
+            PositionBuffer positions = positionBuffer(refs);
+            py::gil_scoped_release release;
+            bbox.computeAxisAlignedBox(positions, threads);
+        }, py::arg("vertices"), py::arg("threads") = 0)
+        .def("computeOrientedBox", [](BoundingBox& bbox, const Mesh& mesh, int threads, OrientedBoxMethod method) {
+            std::shared_lock<std::shared_mutex> lock(meshLock(mesh));
+            bbox.computeOrientedBox(mesh.positions, mesh.triangles, method, threads);
+        }, py::arg("mesh"), py::arg("threads") = 0, py::arg("method") = PrincipalComponents,
+           py::call_guard<py::gil_scoped_release>())
+        .def("computeOrientedBox", [](BoundingBox& bbox, const std::vector<VertexRef>& refs, int threads,
+                                      OrientedBoxMethod method) {
+            PositionBuffer positions = positionBuffer(refs);
+            bool success;
+            {
+                py::gil_scoped_release release;
+                success = bbox.computeOrientedBox(positions, method, threads);
+            }
+            if (!success) throw py::value_error(surfaceMethodError);
+        }, py::arg("vertices"), py::arg("threads") = 0, py::arg("method") = PrincipalComponents)
+        .def("computeAxisAlignedBox", [](BoundingBox& bbox, const ConvexHull& hull, int threads) {
+            bbox.computeAxisAlignedBox(hull.vertices, threads);
+        }, py::arg("hull"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+        .def("computeOrientedBox", [](BoundingBox& bbox, const ConvexHull& hull, int threads, OrientedBoxMethod method) {
+            bbox.computeOrientedBox(hull.vertices, hull.triangles, method, threads);
+        }, py::arg("hull"), py::arg("threads") = 0, py::arg("method") = PrincipalComponents,
+           py::call_guard<py::gil_scoped_release>())
+        .def("volume", &BoundingBox::volume)
         .def_readwrite("min", &BoundingBox::min)
         .def_readwrite("max", &BoundingBox::max)
         .def_readwrite("extent", &BoundingBox::extent)
         .def_readwrite("orientedPoints", &BoundingBox::orientedPoints)
         .def_readwrite("type", &BoundingBox::type);
 
-    py::class_<Vertex>(mod, "Vertex")
+    py::class_<ConvexHull>(mod, "ConvexHull")
         .def(py::init<>())
-        .def_property_readonly("he", [](const Vertex &v) { return &(*v.he); }, py::return_value_policy::reference_internal)
-        .def_readwrite("position", &Vertex::position)
-        .def_readwrite("index", &Vertex::index)
-        .def_property_readonly("isIsolated", &Vertex::isIsolated);
+        .def("compute", [](ConvexHull& hull, const Mesh& mesh, int threads) {
+            std::shared_lock<std::shared_mutex> lock(meshLock(mesh));
+            return hull.compute(mesh.positions, threads);
+        }, py::arg("mesh"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+        .def("faceCount", &ConvexHull::faceCount)
+        .def("faceNormal", &ConvexHull::faceNormal)
+        .def_property_readonly("vertices", [](const ConvexHull& hull) {
+            Eigen::Matrix<double, Eigen::Dynamic, 3, Eigen::RowMajor> vertices(hull.vertices.size(), 3);
+            for (size_t i = 0; i < hull.vertices.size(); i++) vertices.row(i) = hull.vertices.get(i);
+            return vertices;
+        })
+        .def_readonly("vertexIndices", &ConvexHull::vertexIndices)
+        .def_property_readonly("triangles", [](const ConvexHull& hull) {
+            return Eigen::Map<const Eigen::Matrix<uint32_t, Eigen::Dynamic, 3, Eigen::RowMajor>>(
+                hull.triangles.data(), hull.faceCount(), 3).eval();
+        });
 
-    py::class_<Face>(mod, "Face")
+    py::class_<OBBTree>(mod, "OBBTree")
         .def(py::init<>())
-        .def_property_readonly("isBoundary", &Face::isBoundary)
-        .def_property_readonly("area", &Face::area)
-        .def_property_readonly("normal", &Face::normal)
-        .def_property_readonly("he", [](const Face& f) { return &(*f.he);}, py::return_value_policy::reference_internal);
+        .def("build", [](OBBTree& tree, const Mesh& mesh, int threads) {
+            std::shared_lock<std::shared_mutex> lock(meshLock(mesh));
+            return tree.build(mesh, threads);
+        }, py::arg("mesh"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>())
+        .def("nodeCount", &OBBTree::nodeCount)
+        .def("triangleCount", &OBBTree::triangleCount)
+        .def("depth", &OBBTree::depth)
+        .def_static("intersects", [](const OBBTree& a, const OBBTree& b, const Eigen::Matrix4d& transform) {
+            Eigen::Isometry3d isometry;
+            isometry.matrix() = transform;
+            return OBBTree::intersects(a, b, isometry);
+        }, py::arg("a"), py::arg("b"), py::arg("transform") = Eigen::Matrix4d(Eigen::Matrix4d::Identity()),
+           py::call_guard<py::gil_scoped_release>())
+        .def_readonly("triangleIndices", &OBBTree::triangleIndices);
 
-    py::class_<Edge>(mod, "Edge")
+    py::class_<OrientedBox>(mod, "OrientedBox")
         .def(py::init<>())
-        .def_property_readonly("halfEdge", [](const Edge &e) { return &(*e.he); }, py::return_value_policy::reference_internal)
-        .def_property_readonly("length", &Edge::length);
+        .def(py::init<const Eigen::Vector3d&, const Eigen::Matrix3d&, const Eigen::Vector3d&>(),
+             py::arg("center"), py::arg("axes"), py::arg("halfExtents"))
+        .def(py::init<const BoundingBox&>(), py::arg("boundingBox"))
+        .def("overlaps", &OrientedBox::overlaps)
+        .def("volume", &OrientedBox::volume)
+        .def_readwrite("center", &OrientedBox::center)
+        .def_readwrite("axes", &OrientedBox::axes)
+        .def_readwrite("halfExtents", &OrientedBox::halfExtents);
 
-    py::class_<HalfEdge>(mod, "HalfEdge")
+    py::class_<BVH>(mod, "BVH")
         .def(py::init<>())
-        .def_property_readonly("next", [](HalfEdge &he) { return &(*he.next); }, py::return_value_policy::reference_internal)
-        .def_property_readonly("flip", [](HalfEdge &he) { return &(*he.flip); }, py::return_value_policy::reference_internal)
-        .def_property_readonly("vertex", [](HalfEdge &he) { return &(*he.vertex); }, py::return_value_policy::reference_internal)
-        .def_property_readonly("edge", [](HalfEdge &he) { return &(*he.edge); }, py::return_value_policy::reference_internal)
-        .def_property_readonly("face", [](HalfEdge &he) { return &(*he.face); }, py::return_value_policy::reference_internal)
-        .def_readwrite("uv", &HalfEdge::uv)
-        .def_readwrite("normal", &HalfEdge::normal)
-        .def_readonly("onBoundary", &HalfEdge::onBoundary);
-
-    mod.def("load_and_compute_axis_aligned_box", [](const std::string& filename) {
-        Mesh mesh;
-        mesh.read(filename);
+        .def("build", [](BVH& bvh, const Mesh& mesh) {
+            std::shared_lock<std::shared_mutex> lock(meshLock(mesh));
+            return bvh.build(mesh);
+        }, py::arg("mesh"), py::call_guard<py::gil_scoped_release>())
+        .def("nodeCount", &BVH::nodeCount)
+        .def("triangleCount", &BVH::triangleCount)
+        .def("raycast", [](const BVH& bvh, const PointArray& origins, const PointArray& directions, int threads,
+                           double maxDistance) {
+            std::vector<RayHit> hits;
+            bool valid;
+            {
+                py::gil_scoped_release release;
+                valid = bvh.raycast(positionBuffer(origins), positionBuffer(directions), hits, threads, maxDistance);
+            }
+            if (!valid) {
+                throw py::value_error("origins and directions must have the same number of rows");
+            }
+
+            Eigen::VectorXd distances(hits.size());
+            Eigen::Matrix<int64_t, Eigen::Dynamic, 1> triangles(hits.size());
+            for (size_t i = 0; i < hits.size(); i++) {
+                distances[i] = hits[i].triangle == InvalidId ? INFINITY : hits[i].distance;
+                triangles[i] = triangleIndex(hits[i].triangle);
+            }
+            return py::make_tuple(distances, triangles);
+        }, py::arg("origins"), py::arg("directions"), py::arg("threads") = 0, py::arg("maxDistance") = INFINITY)
+        .def("closestPoints", [](const BVH& bvh, const PointArray& points, int threads) {
+            std::vector<ClosestPoint> results;
+            {
+                py::gil_scoped_release release;
+                bvh.closestPoints(positionBuffer(points), results, threads);
+            }
+
+            PointArray closest(results.size(), 3);
+            Eigen::VectorXd distances(results.size());
+            Eigen::Matrix<int64_t, Eigen::Dynamic, 1> triangles(results.size());
+            for (size_t i = 0; i < results.size(); i++) {
+                closest.row(i) = results[i].point.transpose();
+                distances[i] = results[i].distance;
+                triangles[i] = triangleIndex(results[i].triangle);
+            }
+            return py::make_tuple(closest, distances, triangles);
+        }, py::arg("points"), py::arg("threads") = 0);
+
+    py::class_<VertexRef> vertex(mod, "Vertex");
+    bindElementRef(vertex);
+    vertex
+        .def_property_readonly("he", [](const VertexRef& v) {
+            const Vertex& vertex = element(v);
+            return vertex.isIsolated() ? py::cast(nullptr) : py::cast(HalfEdgeRef{v.mesh, vertex.he});
+        })
+        .def_property("position",
+            [](const VertexRef& v) { return element(v).position; },
+            [](const VertexRef& v, const Eigen::Vector3d& p) {
+                std::unique_lock<std::shared_mutex> lock = lockMeshForWrite(*v.mesh);
+                element(v).position = p;
+                v.mesh->positions.set(v.index, p);
+                v.mesh->vertexNormals.clear();
+            })
+        .def_property("index",
+            [](const VertexRef& v) { return element(v).index; },
+            [](const VertexRef& v, int index) {
+                std::unique_lock<std::shared_mutex> lock = lockMeshForWrite(*v.mesh);
+                element(v).index = index;
+            })
+        .def_property_readonly("isIsolated", [](const VertexRef& v) { return element(v).isIsolated(); });
+
+    py::class_<FaceRef> face(mod, "Face");
+    bindElementRef(face);
+    face
+        .def_property_readonly("isBoundary", [](const FaceRef& f) { return element(f).isBoundary(*f.mesh); })
+        .def_property_readonly("area", [](const FaceRef& f) { return element(f).area(*f.mesh); })
+        .def_property_readonly("normal", [](const FaceRef& f) { return element(f).normal(*f.mesh); })
+        .def_property_readonly("he", [](const FaceRef& f) { return HalfEdgeRef{f.mesh, element(f).he}; });
+
+    py::class_<EdgeRef> edge(mod, "Edge");
+    bindElementRef(edge);
+    edge
+        .def_property_readonly("halfEdge", [](const EdgeRef& e) { return HalfEdgeRef{e.mesh, element(e).he}; })
+        .def_property_readonly("length", [](const EdgeRef& e) { return element(e).length(*e.mesh); });
+
+    // uvs and normals may be shared by several corners, so setting one gives the halfedge an entry of its own
+    py::class_<HalfEdgeRef> halfEdge(mod, "HalfEdge");
+    bindElementRef(halfEdge);
+    halfEdge
+        .def_property_readonly("next", [](const HalfEdgeRef& h) { return HalfEdgeRef{h.mesh, element(h).next}; })
+        .def_property_readonly("flip", [](const HalfEdgeRef& h) { return HalfEdgeRef{h.mesh, element(h).flip}; })
+        .def_property_readonly("vertex", [](const HalfEdgeRef& h) { return VertexRef{h.mesh, element(h).vertex}; })
+        .def_property_readonly("edge", [](const HalfEdgeRef& h) { return EdgeRef{h.mesh, element(h).edge}; })
+        .def_property_readonly("face", [](const HalfEdgeRef& h) { return FaceRef{h.mesh, element(h).face}; })
+        .def_property("uv",
+            [](const HalfEdgeRef& h) { return element(h).uvCoordinates(*h.mesh); },
+            [](const HalfEdgeRef& h, const Eigen::Vector3d& uv) {
+                std::unique_lock<std::shared_mutex> lock = lockMeshForWrite(*h.mesh);
+                element(h).uv = (uint32_t)h.mesh->uvs.size();
+                h.mesh->uvs.push_back(uv);
+            })
+        .def_property("normal",
+            [](const HalfEdgeRef& h) { return element(h).vertexNormal(*h.mesh); },
+            [](const HalfEdgeRef& h, const Eigen::Vector3d& normal) {
+                std::unique_lock<std::shared_mutex> lock = lockMeshForWrite(*h.mesh);
+                element(h).normal = (uint32_t)h.mesh->normals.size();
+                h.mesh->normals.push_back(normal);
+            })
+        .def_property_readonly("onBoundary", [](const HalfEdgeRef& h) { return element(h).onBoundary; });
+
+    mod.def("overlapMatrix", [](const std::vector<OrientedBox>& a, const std::vector<OrientedBox>& b, int threads) {
+        std::vector<uint8_t> flags;
+        BoxOverlap::overlapMatrix(orientedBoxBuffer(a), orientedBoxBuffer(b), flags, threads);
+
+        Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> result(a.size(), b.size());
+        for (size_t i = 0; i < flags.size(); i++) result.data()[i] = flags[i] != 0;
+        return result;
+    }, py::arg("a"), py::arg("b"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>());
+
+    mod.def("overlappingPairs", [](const std::vector<OrientedBox>& a, const std::vector<OrientedBox>& b, int threads) {
+        std::vector<std::pair<uint32_t, uint32_t>> pairs;
+        BoxOverlap::overlappingPairs(orientedBoxBuffer(a), orientedBoxBuffer(b), pairs, threads);
+        return pairArray(pairs);
+    }, py::arg("a"), py::arg("b"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>());
+
+    mod.def("sweepAndPrune", [](const std::vector<OrientedBox>& boxes, int threads) {
+        std::vector<std::pair<uint32_t, uint32_t>> pairs;
+        BoxOverlap::sweepAndPrune(orientedBoxBuffer(boxes), pairs, threads);
+        return pairArray(pairs);
+    }, py::arg("boxes"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>());
+
+    // boxes of points already in memory, the arrays are read in place and the GIL is released while fitting
+    mod.def("compute_aabb", [](py::object points, int threads) {
+        PointArrayView view = pointArrayView(points);
         BoundingBox bbox;
-        bbox.computeAxisAlignedBox(mesh.vertices);
+        {
+            py::gil_scoped_release release;
+            bbox.computeAxisAlignedBox(*view.source, threads);
+        }
         return bbox;
-    });
+    }, py::arg("points"), py::arg("threads") = 0);
 
-    mod.def("load_and_compute_oriented_box", [](const std::string& filename) {
-        Mesh mesh;
-        mesh.read(filename);
+    mod.def("compute_obb", [](py::object points, OrientedBoxMethod method, int threads) {
+        PointArrayView view = pointArrayView(points);
         BoundingBox bbox;
-        bbox.computeOrientedBox(mesh.vertices);
+        {
+            py::gil_scoped_release release;
+            if (!bbox.computeOrientedBox(*view.source, method, threads)) throw py::value_error(surfaceMethodError);
+        }
         return bbox;
+    }, py::arg("points"), py::arg("method") = PrincipalComponents, py::arg("threads") = 0);
+
+    // one box per array, the arrays are spread over the threads and each is fitted on one thread
+    mod.def("compute_aabb_batch", [](const std::vector<py::object>& pointsList, int threads) {
+        std::vector<PointArrayView> views = pointArrayViews(pointsList);
+        std::vector<BoundingBox> boxes(views.size());
+        {
+            py::gil_scoped_release release;
+            ThreadPool::global().parallelFor(views.size(), [&](size_t i) {
+                boxes[i].computeAxisAlignedBox(*views[i].source, 1);
+            }, ThreadPool::resolveThreadCount(threads));
+        }
+        return boxes;
+    }, py::arg("points_list"), py::arg("threads") = 0);
+
+    mod.def("compute_obb_batch", [](const std::vector<py::object>& pointsList, OrientedBoxMethod method, int threads) {
+        if (method == SurfacePrincipalComponents) throw py::value_error(surfaceMethodError);
+        std::vector<PointArrayView> views = pointArrayViews(pointsList);
+        std::vector<BoundingBox> boxes(views.size());
+        {
+            py::gil_scoped_release release;
+            ThreadPool::global().parallelFor(views.size(), [&](size_t i) {
+                boxes[i].computeOrientedBox(*views[i].source, method, 1);
+            }, ThreadPool::resolveThreadCount(threads));
+        }
+        return boxes;
+    }, py::arg("points_list"), py::arg("method") = PrincipalComponents, py::arg("threads") = 0);
+
+    // hooks for the tests, not part of the API: runs n iterations on the library pool, iteration fail throws,
+    // and returns the number of iterations run
+    py::module testing = mod.def_submodule("_testing");
+    testing.def("parallel_for_failing_at", [](size_t n, size_t fail, int threads) {
+        std::atomic<size_t> ran(0);
+        ThreadPool::global().parallelFor(n, [&](size_t i) {
+            ran++;
+            if (i == fail) throw std::runtime_error("iteration " + std::to_string(i) + " failed");
+        }, ThreadPool::resolveThreadCount(threads));
+        return ran.load();
+    }, py::arg("n"), py::arg("fail"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>());
+
+    // stream the positions of the file instead of building the mesh, the boxes match those of Mesh::read
+    mod.def("load_and_compute_axis_aligned_box", [](const std::string& filename, int threads) {
+        BoundingBox bbox;
+        if (!streamBox(filename, threads, false, bbox)) {
+            throw std::runtime_error("could not read positions of " + filename);
+        }
+        return bbox;
+    }, py::arg("filename"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>());
+
+    mod.def("load_and_compute_oriented_box", [](const std::string& filename, int threads) {
+        BoundingBox bbox;
+        if (!streamBox(filename, threads, true, bbox)) {
+            throw std::runtime_error("could not read positions of " + filename);
+        }
+        return bbox;
+    }, py::arg("filename"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>());
+
+    // on-disk cache of the boxes of the file based helpers, keyed by the contents of the file
+    mod.def("enable_result_cache", [](const std::string& directory, size_t maxEntries) {
+        std::shared_ptr<ResultCache> cache = std::make_shared<ResultCache>(directory, maxEntries);
+        std::lock_guard<std::mutex> lock(resultCacheMutex);
+        resultCache = cache;
+    }, py::arg("directory"), py::arg("max_entries") = 10000, py::call_guard<py::gil_scoped_release>());
+
+    mod.def("disable_result_cache", []() {
+        std::lock_guard<std::mutex> lock(resultCacheMutex);
+        resultCache.reset();
+    });
+
+    mod.def("clear_result_cache", []() {
+        std::shared_ptr<ResultCache> cache = currentResultCache();
+        if (cache) cache->clear();
+    }, py::call_guard<py::gil_scoped_release>());
+
+    mod.def("result_cache_stats", []() -> py::object {
+        std::shared_ptr<ResultCache> cache = currentResultCache();
+        if (!cache) return py::none();
+
+        py::dict stats;
+        stats["directory"] = cache->directory();
+        stats["entries"] = cache->size();
+        stats["hits"] = cache->hits();
+        stats["misses"] = cache->misses();
+        stats["evictions"] = cache->evictions();
+        return stats;
+    });
+
+    // read a mesh cache with the boxes stored in it, raises if the cache is missing or fails a check
+    mod.def("read_mesh_cache", [](const std::string& filename, bool verify) {
+        std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+        BoundingBox axisAlignedBox, orientedBox;
+        bool success;
+        {
+            py::gil_scoped_release release;
+            success = MeshCache::read(filename, *mesh, &axisAlignedBox, &orientedBox, verify);
+        }
+        if (!success) throw std::runtime_error("could not read mesh cache " + filename);
+        return py::make_tuple(mesh, axisAlignedBox, orientedBox);
+    }, py::arg("filename"), py::arg("verify") = true);
+
+    // index based connectivity checks of a mesh, the GIL is released while they run
+    mod.def("validate_mesh", [](const Mesh& mesh, int threads) {
+        std::shared_lock<std::shared_mutex> lock(meshLock(mesh));
+        return MeshValidator::validate(mesh, threads);
+    }, py::arg("mesh"), py::arg("threads") = 0, py::call_guard<py::gil_scoped_release>());
+
+    // messages of the library, dropped unless a level is set
+    mod.def("set_log_level", &Log::setLevel, py::arg("level"));
+    mod.def("log_level", &Log::level);
+
+    // the sink is called with the level and the message, from whichever thread logs, None restores stderr
+    mod.def("set_log_sink", [](py::object sink) {
+        if (sink.is_none()) {
+            Log::setSink(nullptr);
+            return;
+        }
+        if (!PyCallable_Check(sink.ptr())) throw py::type_error("the log sink must be callable or None");
+
+        // the last copy of the sink may be dropped on a thread that does not hold the GIL
+        std::shared_ptr<py::function> function(new py::function(sink), [](py::function* f) {
+            py::gil_scoped_acquire gil;
+            delete f;
+        });
+        Log::setSink([function](LogLevel level, const std::string& message) {
+            py::gil_scoped_acquire gil;
+            try {
+                (*function)(level, message);
+            } catch (py::error_already_set& e) {
+                e.discard_as_unraisable("log sink");
+            }
+        });
+    }, py::arg("sink"));
+
+    // stage timings of mesh loading and box fitting, collected while profiling is enabled
+    mod.def("set_profiling", &Profiler::setEnabled, py::arg("enabled"));
+    mod.def("is_profiling", &Profiler::isEnabled);
+    mod.def("reset_profile", &Profiler::reset);
+    mod.def("write_chrome_trace", &Profiler::writeChromeTrace, py::arg("filename"),
+            py::call_guard<py::gil_scoped_release>());
+
+    mod.def("profile_stats", []() {
+        ProfileStats stats = Profiler::stats();
+        py::dict stages;
+        for (const auto& entry : stats.stages) {
+            py::dict stage;
+            stage["calls"] = entry.second.calls;
+            stage["seconds"] = entry.second.seconds;
+            stage["elements"] = entry.second.elements;
+            stage["bytes"] = entry.second.bytes;
+            stages[py::str(entry.first)] = stage;
+        }
+        return stages;
     });
+
+    // asynchronous versions, each returns a concurrent.futures.Future, await it with asyncio.wrap_future
+    mod.def("read_mesh_async", [](const std::string& filename, int threads) {
+        return AsyncRunner::instance().submit([filename, threads]() {
+            std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+            if (!mesh->read(filename, threads)) throw std::runtime_error("could not read mesh " + filename);
+            return mesh;
+        });
+    }, py::arg("filename"), py::arg("threads") = 1);
+
+    mod.def("compute_aabb_async", [](std::shared_ptr<Mesh> mesh, int threads) {
+        return AsyncRunner::instance().submit([mesh, threads]() {
+            std::shared_lock<std::shared_mutex> lock(meshLock(*mesh));
+            BoundingBox bbox;
+            bbox.computeAxisAlignedBox(mesh->positions, threads);
+            return bbox;
+        });
+    }, py::arg("mesh"), py::arg("threads") = 1);
+
+    mod.def("compute_obb_async", [](std::shared_ptr<Mesh> mesh, OrientedBoxMethod method, int threads) {
+        return AsyncRunner::instance().submit([mesh, method, threads]() {
+            std::shared_lock<std::shared_mutex> lock(meshLock(*mesh));
+            BoundingBox bbox;
+            bbox.computeOrientedBox(mesh->positions, mesh->triangles, method, threads);
+            return bbox;
+        });
+    }, py::arg("mesh"), py::arg("method") = PrincipalComponents, py::arg("threads") = 1);
+
+    mod.def("load_and_compute_axis_aligned_box_async", [](const std::string& filename, int threads) {
+        return AsyncRunner::instance().submit([filename, threads]() {
+            BoundingBox bbox;
+            if (!streamBox(filename, threads, false, bbox)) {
+                throw std::runtime_error("could not read positions of " + filename);
+            }
+            return bbox;
+        });
+    }, py::arg("filename"), py::arg("threads") = 1);
+
+    mod.def("load_and_compute_oriented_box_async", [](const std::string& filename, int threads) {
+        return AsyncRunner::instance().submit([filename, threads]() {
+            BoundingBox bbox;
+            if (!streamBox(filename, threads, true, bbox)) {
+                throw std::runtime_error("could not read positions of " + filename);
+            }
+            return bbox;
+        });
+    }, py::arg("filename"), py::arg("threads") = 1);
+
+    py::module::import("atexit").attr("register")(py::cpp_function([]() { AsyncRunner::instance().wait(); }));
 }
\ No newline at end of file
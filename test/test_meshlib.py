@@ -1,4 +1,9 @@
 import sys
+import os
+import asyncio
+import json
+import shutil
+import subprocess
 sys.path.append('.')
 
 import _meshlib
@@ -17,6 +22,12 @@ def load_obj(filename):
 def sample_mesh_vertices():
     return load_obj(obj_file_path)
 
+@pytest.fixture
+def bunny_mesh():
+    mesh = _meshlib.Mesh()
+    assert mesh.read(obj_file_path)
+    return mesh
+
 def test_axis_aligned_box(sample_mesh_vertices):
     # Python Side
     bbox_py = BoundingBox()
@@ -49,3 +60,488 @@ def test_empty_bounding_box():
 
     np.testing.assert_almost_equal(bbox_cpp.min, bbox_py.min)
     np.testing.assert_almost_equal(bbox_cpp.max, bbox_py.max)
+
+def write_grid_obj(path, n):
+    # an n x n vertex grid with uvs and normals, split into quads and triangle pairs on alternate rows and
+    # open along its border
+    u, v = np.meshgrid(np.linspace(0, 1, n), np.linspace(0, 1, n))
+    u, v = u.ravel(), v.ravel()
+    z = 0.1 * np.sin(6 * u) * np.cos(4 * v)
+    lines = ["v %.6f %.6f %.6f" % p for p in zip(u, v, z)]
+    lines += ["vt %.6f %.6f" % t for t in zip(u, v)]
+    lines += ["vn %.6f %.6f %.6f" % (0.0, 0.6, 0.8)] * len(u)
+    for i in range(n - 1):
+        for j in range(n - 1):
+            a, b, c, d = i * n + j + 1, i * n + j + 2, (i + 1) * n + j + 2, (i + 1) * n + j + 1
+            if i % 2 == 0:
+                lines.append("f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d" % (a, a, a, b, b, b, c, c, c, d, d, d))
+            else:
+                lines.append("f %d/%d/%d %d/%d/%d %d/%d/%d" % (a, a, a, b, b, b, c, c, c))
+                lines.append("f %d/%d/%d %d/%d/%d %d/%d/%d" % (a, a, a, c, c, c, d, d, d))
+    with open(path, "w") as f:
+        f.write("\n".join(lines) + "\n")
+
+def test_parallel_read_matches_serial(tmp_path):
+    # large enough to be parsed in several chunks of at least 1 MiB
+    path = str(tmp_path / "grid.obj")
+    write_grid_obj(path, 250)
+    assert os.path.getsize(path) > 6 << 20
+
+    serial = _meshlib.Mesh()
+    assert serial.read(path)
+    parallel = _meshlib.Mesh()
+    assert parallel.read(path, threads=4)
+
+    np.testing.assert_array_equal(parallel.positions, serial.positions)
+    np.testing.assert_array_equal(parallel.triangles, serial.triangles)
+    np.testing.assert_array_equal(parallel.edgeVertices, serial.edgeVertices)
+    np.testing.assert_array_equal(np.array(parallel.uvs), np.array(serial.uvs))
+    np.testing.assert_array_equal(np.array(parallel.normals), np.array(serial.normals))
+
+    assert len(parallel.faces) == len(serial.faces)
+    for f_serial, f_parallel in zip(serial.faces, parallel.faces):
+        he_serial, he_parallel = f_serial.he, f_parallel.he
+        assert he_parallel.id == he_serial.id and he_parallel.vertex.id == he_serial.vertex.id
+        if not f_serial.isBoundary:
+            np.testing.assert_array_equal(he_parallel.uv, he_serial.uv)
+            np.testing.assert_array_equal(he_parallel.normal, he_serial.normal)
+    assert [b.id for b in parallel.boundaries] == [b.id for b in serial.boundaries]
+    assert len(serial.boundaries) == 1
+
+def test_mesh_copy_is_independent():
+    mesh = _meshlib.Mesh()
+    assert mesh.read(obj_file_path)
+
+    copy = _meshlib.Mesh(mesh)
+    del mesh
+
+    face = copy.faces[0]
+    he = face.he
+    assert he.next.next.next == he
+    assert he.flip.flip == he
+    assert he.face == face
+    assert face.area > 0
+
+def test_write_round_trip(tmp_path):
+    mesh = _meshlib.Mesh()
+    assert mesh.read("assets/mesh_obj/HatsuneMiku.obj.obj")
+    positions = mesh.positions.copy()
+
+    path = str(tmp_path / "out.obj")
+    assert mesh.write(path)
+    np.testing.assert_array_equal(mesh.positions, positions)
+
+    parallel_path = str(tmp_path / "parallel.obj")
+    assert mesh.write(parallel_path, 0)
+    assert open(path, "rb").read() == open(parallel_path, "rb").read()
+
+    copy = _meshlib.Mesh()
+    assert copy.read(path)
+    np.testing.assert_allclose(copy.positions, positions, atol=1e-12)
+    np.testing.assert_array_equal(copy.triangles, mesh.triangles)
+    np.testing.assert_array_equal(np.array(copy.uvs), np.array(mesh.uvs))
+    np.testing.assert_array_equal(np.array(copy.normals), np.array(mesh.normals))
+    assert len(copy.boundaries) == len(mesh.boundaries)
+
+    assert not mesh.write(str(tmp_path / "missing" / "out.obj"))
+
+def test_mesh_arrays_view_mesh_memory():
+    mesh = _meshlib.Mesh()
+    assert mesh.read(obj_file_path)
+
+    positions = mesh.positions
+    assert positions.shape == (len(mesh.vertices), 3) and not positions.flags.writeable
+    np.testing.assert_array_equal(positions[10], mesh.vertices[10].position)
+
+    # edits through the bindings show up in the existing view, which outlives the mesh
+    mesh.vertices[10].position = np.array([1.0, 2.0, 3.0])
+    np.testing.assert_array_equal(positions[10], [1.0, 2.0, 3.0])
+
+    triangles = mesh.triangles
+    assert triangles.shape == (sum(1 for f in mesh.faces if not f.isBoundary), 3)
+    assert triangles.max() < len(mesh.vertices)
+
+    edges = mesh.edgeVertices
+    assert edges.shape == (len(mesh.edges), 2)
+    he = mesh.edges[5].halfEdge
+    assert sorted(edges[5]) == sorted([he.vertex.id, he.flip.vertex.id])
+
+    lengths = np.linalg.norm(mesh.vertexNormals, axis=1)
+    np.testing.assert_allclose(lengths[lengths > 0], 1.0)
+
+    del mesh
+    np.testing.assert_array_equal(positions[10], [1.0, 2.0, 3.0])
+
+def test_mesh_arrays_keep_their_data_after_read(tmp_path):
+    cache_path = str(tmp_path / "gourd.cache")
+    mesh = _meshlib.Mesh()
+    assert mesh.read("assets/gourd.obj")
+    assert mesh.writeCache(cache_path)
+    positions, triangles = mesh.positions, mesh.triangles
+    gourd_positions, gourd_triangles = positions.copy(), triangles.copy()
+
+    # reading a larger file replaces the mesh, the old arrays keep viewing the old contents
+    assert mesh.read(obj_file_path)
+    assert len(mesh.vertices) > len(gourd_positions)
+    np.testing.assert_array_equal(positions, gourd_positions)
+    np.testing.assert_array_equal(triangles, gourd_triangles)
+    assert mesh.positions.shape == (len(mesh.vertices), 3)
+
+    bunny_positions = mesh.positions
+    bunny_copy = bunny_positions.copy()
+    assert mesh.readCache(cache_path)
+    np.testing.assert_array_equal(bunny_positions, bunny_copy)
+    np.testing.assert_array_equal(mesh.positions, gourd_positions)
+
+    # a failed read leaves a viewed mesh as it was
+    assert not mesh.read("assets/missing.obj")
+    np.testing.assert_array_equal(mesh.positions, gourd_positions)
+
+    del mesh
+    np.testing.assert_array_equal(positions, gourd_positions)
+    np.testing.assert_array_equal(bunny_positions, bunny_copy)
+
+def test_element_views_check_their_index(bunny_mesh):
+    he = bunny_mesh.faces[0].he
+    he.uv = np.array([0.25, 0.5, 0.0])
+    np.testing.assert_array_equal(he.uv, [0.25, 0.5, 0.0])
+    np.testing.assert_array_equal(he.next.uv, [0.0, 0.0, 0.0])
+    assert len(bunny_mesh.uvs) == 1
+    bunny_mesh.vertices[3].index = 7
+    assert bunny_mesh.vertices[3].index == 7
+
+    # views kept across a read of a smaller mesh raise instead of reading past its arrays
+    vertex, last = bunny_mesh.vertices[-1], bunny_mesh.halfEdges[-1]
+    assert bunny_mesh.read("assets/gourd.obj")
+    with pytest.raises(IndexError):
+        vertex.position
+    with pytest.raises(IndexError):
+        last.next
+    with pytest.raises(IndexError):
+        vertex.position = np.zeros(3)
+
+def test_bounding_box_follows_vertex_edits(bunny_mesh):
+    bunny_mesh.vertices[0].position = np.array([5.0, -6.0, 7.0])
+
+    bbox = _meshlib.BoundingBox()
+    bbox.computeAxisAlignedBox(bunny_mesh)
+    np.testing.assert_almost_equal(bbox.min[1], -6.0)
+    np.testing.assert_almost_equal(bbox.max[0], 5.0)
+    np.testing.assert_almost_equal(bbox.max[2], 7.0)
+
+    subset = _meshlib.BoundingBox()
+    subset.computeAxisAlignedBox(bunny_mesh.vertices[:1])
+    np.testing.assert_almost_equal(subset.min, [5.0, -6.0, 7.0])
+    np.testing.assert_almost_equal(subset.max, [5.0, -6.0, 7.0])
+
+def test_oriented_box_is_independent_of_thread_count(bunny_mesh):
+    serial = _meshlib.BoundingBox()
+    serial.computeOrientedBox(bunny_mesh, threads=1)
+    parallel = _meshlib.BoundingBox()
+    parallel.computeOrientedBox(bunny_mesh, threads=4)
+
+    for p_serial, p_parallel in zip(serial.orientedPoints, parallel.orientedPoints):
+        np.testing.assert_array_equal(p_serial, p_parallel)
+
+def test_streamed_boxes_match_loaded_mesh(bunny_mesh):
+    loaded = _meshlib.BoundingBox()
+    loaded.computeAxisAlignedBox(bunny_mesh)
+    streamed = _meshlib.load_and_compute_axis_aligned_box(obj_file_path, threads=2)
+    np.testing.assert_allclose(streamed.min, loaded.min, atol=1e-12)
+    np.testing.assert_allclose(streamed.max, loaded.max, atol=1e-12)
+
+    loaded.computeOrientedBox(bunny_mesh)
+    streamed = _meshlib.load_and_compute_oriented_box(obj_file_path, threads=2)
+    for p_loaded, p_streamed in zip(loaded.orientedPoints, streamed.orientedPoints):
+        np.testing.assert_allclose(p_streamed, p_loaded, atol=1e-12)
+
+    with pytest.raises(RuntimeError):
+        _meshlib.load_and_compute_axis_aligned_box("assets/missing.obj")
+    with pytest.raises(RuntimeError):
+        _meshlib.load_and_compute_oriented_box("assets/missing.obj")
+
+def test_result_cache_counts_hits_and_evicts(tmp_path):
+    _meshlib.enable_result_cache(str(tmp_path / "cache"), max_entries=1)
+    try:
+        streamed = _meshlib.load_and_compute_oriented_box(obj_file_path)
+        cached = _meshlib.load_and_compute_oriented_box(obj_file_path)
+        for p_streamed, p_cached in zip(streamed.orientedPoints, cached.orientedPoints):
+            np.testing.assert_array_equal(p_cached, p_streamed)
+
+        # both boxes are stored in one entry, and the key is the file contents, not its name
+        shutil.copy(obj_file_path, tmp_path / "copy.obj")
+        _meshlib.load_and_compute_axis_aligned_box(str(tmp_path / "copy.obj"))
+        stats = _meshlib.result_cache_stats()
+        assert (stats["hits"], stats["misses"], stats["evictions"]) == (2, 1, 0)
+
+        _meshlib.load_and_compute_axis_aligned_box("assets/gourd.obj")
+        stats = _meshlib.result_cache_stats()
+        assert (stats["misses"], stats["evictions"], stats["entries"]) == (2, 1, 1)
+    finally:
+        _meshlib.disable_result_cache()
+    assert _meshlib.result_cache_stats() is None
+
+def test_mesh_cache_round_trip(tmp_path, bunny_mesh):
+    cache_path = str(tmp_path / "bunny.omc")
+    assert bunny_mesh.writeCache(cache_path)
+
+    cached, aabb, obb = _meshlib.read_mesh_cache(cache_path)
+    np.testing.assert_array_equal(cached.positions, bunny_mesh.positions)
+    np.testing.assert_array_equal(cached.triangles, bunny_mesh.triangles)
+    assert [he.flip.id for he in cached.halfEdges] == [he.flip.id for he in bunny_mesh.halfEdges]
+
+    unverified, _, _ = _meshlib.read_mesh_cache(cache_path, verify=False)
+    np.testing.assert_array_equal(unverified.positions, bunny_mesh.positions)
+
+    expected = _meshlib.BoundingBox()
+    expected.computeAxisAlignedBox(bunny_mesh)
+    np.testing.assert_array_equal(aabb.min, expected.min)
+    np.testing.assert_array_equal(aabb.max, expected.max)
+    expected.computeOrientedBox(bunny_mesh)
+    for p_expected, p_cached in zip(expected.orientedPoints, obb.orientedPoints):
+        np.testing.assert_allclose(p_cached, p_expected, atol=1e-12)
+
+    # a flipped byte fails the checksum and leaves the mesh as it was
+    data = bytearray(open(cache_path, "rb").read())
+    data[len(data) // 2] ^= 1
+    open(cache_path, "wb").write(data)
+    assert not cached.readCache(cache_path)
+    assert len(cached.vertices) == len(bunny_mesh.vertices)
+    with pytest.raises(RuntimeError):
+        _meshlib.read_mesh_cache(cache_path)
+
+def test_boxes_of_numpy_arrays_match_mesh_boxes(bunny_mesh):
+    points = np.array([v.position for v in bunny_mesh.vertices])
+
+    expected = _meshlib.BoundingBox()
+    expected.computeOrientedBox(bunny_mesh)
+    for array in [points, points.astype(np.float32), np.asfortranarray(points)]:
+        bbox = _meshlib.compute_obb(array)
+        for p_expected, p_bbox in zip(expected.orientedPoints, bbox.orientedPoints):
+            np.testing.assert_allclose(p_bbox, p_expected, atol=1e-6)
+
+    aabb = _meshlib.compute_aabb(points)
+    np.testing.assert_array_equal(aabb.min, points.min(axis=0))
+    np.testing.assert_array_equal(aabb.max, points.max(axis=0))
+
+    parts = [points[:1000], points[1000:5000], points[5000:]]
+    for bbox, part in zip(_meshlib.compute_obb_batch(parts, threads=2), parts):
+        single = _meshlib.compute_obb(part, threads=1)
+        for p_batch, p_single in zip(bbox.orientedPoints, single.orientedPoints):
+            np.testing.assert_array_equal(p_batch, p_single)
+    assert len(_meshlib.compute_aabb_batch(parts)) == 3
+
+    with pytest.raises(ValueError):
+        _meshlib.compute_aabb(np.zeros((4, 2)))
+
+def test_profiler_records_load_stages(tmp_path):
+    _meshlib.reset_profile()
+    _meshlib.set_profiling(True)
+    try:
+        mesh = _meshlib.Mesh()
+        assert mesh.read(obj_file_path)
+        _meshlib.BoundingBox().computeOrientedBox(mesh)
+    finally:
+        _meshlib.set_profiling(False)
+
+    stats = _meshlib.profile_stats()
+    for stage in ["Mesh::read", "ObjParser::parse", "MeshIO::buildMesh", "MeshValidator::validate",
+                  "Mesh::normalize", "BoundingBox::computeOrientedBox"]:
+        assert stats[stage]["calls"] == 1 and stats[stage]["seconds"] >= 0
+    assert stats["Mesh::read"]["elements"] == len(mesh.triangles)
+    assert stats["MeshIO::buildMesh"]["bytes"] > 0
+
+    trace_path = str(tmp_path / "trace.json")
+    assert _meshlib.write_chrome_trace(trace_path)
+    events = json.load(open(trace_path))["traceEvents"]
+    assert {e["name"] for e in events} == set(stats)
+    assert all(e["ph"] == "X" for e in events)
+
+    # nothing is collected while profiling is off
+    mesh.read(obj_file_path)
+    assert _meshlib.profile_stats()["Mesh::read"]["calls"] == 1
+
+def test_diagnostics_are_aggregated_and_silent_by_default(tmp_path, capfd):
+    path = tmp_path / "dirty.obj"
+    path.write_text("v 0 0 0\nv 1 0 0\nv 0 1 0\nv 0 0 1\n" + "v 5 5 5\n" * 40 + "f 1 2 3\nf 1 3 4\n")
+
+    mesh = _meshlib.Mesh()
+    assert mesh.read(str(path))
+    assert capfd.readouterr().err == ""
+    assert mesh.diagnostics.count("isolated_vertex") == 40
+    entry = mesh.diagnostics.entries[0]
+    assert entry.level == _meshlib.LogLevel.Warning
+    assert entry.indices == list(range(4, 4 + len(entry.indices))) and len(entry.indices) < 40
+
+    messages = []
+    _meshlib.set_log_sink(lambda level, message: messages.append((level, message)))
+    _meshlib.set_log_level(_meshlib.LogLevel.Warning)
+    try:
+        mesh.read(str(path))
+        broken = tmp_path / "broken.obj"
+        broken.write_text("v 0 0 0\nv 1 0 0\nf 1 2\nf 1 2 9\n")
+        assert not _meshlib.Mesh().read(str(broken))
+    finally:
+        _meshlib.set_log_level(_meshlib.LogLevel.Off)
+        _meshlib.set_log_sink(None)
+
+    indices = ", ".join(map(str, entry.indices))
+    assert messages[0] == (_meshlib.LogLevel.Warning, "40 isolated_vertex: " + indices + ", ...")
+    assert (_meshlib.LogLevel.Error, "1 degenerate_face: 0") in messages
+    assert (_meshlib.LogLevel.Error, "1 out_of_range_face: 1") in messages
+
+def test_validation_uses_vertex_indices(tmp_path):
+    # two triangles touching at vertex 1 and an unused vertex
+    bowtie = tmp_path / "bowtie.obj"
+    bowtie.write_text("v 0 0 0\nv 1 0 0\nv 0 1 0\nv 2 1 0\nv 2 0 0\nv 9 9 9\nf 1 2 3\nf 2 4 5\n")
+    mesh = _meshlib.Mesh()
+    assert mesh.read(str(bowtie), validate=False) and mesh.diagnostics.empty()
+    result = _meshlib.validate_mesh(mesh)
+    assert result.nonManifoldVertices == [1] and result.isolatedVertices == [5]
+    assert result.nonManifoldEdges == [] and result.boundaryLoops == 2 and not result.isManifold()
+
+    # two triangles that traverse their shared edge in the same direction
+    flipped = tmp_path / "flipped.obj"
+    flipped.write_text("v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nf 1 2 3\nf 2 3 4\n")
+    assert mesh.read(str(flipped))
+    assert len(_meshlib.validate_mesh(mesh).nonManifoldEdges) == 1
+    assert mesh.diagnostics.count("nonmanifold_edge") == 1
+
+    # vertices on texture seams share positions, which does not make them non-manifold
+    assert mesh.read("assets/mesh_obj/HatsuneMiku.obj.obj", 0)
+    results = [_meshlib.validate_mesh(mesh, threads) for threads in [1, 0]]
+    assert results[0].isManifold() and results[1].nonManifoldVertices == results[0].nonManifoldVertices
+    assert results[0].boundaryLoops == len(mesh.boundaries)
+
+def test_minimum_volume_box_is_tighter_than_pca(bunny_mesh):
+    volumes = {}
+    for method in [_meshlib.OrientedBoxMethod.PrincipalComponents,
+                   _meshlib.OrientedBoxMethod.HullPrincipalComponents,
+                   _meshlib.OrientedBoxMethod.MinimumVolume]:
+        bbox = _meshlib.BoundingBox()
+        bbox.computeOrientedBox(bunny_mesh, method=method)
+        assert bbox.type == "Oriented"
+        volumes[method] = bbox.volume()
+
+    assert volumes[_meshlib.OrientedBoxMethod.MinimumVolume] <= volumes[_meshlib.OrientedBoxMethod.PrincipalComponents]
+    assert volumes[_meshlib.OrientedBoxMethod.MinimumVolume] <= volumes[_meshlib.OrientedBoxMethod.HullPrincipalComponents]
+
+def test_convex_hull_prefilter(bunny_mesh):
+    hull = _meshlib.ConvexHull()
+    assert hull.compute(bunny_mesh, threads=2)
+    assert 0 < len(hull.vertexIndices) < len(bunny_mesh.vertices)
+    assert hull.triangles.shape == (hull.faceCount(), 3)
+    # closed triangulated sphere: V - E + F = 2 with E = 3F / 2
+    assert len(hull.vertexIndices) - hull.faceCount() // 2 == 2
+
+    positions = np.array([v.position for v in bunny_mesh.vertices])
+    np.testing.assert_array_equal(hull.vertices, positions[hull.vertexIndices])
+
+    full = _meshlib.BoundingBox()
+    full.computeAxisAlignedBox(bunny_mesh)
+    reduced = _meshlib.BoundingBox()
+    reduced.computeAxisAlignedBox(hull)
+    np.testing.assert_array_equal(full.min, reduced.min)
+    np.testing.assert_array_equal(full.max, reduced.max)
+
+def test_surface_box_encloses_mesh(bunny_mesh):
+    aabb = _meshlib.BoundingBox()
+    aabb.computeAxisAlignedBox(bunny_mesh)
+    for method in [_meshlib.OrientedBoxMethod.SurfacePrincipalComponents,
+                   _meshlib.OrientedBoxMethod.HullSurfacePrincipalComponents]:
+        bbox = _meshlib.BoundingBox()
+        bbox.computeOrientedBox(bunny_mesh, method=method)
+        assert 0 < bbox.volume() <= 1.5 * aabb.volume()
+
+def test_dito_box_is_close_to_pca(bunny_mesh):
+    pca = _meshlib.BoundingBox()
+    pca.computeOrientedBox(bunny_mesh)
+    for method in [_meshlib.OrientedBoxMethod.DiTO14, _meshlib.OrientedBoxMethod.DiTO26]:
+        bbox = _meshlib.BoundingBox()
+        bbox.computeOrientedBox(bunny_mesh, method=method)
+        assert 0 < bbox.volume() <= 1.5 * pca.volume()
+
+def test_obb_tree_intersects_moved_copy(bunny_mesh):
+    tree = _meshlib.OBBTree()
+    assert tree.build(bunny_mesh)
+    assert tree.triangleCount() == len(tree.triangleIndices)
+    assert _meshlib.OBBTree.intersects(tree, tree)
+
+    transform = np.identity(4)
+    transform[0, 3] = 3.0
+    assert not _meshlib.OBBTree.intersects(tree, tree, transform)
+
+def test_bvh_raycast_and_closest_points(bunny_mesh):
+    bvh = _meshlib.BVH()
+    assert bvh.build(bunny_mesh)
+
+    origins = np.array([[0.0, 0.0, 3.0], [0.0, 0.0, 3.0]])
+    directions = np.array([[0.0, 0.0, -1.0], [0.0, 0.0, 1.0]])
+    distances, triangles = bvh.raycast(origins, directions)
+    assert 2.0 <= distances[0] <= 4.0 and triangles[0] >= 0
+    assert np.isinf(distances[1]) and triangles[1] == -1
+
+    vertices = np.array([v.position for v in bunny_mesh.vertices[:100]])
+    points, distances, triangles = bvh.closestPoints(vertices)
+    assert np.allclose(points, vertices, atol=1e-9)
+    assert np.all(distances < 1e-9) and np.all(triangles >= 0)
+
+def test_batched_box_overlaps_match_pairwise_test():
+    rng = np.random.default_rng(0)
+    boxes = []
+    for _ in range(40):
+        axes, _ = np.linalg.qr(rng.normal(size=(3, 3)))
+        boxes.append(_meshlib.OrientedBox(rng.uniform(0, 5, 3), axes, rng.uniform(0.2, 1.0, 3)))
+
+    matrix = _meshlib.overlapMatrix(boxes, boxes)
+    for i, a in enumerate(boxes):
+        for j, b in enumerate(boxes):
+            assert matrix[i, j] == a.overlaps(b)
+
+    expected = [(i, j) for i in range(len(boxes)) for j in range(i + 1, len(boxes)) if matrix[i, j]]
+    assert [tuple(p) for p in _meshlib.sweepAndPrune(boxes)] == expected
+    assert len(_meshlib.overlappingPairs(boxes, boxes)) == int(matrix.sum())
+
+
+@pytest.mark.skipif(not os.path.exists("bin/bounding-box"), reason="bounding-box is not built")
+def test_batch_mode_reports_each_mesh(tmp_path):
+    shutil.copy(obj_file_path, tmp_path / "bunny.obj")
+    (tmp_path / "broken.obj").write_text("f 1 2 3\n")
+
+    run = subprocess.run(["bin/bounding-box", "--batch", "--threads", "2", str(tmp_path)],
+                         capture_output=True, text=True)
+    records = [json.loads(line) for line in run.stdout.splitlines()]
+
+    assert run.returncode == 1
+    assert [os.path.basename(r["path"]) for r in records] == ["broken.obj", "bunny.obj"]
+    assert not records[0]["ok"] and "error" in records[0]
+    assert records[1]["ok"] and records[1]["vertices"] > 0
+    assert np.allclose(np.abs(np.linalg.det(records[1]["obb"]["axes"])), 1.0)
+
+def test_async_api_resolves_futures():
+    async def load_and_fit():
+        loads = [asyncio.wrap_future(_meshlib.read_mesh_async(obj_file_path)) for _ in range(3)]
+        meshes = await asyncio.gather(*loads)
+        boxes = await asyncio.gather(*[asyncio.wrap_future(_meshlib.compute_obb_async(m)) for m in meshes])
+        return meshes, boxes
+
+    meshes, boxes = asyncio.run(load_and_fit())
+    expected = _meshlib.BoundingBox()
+    expected.computeOrientedBox(meshes[0])
+    for bbox in boxes:
+        for p_async, p_expected in zip(bbox.orientedPoints, expected.orientedPoints):
+            np.testing.assert_array_equal(p_async, p_expected)
+
+    streamed = _meshlib.load_and_compute_axis_aligned_box_async(obj_file_path).result()
+    np.testing.assert_allclose(streamed.max, _meshlib.load_and_compute_axis_aligned_box(obj_file_path).max)
+
+    with pytest.raises(RuntimeError):
+        _meshlib.read_mesh_async("assets/missing.obj").result()
+
+def test_parallel_for_raises_on_caller():
+    # the iteration throws in C++ on a pool thread or the caller, the exception reaches Python
+    with pytest.raises(RuntimeError, match="iteration 3 failed"):
+        _meshlib._testing.parallel_for_failing_at(64, 3, threads=4)
+
+    # the pool is still usable after a failed loop
+    assert _meshlib._testing.parallel_for_failing_at(16, 16, threads=4) == 16